@@ -163,6 +163,9 @@ class FileEngine : ParserContext
    EngineResult process(StrLen file_name,StrLen pretext);
 
    EngineResult process(StrLen file_name);
+
+   template <FuncInitArgType<> FuncInit>
+   EngineResult process(StrLen file_name,StrLen pretext,FuncInit parsed); // parsed() is called between parsing and evaluation
  };
 
 template <FileNameType FileName,class FileText,class ... SS>
@@ -297,6 +300,25 @@ EngineResult FileEngine<FileName,FileText,SS...>::process(StrLen file_name)
   return Nothing;
  }
 
+template <FileNameType FileName,class FileText,class ... SS>
+template <FuncInitArgType<> FuncInit>
+EngineResult FileEngine<FileName,FileText,SS...>::process(StrLen file_name,StrLen pretext,FuncInit parsed_init)
+ {
+  if( BodyNode *body_node=parseFile(file_name,pretext) )
+    {
+     FunctorTypeOf<FuncInit> parsed(parsed_init);
+
+     parsed();
+
+     if( EvalContext::Process(error,pool,body_node,result) )
+       {
+        return EngineResult(&result,body_node);
+       }
+    }
+
+  return Nothing;
+ }
+
 } // namespace DDL
 } // namespace CCore
 
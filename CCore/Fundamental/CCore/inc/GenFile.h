@@ -101,6 +101,16 @@ enum FileType : uint32
 
 const char * GetTextDesc(FileType ft);
 
+/* struct FileStatus */
+
+struct FileStatus
+ {
+  FileType type = FileType_none ;
+  CmpFileTimeType time = 0 ;
+  FilePosType len = 0 ;
+  uint64 id = 0 ; // file serial number, 0 if not available
+ };
+
 /* enum FileError */
 
 enum FileError : uint32
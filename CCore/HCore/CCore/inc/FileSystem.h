@@ -42,6 +42,8 @@ class FileSystem : NoCopy
 
    CmpFileTimeType getFileUpdateTime(StrLen path);
 
+   FileStatus getFileStatus(StrLen path);
+
    void createFile(StrLen file_name);
 
    void deleteFile(StrLen file_name);
@@ -52,6 +54,12 @@ class FileSystem : NoCopy
 
    void rename(StrLen old_path,StrLen new_path,bool allow_overwrite);
 
+   void copyFile(StrLen src_file,StrLen dst_file);
+
+   void touchFile(StrLen file_name);
+
+   void linkFile(StrLen src_file,StrLen dst_file,bool sym);
+
    void remove(StrLen path);
 
    void exec(StrLen dir,StrLen program,StrLen arg);
@@ -59,6 +67,8 @@ class FileSystem : NoCopy
    StrLen pathOf(StrLen path,char buf[MaxPathLen+1]);
 
    class DirCursor;
+
+   class DirHandle;
  };
 
 /* class FileSystem::DirCursor */
@@ -91,6 +101,21 @@ class FileSystem::DirCursor : NoCopy
     }
  };
 
+/* class FileSystem::DirHandle */
+
+class FileSystem::DirHandle : NoCopy
+ {
+   Sys::FileSystem::DirHandle handle;
+
+  public:
+
+   DirHandle(FileSystem &fs,StrLen dir_name);
+
+   ~DirHandle();
+
+   FileStatus getFileStatus(StrLen file_name); // file name only
+ };
+
 } // namespace CCore
 
 #endif
@@ -0,0 +1,68 @@
+/* FileWatch.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: HCore
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_FileWatch_h
+#define CCore_inc_FileWatch_h
+
+#include <CCore/inc/Array.h>
+
+#include <CCore/inc/sys/SysFileWatch.h>
+
+namespace CCore {
+
+/* classes */
+
+class FileWatch;
+
+/* class FileWatch */
+
+class FileWatch : NoCopy
+ {
+   Sys::FileWatch sys_watch;
+
+   SimpleArray<char> buf;
+
+  private:
+
+   ulen readBuf();
+
+  public:
+
+   using Event = Sys::FileWatch::Event ;
+
+   FileWatch();
+
+   ~FileWatch();
+
+   int add(StrLen dir_name); // watch descriptor
+
+   template <class Func>
+   void read(Func func) // func(const Event &) for all pending events, non-blocking
+    {
+     while( ulen len=readBuf() )
+       {
+        PtrLen<const char> data=Range_const(buf.getPtr(),len);
+
+        Event event;
+
+        while( Sys::FileWatch::Next(data,event) ) func(event);
+       }
+    }
+ };
+
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,63 @@
+/* JobServer.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: HCore
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_JobServer_h
+#define CCore_inc_JobServer_h
+
+#include <CCore/inc/Array.h>
+
+#include <CCore/inc/sys/SysJobServer.h>
+
+namespace CCore {
+
+/* classes */
+
+class JobServer;
+
+/* class JobServer */
+
+ //
+ // Each process has one implicit job, every other running job holds a token.
+ //
+
+class JobServer : NoCopy
+ {
+   Sys::JobServer sys_job;
+
+   DynArray<char> tokens;
+
+  public:
+
+   static StrLen FindAuth(StrLen makeflags); // the last --jobserver-auth= or --jobserver-fds= , Empty if none
+
+   explicit JobServer(StrLen auth); // client
+
+   explicit JobServer(ulen token_count); // server
+
+   ~JobServer();
+
+   StrLen getAuth() const { return sys_job.getAuth(); }
+
+   ulen getCount() const { return tokens.getLen(); }
+
+   bool take(); // non-blocking
+
+   void give(); // the last taken token
+ };
+
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,85 @@
+/* LocalSocket.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: HCore
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_LocalSocket_h
+#define CCore_inc_LocalSocket_h
+
+#include <CCore/inc/sys/SysLocalSocket.h>
+
+namespace CCore {
+
+/* classes */
+
+class LocalServer;
+
+class LocalClient;
+
+/* class LocalServer */
+
+class LocalServer : NoCopy
+ {
+   Sys::LocalServer sys_server;
+
+  public:
+
+   explicit LocalServer(StrLen path);
+
+   ~LocalServer();
+
+   class Request;
+ };
+
+/* class LocalServer::Request */
+
+class LocalServer::Request : NoCopy
+ {
+   Sys::LocalServer::Request sys_req;
+
+  public:
+
+   explicit Request(LocalServer &server); // blocking
+
+   ~Request();
+
+   StrLen getText() const { return sys_req.getText(); }
+
+   void redirect(); // stdout and stderr go to the client
+
+   void restore();
+
+   void reply(int status);
+ };
+
+/* class LocalClient */
+
+class LocalClient : NoCopy
+ {
+   Sys::LocalClient sys_client;
+
+  public:
+
+   explicit LocalClient(StrLen path);
+
+   ~LocalClient();
+
+   void send(StrLen text); // passes stdout and stderr
+
+   int wait(); // the status of the request
+ };
+
+} // namespace CCore
+
+#endif
+
@@ -32,6 +32,8 @@ class RawFileToRead : NoCopy
  {
    Sys::File file;
 
+   friend class RawFileToPrint;
+
   public:
 
    explicit RawFileToRead(StrLen file_name,FileOpenFlags oflags=Open_Read);
@@ -35,12 +35,20 @@ enum SpawnSlotState
   SpawnSlot_Stopped
  };
 
+/* types */
+
+using SpawnUsage = Sys::SpawnUsage ;
+
 /* classes */
 
 class ShellPath;
 
 class GetEnviron;
 
+class SpawnEnviron;
+
+class SpawnArena;
+
 class SpawnSlot;
 
 class SpawnSet;
@@ -126,6 +134,77 @@ class GetEnviron : NoCopy
     }
  };
 
+/* class SpawnEnviron */
+
+class SpawnEnviron : NoCopy
+ {
+   ElementPool pool;
+
+   struct Rec
+    {
+     char *str;
+     ulen name_len;
+     ulen ind;
+
+     Rec(char *str_,ulen name_len_,ulen ind_) : str(str_),name_len(name_len_),ind(ind_) {}
+
+     StrLen getName() const { return StrLen(str,name_len); }
+
+     bool operator < (const Rec &obj) const
+      {
+       if( CmpResult cmp=StrCmp(getName(),obj.getName()) ) return cmp<0;
+
+       return ind<obj.ind;
+      }
+
+     bool operator == (const Rec &obj) const { return getName().equal(obj.getName()); }
+    };
+
+   DynArray<Rec> list; // sorted by name, unique
+
+   friend class SpawnArena;
+   friend class SpawnProcess;
+
+  public:
+
+   SpawnEnviron(); // snapshot of the current environment
+
+   ~SpawnEnviron();
+
+   ulen getLen() const { return list.getLen(); }
+ };
+
+/* class SpawnArena */
+
+class SpawnArena : NoCopy
+ {
+   struct EnvPos
+    {
+     ulen off;
+     ulen name_len;
+
+     EnvPos(ulen off_,ulen name_len_) : off(off_),name_len(name_len_) {}
+    };
+
+   DynArray<char> buf; // zero-terminated strings
+   DynArray<ulen> args; // offsets in buf
+   DynArray<EnvPos> envs;
+   DynArray<SpawnEnviron::Rec> recs;
+   DynArray<char *> ptrs; // argv, then envp
+
+   friend class SpawnProcess;
+
+  private:
+
+   void reset();
+
+  public:
+
+   SpawnArena();
+
+   ~SpawnArena();
+ };
+
 /* class SpawnSlot */
 
 class SpawnSlot : NoCopy
@@ -134,6 +213,10 @@ class SpawnSlot : NoCopy
 
    SpawnSlotState state = SpawnSlot_Ready ;
 
+   SpawnUsage usage;
+
+   bool capture = false ;
+
    friend class SpawnProcess;
    friend class SpawnSet;
 
@@ -145,6 +228,10 @@ class SpawnSlot : NoCopy
 
    SpawnSlotState getState() const { return state; }
 
+   const SpawnUsage & getUsage() const { return usage; } // after wait()
+
+   void setCapture(bool on) { capture=on; } // capture stdout and stderr, the output is returned by SpawnSet::wait()
+
    int wait();
 
    bool clean()
@@ -171,10 +258,16 @@ class SpawnSet : NoCopy
 
    void add(SpawnSlot *slot);
 
+   void addJob(SpawnSlot *slot); // the slot is running a job, completed by post()
+
+   void post(SpawnSlot *slot,int status) noexcept; // thread-safe
+
    struct WaitResult
     {
      SpawnSlot *slot;
      int status;
+     SpawnUsage usage;
+     PtrLen<const char> output; // valid until the next add() or wait()
     };
 
    WaitResult wait();
@@ -184,55 +277,32 @@ class SpawnSet : NoCopy
 
 class SpawnProcess : NoCopy
  {
-   ElementPool pool;
+   SpawnArena local;
+   SpawnArena &arena;
 
-   char *wdir = 0 ;
-   char *exe_name = 0 ;
+   const SpawnEnviron *base = 0 ;
 
-   DynArray<char *> args;
-
-   struct EnvRec
-    {
-     char *str;
-     ulen name_len;
-     ulen ind;
-
-     EnvRec(char *str_,ulen name_len_,ulen ind_) : str(str_),name_len(name_len_),ind(ind_) {}
-
-     StrLen getName() const { return StrLen(str,name_len); }
-
-     bool operator < (const EnvRec &obj) const
-      {
-       if( CmpResult cmp=StrCmp(getName(),obj.getName()) ) return cmp<0;
-
-       return ind<obj.ind;
-      }
-
-     bool operator == (const EnvRec &obj) const { return getName().equal(obj.getName()); }
-    };
-
-   DynArray<EnvRec> envs;
+   ulen wdir = MaxULen ;
+   ulen exe_name = 0 ;
 
    bool used = false ;
 
   private:
 
    template <class ... TT>
-   char * cat(TT ... tt);
+   ulen cat(TT ... tt);
 
-   char ** alloc(ulen len);
+   char ** buildArgv(char **out);
 
-   char * allocBuf(ulen len);
-
-   char ** buildArgv();
-
-   char ** buildEnvp();
+   char ** buildEnvp(char **out,const SpawnEnviron &base);
 
   public:
 
    explicit SpawnProcess(StrLen exe_name) : SpawnProcess(Empty,exe_name) {}
 
-   SpawnProcess(StrLen wdir,StrLen exe_name);
+   SpawnProcess(StrLen wdir,StrLen exe_name); // the environment is taken on spawn()
+
+   SpawnProcess(StrLen wdir,StrLen exe_name,const SpawnEnviron &base,SpawnArena &arena); // the arena memory is reused
 
    ~SpawnProcess();
 
@@ -240,13 +310,15 @@ class SpawnProcess : NoCopy
 
    void addArg(ulen reserve,FuncArgType<char *> auto func)
     {
-     char *buf=allocBuf(reserve);
+     ulen off=arena.buf.getLen();
+
+     char *buf=arena.buf.extend_raw(LenAdd(reserve,1)).ptr;
 
      func(buf);
 
      buf[reserve]=0;
 
-     args.append_copy(buf);
+     arena.args.append_copy(off);
     }
 
    void addEnv(StrLen name,StrLen value);
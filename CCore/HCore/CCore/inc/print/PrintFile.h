@@ -29,6 +29,8 @@ class RawFileToPrint;
 
 class PrintFile;
 
+class RawFileToRead;
+
 /* class RawFileToPrint */
 
 class RawFileToPrint : NoCopy
@@ -56,6 +58,10 @@ class RawFileToPrint : NoCopy
    void preserveFile() { preserve_file=true; }
 
    FileError write(const uint8 *buf,ulen len);
+
+   FileError reserve(FilePosType len);
+
+   FileError copyFrom(RawFileToRead &src); // from the src position to the end, kernel-side if possible
  };
 
 /* class PrintFile */
@@ -98,6 +104,10 @@ class PrintFile : public PrintBase
    void close();
 
    void preserveFile() { file.preserveFile(); }
+
+   void reserve(FilePosType len); // preallocation hint, errors are ignored
+
+   void copyFrom(RawFileToRead &src); // flushes the buffer, then appends the rest of src
  };
 
 } // namespace CCore
@@ -61,6 +61,18 @@ CmpFileTimeType FileSystem::getFileUpdateTime(StrLen path)
   return result.time;
  }
 
+FileStatus FileSystem::getFileStatus(StrLen path)
+ {
+  auto result=fs.getFileStatus(path);
+
+  if( result.error )
+    {
+     Printf(Exception,"CCore::FileSystem::getFileStatus(#.q;) : #;",path,result.error);
+    }
+
+  return result.status;
+ }
+
 void FileSystem::createFile(StrLen file_name)
  {
   if( FileError fe=fs.createFile(file_name) )
@@ -101,6 +113,30 @@ void FileSystem::rename(StrLen old_path,StrLen new_path,bool allow_overwrite)
     }
  }
 
+void FileSystem::copyFile(StrLen src_file,StrLen dst_file)
+ {
+  if( FileError fe=fs.copyFile(src_file,dst_file) )
+    {
+     Printf(Exception,"CCore::FileSystem::copyFile(#.q;,#.q;) : #;",src_file,dst_file,fe);
+    }
+ }
+
+void FileSystem::touchFile(StrLen file_name)
+ {
+  if( FileError fe=fs.touchFile(file_name) )
+    {
+     Printf(Exception,"CCore::FileSystem::touchFile(#.q;) : #;",file_name,fe);
+    }
+ }
+
+void FileSystem::linkFile(StrLen src_file,StrLen dst_file,bool sym)
+ {
+  if( FileError fe=fs.linkFile(src_file,dst_file,sym) )
+    {
+     Printf(Exception,"CCore::FileSystem::linkFile(#.q;,#.q;,#;) : #;",src_file,dst_file,sym,fe);
+    }
+ }
+
 void FileSystem::remove(StrLen path)
  {
   if( FileError fe=fs.remove(path) )
@@ -175,6 +211,35 @@ FileType FileSystem::DirCursor::getFileType() const
   return FileType_none;
  }
 
+/* class FileSystem::DirHandle */
+
+FileSystem::DirHandle::DirHandle(FileSystem &fs,StrLen dir_name)
+ {
+  handle.init(&fs.fs,dir_name);
+
+  if( handle.error )
+    {
+     Printf(Exception,"CCore::FileSystem::DirHandle::DirHandle(,#.q;) : #;",dir_name,handle.error);
+    }
+ }
+
+FileSystem::DirHandle::~DirHandle()
+ {
+  handle.exit();
+ }
+
+FileStatus FileSystem::DirHandle::getFileStatus(StrLen file_name)
+ {
+  auto result=handle.getFileStatus(file_name);
+
+  if( result.error )
+    {
+     Printf(Exception,"CCore::FileSystem::DirHandle::getFileStatus(#.q;) : #;",file_name,result.error);
+    }
+
+  return result.status;
+ }
+
 } // namespace CCore
 
 
@@ -0,0 +1,65 @@
+/* FileWatch.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: HCore
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/FileWatch.h>
+
+#include <CCore/inc/PrintError.h>
+
+#include <CCore/inc/Exception.h>
+
+namespace CCore {
+
+/* class FileWatch */
+
+ulen FileWatch::readBuf()
+ {
+  auto result=sys_watch.read(Range(buf));
+
+  if( result.error )
+    {
+     Printf(Exception,"CCore::FileWatch::read() : #;",PrintError(result.error));
+    }
+
+  return result.len;
+ }
+
+FileWatch::FileWatch()
+ : buf(Max<ulen>(Sys::FileWatch::MinBufLen,64_KByte))
+ {
+  if( auto error=sys_watch.open() )
+    {
+     Printf(Exception,"CCore::FileWatch::FileWatch() : #;",PrintError(error));
+    }
+ }
+
+FileWatch::~FileWatch()
+ {
+  sys_watch.close();
+ }
+
+int FileWatch::add(StrLen dir_name)
+ {
+  auto result=sys_watch.add(dir_name);
+
+  if( result.error )
+    {
+     Printf(Exception,"CCore::FileWatch::add(#.q;) : #;",dir_name,PrintError(result.error));
+    }
+
+  return result.wd;
+ }
+
+} // namespace CCore
+
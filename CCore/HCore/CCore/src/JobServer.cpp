@@ -0,0 +1,116 @@
+/* JobServer.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: HCore
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/JobServer.h>
+
+#include <CCore/inc/PrintError.h>
+
+#include <CCore/inc/Exception.h>
+
+namespace CCore {
+
+/* class JobServer */
+
+StrLen JobServer::FindAuth(StrLen makeflags)
+ {
+  StrLen ret;
+
+  while( +makeflags )
+    {
+     ulen len=0;
+
+     while( len<makeflags.len && makeflags[len]!=' ' ) len++;
+
+     StrLen word=makeflags.prefix(len);
+
+     makeflags+=Min(len+1,makeflags.len);
+
+     StrLen auth_prefix="--jobserver-auth="_c;
+     StrLen fds_prefix="--jobserver-fds="_c;
+
+     if( word.hasPrefix(auth_prefix) )
+       {
+        ret=word.part(auth_prefix.len);
+       }
+     else if( word.hasPrefix(fds_prefix) )
+       {
+        ret=word.part(fds_prefix.len);
+       }
+    }
+
+  return ret;
+ }
+
+JobServer::JobServer(StrLen auth)
+ {
+  if( auto error=sys_job.openClient(auth) )
+    {
+     Printf(Exception,"CCore::JobServer::JobServer(#.q;) : #;",auth,PrintError(error));
+    }
+ }
+
+JobServer::JobServer(ulen token_count)
+ {
+  if( auto error=sys_job.openServer(token_count) )
+    {
+     Printf(Exception,"CCore::JobServer::JobServer(#;) : #;",token_count,PrintError(error));
+    }
+ }
+
+JobServer::~JobServer()
+ {
+  for(char token : RangeReverse(tokens) ) sys_job.give(token);
+
+  if( auto error=sys_job.close() )
+    {
+     Printf(NoException,"CCore::JobServer::~JobServer() : #;",PrintError(error));
+    }
+ }
+
+bool JobServer::take()
+ {
+  auto result=sys_job.tryTake();
+
+  if( result.error )
+    {
+     Printf(Exception,"CCore::JobServer::take() : #;",PrintError(result.error));
+    }
+
+  if( !result.ok ) return false;
+
+  tokens.append_copy(result.token);
+
+  return true;
+ }
+
+void JobServer::give()
+ {
+  if( !tokens.getLen() )
+    {
+     Printf(Exception,"CCore::JobServer::give() : no token");
+    }
+
+  char token=tokens[tokens.getLen()-1];
+
+  if( auto error=sys_job.give(token) )
+    {
+     Printf(Exception,"CCore::JobServer::give() : #;",PrintError(error));
+    }
+
+  tokens.shrink_one();
+ }
+
+} // namespace CCore
+
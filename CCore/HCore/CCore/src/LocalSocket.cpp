@@ -0,0 +1,113 @@
+/* LocalSocket.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: HCore
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/LocalSocket.h>
+
+#include <CCore/inc/PrintError.h>
+
+#include <CCore/inc/Exception.h>
+
+namespace CCore {
+
+/* class LocalServer */
+
+LocalServer::LocalServer(StrLen path)
+ {
+  if( auto error=sys_server.open(path) )
+    {
+     Printf(Exception,"CCore::LocalServer::LocalServer(#.q;) : #;",path,PrintError(error));
+    }
+ }
+
+LocalServer::~LocalServer()
+ {
+  sys_server.close();
+ }
+
+/* class LocalServer::Request */
+
+LocalServer::Request::Request(LocalServer &server)
+ {
+  if( auto error=sys_req.accept(&server.sys_server) )
+    {
+     sys_req.close();
+
+     Printf(Exception,"CCore::LocalServer::Request::Request(...) : #;",PrintError(error));
+    }
+ }
+
+LocalServer::Request::~Request()
+ {
+  sys_req.close();
+ }
+
+void LocalServer::Request::redirect()
+ {
+  if( auto error=sys_req.redirect() )
+    {
+     Printf(Exception,"CCore::LocalServer::Request::redirect() : #;",PrintError(error));
+    }
+ }
+
+void LocalServer::Request::restore()
+ {
+  sys_req.restore();
+ }
+
+void LocalServer::Request::reply(int status)
+ {
+  if( auto error=sys_req.reply(status) )
+    {
+     Printf(Exception,"CCore::LocalServer::Request::reply(#;) : #;",status,PrintError(error));
+    }
+ }
+
+/* class LocalClient */
+
+LocalClient::LocalClient(StrLen path)
+ {
+  if( auto error=sys_client.open(path) )
+    {
+     Printf(Exception,"CCore::LocalClient::LocalClient(#.q;) : #;",path,PrintError(error));
+    }
+ }
+
+LocalClient::~LocalClient()
+ {
+  sys_client.close();
+ }
+
+void LocalClient::send(StrLen text)
+ {
+  if( auto error=sys_client.send(text) )
+    {
+     Printf(Exception,"CCore::LocalClient::send(...) : #;",PrintError(error));
+    }
+ }
+
+int LocalClient::wait()
+ {
+  auto result=sys_client.wait();
+
+  if( result.error )
+    {
+     Printf(Exception,"CCore::LocalClient::wait() : #;",PrintError(result.error));
+    }
+
+  return result.status;
+ }
+
+} // namespace CCore
+
@@ -16,7 +16,9 @@
 #include <CCore/inc/SpawnProcess.h>
 
 #include <CCore/inc/ScanRange.h>
-#include <CCore/inc/algon/SortUnique.h>
+#include <CCore/inc/algon/UniqueToFront.h>
+#include <CCore/inc/Sort.h>
+#include <CCore/inc/OptMember.h>
 #include <CCore/inc/PrintError.h>
 
 #include <CCore/inc/Exception.h>
@@ -46,6 +48,59 @@ GetEnviron::~GetEnviron()
     }
  }
 
+/* class SpawnEnviron */
+
+SpawnEnviron::SpawnEnviron()
+ : pool(16_KByte),
+   list(DoReserve,100)
+ {
+  {
+   GetEnviron temp;
+
+   temp( [&] (StrLen env)
+             {
+              ScanStr scan(env,'=');
+
+              if( +scan.next )
+                {
+                 char *str=const_cast<char *>(pool.cat(env,"\0"_c).ptr);
+
+                 list.append_fill(str,scan.before.len,list.getLen());
+                }
+
+             } );
+  }
+
+  Sort(Range(list));
+
+  auto tail=Algon::CopyUniqueToFront(Range(list));
+
+  list.shrink(tail.len);
+ }
+
+SpawnEnviron::~SpawnEnviron()
+ {
+ }
+
+/* class SpawnArena */
+
+void SpawnArena::reset()
+ {
+  buf.shrink_all();
+  args.shrink_all();
+  envs.shrink_all();
+  recs.shrink_all();
+  ptrs.shrink_all();
+ }
+
+SpawnArena::SpawnArena()
+ {
+ }
+
+SpawnArena::~SpawnArena()
+ {
+ }
+
 /* class SpawnSlot */
 
 SpawnSlot::SpawnSlot() noexcept
@@ -71,6 +126,8 @@ int SpawnSlot::wait()
 
   auto result=sys_spawn.wait();
 
+  usage=result.usage;
+
   if( result.error )
     {
      Printf(Exception,"CCore::SpawnSlot::wait() : #; status = #;",PrintError(result.error),result.status);
@@ -110,6 +167,29 @@ void SpawnSet::add(SpawnSlot *slot)
     }
  }
 
+void SpawnSet::addJob(SpawnSlot *slot)
+ {
+  if( slot->state!=SpawnSlot_Ready )
+    {
+     Printf(Exception,"CCore::SpawnSet::addJob(...) : slot is not ready");
+    }
+
+  if( auto error=list.addJob() )
+    {
+     Printf(Exception,"CCore::SpawnSet::addJob(...) : #;",PrintError(error));
+    }
+
+  slot->state=SpawnSlot_Running;
+ }
+
+void SpawnSet::post(SpawnSlot *slot,int status) noexcept
+ {
+  if( auto error=list.post(slot,status) )
+    {
+     Printf(NoException,"CCore::SpawnSet::post(...) : #;",PrintError(error));
+    }
+ }
+
 auto SpawnSet::wait() -> WaitResult
  {
   auto result=list.wait();
@@ -123,68 +203,97 @@ auto SpawnSet::wait() -> WaitResult
      Printf(Exception,"CCore::SpawnSet::wait() : #; status = #;",PrintError(result.error),result.status);
     }
 
-  return {slot,result.status};
+  return {slot,result.status,result.usage,result.output};
  }
 
 /* class SpawnProcess */
 
 template <class ... TT>
-char * SpawnProcess::cat(TT ... tt)
+ulen SpawnProcess::cat(TT ... tt)
  {
-  StrLen str=pool.cat(tt...,"\0"_c);
+  ulen off=arena.buf.getLen();
 
-  return const_cast<char *>(str.ptr);
- }
+  ( arena.buf.extend_copy(Range(tt)) , ... );
 
-char ** SpawnProcess::alloc(ulen len)
- {
-  return pool.createArray_raw<char *>(LenAdd(len,1)).ptr;
- }
+  arena.buf.append_copy(0);
 
-char * SpawnProcess::allocBuf(ulen len)
- {
-  return pool.createArray_raw<char>(LenAdd(len,1)).ptr;
+  return off;
  }
 
-char ** SpawnProcess::buildArgv()
+char ** SpawnProcess::buildArgv(char **out)
  {
-  char **ret=alloc(args.getLen());
+  char *buf=arena.buf.getPtr();
 
-  auto out=ret;
-
-  for(char *arg : args ) *(out++)=arg;
+  for(ulen off : arena.args ) *(out++)=buf+off;
 
   *(out++)=0;
 
-  return ret;
+  return out;
  }
 
-char ** SpawnProcess::buildEnvp()
+char ** SpawnProcess::buildEnvp(char **out,const SpawnEnviron &base)
  {
-  {
-   GetEnviron temp;
+  char *buf=arena.buf.getPtr();
 
-   temp( [&] (StrLen env) { addEnv(env); } );
-  }
+  for(SpawnArena::EnvPos pos : arena.envs ) arena.recs.append_fill(buf+pos.off,pos.name_len,arena.recs.getLen());
 
-  auto list=Range(envs);
+  // overrides are few, the base is sorted, the first override of the name is taken
 
-  char **ret=alloc(list.len);
+  auto list=Range(arena.recs);
 
-  auto out=ret;
+  Sort(list);
 
-  Algon::SortThenApplyUnique(list, [&] (EnvRec &env) { *(out++)=env.str; } );
+  auto cur=Range(base.list);
+
+  while( +list )
+    {
+     if( +cur )
+       {
+        if( CmpResult cmp=StrCmp(cur->getName(),list->getName()) )
+          {
+           if( cmp<0 )
+             {
+              *(out++)=cur->str;
+
+              ++cur;
+
+              continue;
+             }
+          }
+        else
+          {
+           ++cur;
+          }
+       }
+
+     *(out++)=list->str;
+
+     StrLen name=list->getName();
+
+     for(++list; +list && list->getName().equal(name) ;++list);
+    }
+
+  for(; +cur ;++cur) *(out++)=cur->str;
 
   *(out++)=0;
 
-  return ret;
+  return out;
  }
 
 SpawnProcess::SpawnProcess(StrLen wdir_,StrLen exe_name_)
- : pool(4_KByte),
-   args(DoReserve,100),
-   envs(DoReserve,100)
+ : arena(local)
+ {
+  if( +wdir_ ) wdir=cat(wdir_);
+
+  exe_name=cat(exe_name_);
+ }
+
+SpawnProcess::SpawnProcess(StrLen wdir_,StrLen exe_name_,const SpawnEnviron &base_,SpawnArena &arena_)
+ : arena(arena_),
+   base(&base_)
  {
+  arena.reset();
+
   if( +wdir_ ) wdir=cat(wdir_);
 
   exe_name=cat(exe_name_);
@@ -196,27 +305,19 @@ SpawnProcess::~SpawnProcess()
 
 void SpawnProcess::addArg(StrLen str)
  {
-  args.append_copy(cat(str));
+  arena.args.append_copy(cat(str));
  }
 
 void SpawnProcess::addEnv(StrLen name,StrLen value)
  {
-  ulen ind=envs.getLen();
-
-  envs.append_fill(cat(name,"="_c,value),name.len,ind);
+  arena.envs.append_fill(cat(name,"="_c,value),name.len);
  }
 
 void SpawnProcess::addEnv(StrLen str)
  {
   ScanStr scan(str,'=');
 
-  if( +scan.next )
-    {
-     ulen name_len=scan.before.len;
-     ulen ind=envs.getLen();
-
-     envs.append_fill(cat(str),name_len,ind);
-    }
+  if( +scan.next ) arena.envs.append_fill(cat(str),scan.before.len);
  }
 
 void SpawnProcess::spawn(SpawnSlot &slot)
@@ -235,11 +336,26 @@ void SpawnProcess::spawn(SpawnSlot &slot)
 
   slot.state=SpawnSlot_Broken;
 
-  char **argv=buildArgv();
+  OptMember<SpawnEnviron> temp;
+
+  if( !base )
+    {
+     temp.create();
+
+     base=temp.getPtr();
+    }
+
+  arena.recs.reserve(arena.envs.getLen());
+
+  char **argv=arena.ptrs.extend_raw(LenAdd(arena.args.getLen(),arena.envs.getLen(),base->getLen(),2)).ptr;
+
+  char **envp=buildArgv(argv);
+
+  buildEnvp(envp,*base);
 
-  char **envp=buildEnvp();
+  char *buf=arena.buf.getPtr();
 
-  if( auto error=slot.sys_spawn.spawn(wdir,exe_name,argv,envp) )
+  if( auto error=slot.sys_spawn.spawn( (wdir!=MaxULen)?buf+wdir:0 ,buf+exe_name,argv,envp,slot.capture) )
     {
      Printf(Exception,"CCore::SpawnProcess::spawn() : #;",PrintError(error));
     }
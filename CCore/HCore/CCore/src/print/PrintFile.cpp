@@ -15,6 +15,7 @@
 
 #include <CCore/inc/print/PrintFile.h>
 
+#include <CCore/inc/RawFileToRead.h>
 #include <CCore/inc/Exception.h>
 
 namespace CCore {
@@ -60,6 +61,20 @@ FileError RawFileToPrint::write(const uint8 *buf,ulen len)
   return FileError_Ok;
  }
 
+FileError RawFileToPrint::reserve(FilePosType len)
+ {
+  if( !opened ) return FileError_NoMethod;
+
+  return file.reserve(len);
+ }
+
+FileError RawFileToPrint::copyFrom(RawFileToRead &src)
+ {
+  if( !opened ) return FileError_NoMethod;
+
+  return file.copyFrom(src.file).error;
+ }
+
 /* class PrintFile */
 
 PtrLen<char> PrintFile::do_provide(ulen)
@@ -163,6 +178,23 @@ void PrintFile::close()
     }
  }
 
+void PrintFile::reserve(FilePosType len)
+ {
+  flush();
+
+  (void)file.reserve(len);
+ }
+
+void PrintFile::copyFrom(RawFileToRead &src)
+ {
+  flush();
+
+  if( FileError error=file.copyFrom(src) )
+    {
+     Printf(Exception,"CCore::PrintFile::copyFrom(...) : #;",error);
+    }
+ }
+
 } // namespace CCore
 
 
@@ -33,7 +33,14 @@ inline CmpResult operator - (CmpResult cmp) { return CmpResult(-int(cmp)); }
 
 const char * GetTextDesc(CmpResult cmp);
 
-inline CmpResult CmpResultOf(std::strong_ordering cmp) { return CmpResult(int(cmp)); } // HACK required, see Hack.txt
+inline CmpResult CmpResultOf(std::strong_ordering cmp)
+ {
+  if( cmp<0 ) return CmpLess;
+
+  if( cmp>0 ) return CmpGreater;
+
+  return CmpEqual;
+ }
 
 inline CmpResult CmpResultOf(CmpResult cmp) { return cmp; }
 
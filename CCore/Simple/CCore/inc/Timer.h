@@ -80,6 +80,8 @@ using SecTimer = Timer<Sys::SecTimeType,Sys::GetSecTime> ;
 
 using ClockTimer = Timer<Sys::ClockTimeType,Sys::GetClockTime> ;
 
+using USecTimer = Timer<Sys::USecTimeType,Sys::GetUSecTime> ;
+
 using MSecDiffTimer = DiffTimer<Sys::MSecTimeType,Sys::GetMSecTime> ;
 
 using SecDiffTimer = DiffTimer<Sys::SecTimeType,Sys::GetSecTime> ;
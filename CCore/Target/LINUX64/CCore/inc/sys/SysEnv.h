@@ -0,0 +1,68 @@
+/* SysEnv.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysEnv_h
+#define CCore_inc_sys_SysEnv_h
+
+#include <CCore/inc/sys/SysError.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct CopyEnv;
+
+template <ulen NameLen,ulen ValueLen> struct TryGetEnv;
+
+/* struct CopyEnv */
+
+struct CopyEnv
+ {
+  ulen len;
+  ErrorType error;
+
+  CopyEnv(const char *name,PtrLen<char> buf) noexcept;
+ };
+
+/* struct TryGetEnv<ulen NameLen,ulen ValueLen> */
+
+template <ulen NameLen,ulen ValueLen>
+struct TryGetEnv
+ {
+  StrLen str;
+  bool ok;
+
+  TryGetEnv(PtrLen<char> buf,const char *name)
+   {
+    CopyEnv data(name,buf.prefix(Min(buf.len,ValueLen)));
+
+    if( data.error )
+      {
+       ok=false;
+      }
+    else
+      {
+       str=buf.prefix(data.len);
+       ok=true;
+      }
+   }
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,228 @@
+/* SysFile.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysFile_h
+#define CCore_inc_sys_SysFile_h
+
+#include <CCore/inc/sys/SysTypes.h>
+
+#include <CCore/inc/TimeScope.h>
+#include <CCore/inc/GenFile.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct File;
+
+struct AltFile;
+
+/* struct File */
+
+struct File
+ {
+  // public
+
+  struct IOResult
+   {
+    ulen len;
+    FileError error;
+   };
+
+  struct PosResult
+   {
+    FilePosType pos;
+    FileError error;
+   };
+
+  // private data
+
+  using Type = handle_t ;
+
+  Type handle;
+  FileOpenFlags oflags;
+  char *file_name; // for Open_AutoDelete
+
+  // private
+
+  struct OpenType
+   {
+    Type handle;
+    char *file_name;
+    FileError error;
+   };
+
+  static OpenType Open(StrLen file_name,FileOpenFlags oflags) noexcept;
+
+  static void Close(FileMultiError &errout,Type handle,FileOpenFlags oflags,char *file_name,bool preserve_file) noexcept;
+
+  static IOResult Write(Type handle,FileOpenFlags oflags,const uint8 *buf,ulen len) noexcept;
+
+  static IOResult Read(Type handle,FileOpenFlags oflags,uint8 *buf,ulen len) noexcept;
+
+  static PosResult GetLen(Type handle,FileOpenFlags oflags) noexcept;
+
+  static PosResult GetPos(Type handle,FileOpenFlags oflags) noexcept;
+
+  static FileError SetPos(Type handle,FileOpenFlags oflags,FilePosType pos) noexcept;
+
+  static FileError Reserve(Type handle,FileOpenFlags oflags,FilePosType len) noexcept;
+
+  static PosResult CopyFrom(Type handle,FileOpenFlags oflags,Type src_handle,FileOpenFlags src_oflags) noexcept;
+
+  // public
+
+  FileError open(StrLen file_name_,FileOpenFlags oflags_)
+   {
+    OpenType result=Open(file_name_,oflags_);
+
+    handle=result.handle;
+    oflags=oflags_;
+    file_name=result.file_name;
+
+    return result.error;
+   }
+
+  void close(FileMultiError &errout,bool preserve_file=false)
+   {
+    Close(errout,handle,oflags,file_name,preserve_file);
+   }
+
+  void close()
+   {
+    FileMultiError errout;
+
+    close(errout);
+   }
+
+  IOResult write(const uint8 *buf,ulen len) { return Write(handle,oflags,buf,len); }
+
+  IOResult read(uint8 *buf,ulen len) { return Read(handle,oflags,buf,len); }
+
+  PosResult getLen() { return GetLen(handle,oflags); }
+
+  PosResult getPos() { return GetPos(handle,oflags); }
+
+  FileError setPos(FilePosType pos) { return SetPos(handle,oflags,pos); }
+
+  FileError reserve(FilePosType len) { return Reserve(handle,oflags,len); } // space for len bytes from the current position, the file length is not changed
+
+  PosResult copyFrom(File &src) { return CopyFrom(handle,oflags,src.handle,src.oflags); } // appends src from its position to the end, returns the length
+ };
+
+/* struct AltFile */
+
+struct AltFile
+ {
+  // public
+
+  struct Result
+   {
+    FilePosType file_len;
+    FileError error;
+   };
+
+  // private data
+
+  using Type = handle_t ;
+
+  Type handle;
+  FilePosType file_len;
+  FileOpenFlags oflags;
+  char *file_name; // for Open_AutoDelete
+
+  // private
+
+  struct OpenType
+   {
+    Type handle;
+    FilePosType file_len;
+    char *file_name;
+    FileError error;
+   };
+
+  static OpenType Open(StrLen file_name,FileOpenFlags oflags) noexcept;
+
+  static void Close(FileMultiError &errout,Type handle,FileOpenFlags oflags,char *file_name,bool preserve_file) noexcept;
+
+  static FileError Write(Type handle,FileOpenFlags oflags,FilePosType off,const uint8 *buf,ulen len) noexcept;
+
+  static FileError Read(Type handle,FileOpenFlags oflags,FilePosType off,uint8 *buf,ulen len) noexcept;
+
+  // public
+
+  Result open(StrLen file_name_,FileOpenFlags oflags_)
+   {
+    OpenType result=Open(file_name_,oflags_);
+
+    handle=result.handle;
+    file_len=result.file_len;
+    oflags=oflags_;
+    file_name=result.file_name;
+
+    Result ret;
+
+    ret.file_len=result.file_len;
+    ret.error=result.error;
+
+    return ret;
+   }
+
+  void close(FileMultiError &errout,bool preserve_file=false)
+   {
+    Close(errout,handle,oflags,file_name,preserve_file);
+   }
+
+  void close()
+   {
+    FileMultiError errout;
+
+    close(errout);
+   }
+
+  Result write(FilePosType off,const uint8 *buf,ulen len)
+   {
+    FileError fe=Write(handle,oflags,off,buf,len);
+
+    Result ret;
+
+    ret.error=fe;
+
+    if( fe )
+      {
+       ret.file_len=0;
+      }
+    else
+      {
+       Replace_max(file_len,off+len);
+
+       ret.file_len=file_len;
+      }
+
+    return ret;
+   }
+
+  FileError read(FilePosType off,uint8 *buf,ulen len)
+   {
+    return Read(handle,oflags,off,buf,len);
+   }
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,133 @@
+/* SysFileInternal.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysTypes.h>
+#include <CCore/inc/sys/SysError.h>
+
+#include <CCore/inc/GenFile.h>
+#include <CCore/inc/MemBase.h>
+
+#include <errno.h>
+#include <sys/stat.h>
+
+namespace CCore {
+namespace Sys {
+
+/* functions */
+
+inline FileError MakeError(FileError fe,int error)
+ {
+  switch( error )
+    {
+     case ENOENT       : return FileError_NoFile;
+     case ENOTDIR      : return FileError_NoPath;
+     case EMFILE       : return FileError_SysOverload;
+     case ENFILE       : return FileError_SysOverload;
+     case EACCES       : return FileError_NoAccess;
+     case EPERM        : return FileError_NoAccess;
+     case ENOMEM       : return FileError_SysOverload;
+     case ENODEV       : return FileError_NoDevice;
+     case ENXIO        : return FileError_NoDevice;
+     case EROFS        : return FileError_WriteProtect;
+     case ESPIPE       : return FileError_PosFault;
+     case EIO          : return fe;
+     case EEXIST       : return FileError_FileExist;
+     case ENOSPC       : return FileError_DiskFull;
+     case EDQUOT       : return FileError_DiskFull;
+     case EBADF        : return FileError_BadId;
+     case ENAMETOOLONG : return FileError_TooLongPath;
+     case EINVAL       : return FileError_BadName;
+     case ENOTEMPTY    : return FileError_DirIsNotEmpty;
+     case EISDIR       : return FileError_NoMethod;
+
+     default: return fe;
+    }
+ }
+
+inline FileError MakeError(FileError fe)
+ {
+  return MakeError(fe,errno);
+ }
+
+inline FileError MakeErrorIf(FileError fe,bool nok)
+ {
+  if( nok ) return MakeError(fe);
+
+  return FileError_Ok;
+ }
+
+inline void AddErrorIf(FileMultiError &errout,FileError fe,bool nok)
+ {
+  if( nok ) errout.add(MakeError(fe));
+ }
+
+inline CmpFileTimeType ToCmpFileTime(const struct timespec &ts)
+ {
+  CmpFileTimeType ret=CmpFileTimeType(ts.tv_sec)*1'000'000'000u+CmpFileTimeType(ts.tv_nsec);
+
+  if( !ret ) ret=1;
+
+  return ret;
+ }
+
+inline FileType ToFileType(mode_t mode)
+ {
+  if( S_ISDIR(mode) ) return FileType_dir;
+
+  return FileType_file;
+ }
+
+/* classes */
+
+struct FileName;
+
+/* struct FileName */
+
+struct FileName : NoCopy
+ {
+  char buf[MaxPathLen+1];
+  ulen len; // without zero
+
+  operator const char * () const { return buf; }
+
+  FileError prepare(StrLen str)
+   {
+    if( str.len>MaxPathLen ) return FileError_TooLongPath;
+
+    str.copyTo(buf);
+
+    len=str.len;
+    buf[len]=0;
+
+    return FileError_Ok;
+   }
+
+  FileError prepare(StrLen str1,StrLen str2)
+   {
+    if( str1.len>MaxPathLen || str2.len>MaxPathLen-str1.len ) return FileError_TooLongPath;
+
+    str1.copyTo(buf);
+    str2.copyTo(buf+str1.len);
+
+    len=str1.len+str2.len;
+    buf[len]=0;
+
+    return FileError_Ok;
+   }
+ };
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,141 @@
+/* SysFileSystem.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysFileSystem_h
+#define CCore_inc_sys_SysFileSystem_h
+
+#include <CCore/inc/sys/SysTypes.h>
+
+#include <CCore/inc/GenFile.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct FileSystem;
+
+/* struct FileSystem */
+
+struct FileSystem
+ {
+  // public
+
+  struct TypeResult
+   {
+    FileType type;
+    FileError error;
+   };
+
+  struct CmpTimeResult
+   {
+    CmpFileTimeType time;
+    FileError error;
+   };
+
+  struct StatusResult
+   {
+    FileStatus status;
+    FileError error;
+   };
+
+  struct PathOfResult
+   {
+    StrLen path;
+    FileError error;
+   };
+
+  struct DirCursor
+   {
+    // private data
+
+    using Type = void * ; // DIR *
+
+    Type handle;
+    bool is_closed;
+
+    // public
+
+    char file_name[MaxPathLen]; // file name only
+    ulen len;
+    FileType type;
+    FileError error;
+
+    void init(FileSystem *fs,StrLen dir_name) noexcept;
+
+    void exit() noexcept;
+
+    bool next() noexcept;
+   };
+
+  struct DirHandle
+   {
+    // private data
+
+    int fd;
+    bool is_closed;
+
+    // public
+
+    FileError error;
+
+    void init(FileSystem *fs,StrLen dir_name) noexcept; // not existing dir is not an error
+
+    void exit() noexcept;
+
+    StatusResult getFileStatus(StrLen file_name) noexcept; // file name only
+   };
+
+  // public
+
+  static FileError init() noexcept;
+
+  static FileError exit() noexcept;
+
+  static TypeResult getFileType(StrLen path) noexcept;
+
+  static CmpTimeResult getFileUpdateTime(StrLen path) noexcept;
+
+  static StatusResult getFileStatus(StrLen path) noexcept;
+
+  static FileError createFile(StrLen file_name) noexcept;
+
+  static FileError deleteFile(StrLen file_name) noexcept;
+
+  static FileError createDir(StrLen dir_name) noexcept;
+
+  static FileError deleteDir(StrLen dir_name,bool recursive) noexcept;
+
+  static FileError rename(StrLen old_path,StrLen new_path,bool allow_overwrite) noexcept;
+
+  static FileError copyFile(StrLen src_file,StrLen dst_file) noexcept; // dst_file is overwritten
+
+  static FileError touchFile(StrLen file_name) noexcept; // created, if does not exist
+
+  static FileError linkFile(StrLen src_file,StrLen dst_file,bool sym) noexcept; // dst_file is replaced
+
+  static FileError remove(StrLen path) noexcept;
+
+  static FileError exec(StrLen dir,StrLen program,StrLen arg) noexcept;
+
+  static PathOfResult pathOf(StrLen path,char buf[MaxPathLen+1]) noexcept;
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
+
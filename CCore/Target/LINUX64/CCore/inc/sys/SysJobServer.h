@@ -0,0 +1,79 @@
+/* SysJobServer.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysJobServer_h
+#define CCore_inc_sys_SysJobServer_h
+
+#include <CCore/inc/GenFile.h>
+
+#include <CCore/inc/sys/SysError.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct JobServer;
+
+/* struct JobServer */
+
+ //
+ // GNU make jobserver : one byte in the fifo or pipe is one job token
+ //
+ // The server uses the pipe form, it is understood by all GNU make versions.
+ //
+
+struct JobServer
+ {
+  // public
+
+  static constexpr ulen MaxAuthLen = MaxPathLen+16 ;
+
+  struct TakeResult
+   {
+    char token;
+    bool ok;
+    ErrorType error;
+   };
+
+  // private data
+
+  int read_fd; // private non-blocking descriptor
+  int write_fd;
+  int pipe_fd; // server : the read end of the pipe, -1 for client
+
+  char auth[MaxAuthLen+1];
+  ulen auth_len;
+
+  // public
+
+  ErrorType openClient(StrLen auth) noexcept; // "fifo:<path>" or "<read fd>,<write fd>"
+
+  ErrorType openServer(ulen token_count) noexcept;
+
+  ErrorType close() noexcept;
+
+  StrLen getAuth() const noexcept { return StrLen(auth,auth_len); }
+
+  TakeResult tryTake() noexcept; // non-blocking
+
+  ErrorType give(char token) noexcept;
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,113 @@
+/* SysLocalSocket.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysLocalSocket_h
+#define CCore_inc_sys_SysLocalSocket_h
+
+#include <CCore/inc/GenFile.h>
+
+#include <CCore/inc/sys/SysError.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct LocalServer;
+
+struct LocalClient;
+
+/* struct LocalServer */
+
+ //
+ // Unix domain socket server. A client sends a short text request together with its stdout and stderr,
+ // the server runs the request with the redirected output and replies with the int status.
+ //
+
+struct LocalServer
+ {
+  // public
+
+  static constexpr ulen MaxTextLen = 4_KByte ;
+
+  struct Request
+   {
+    // private data
+
+    int fd;
+    int out_fd[2]; // client stdout, stderr
+    int save_fd[2];
+
+    // public
+
+    char text[MaxTextLen];
+    ulen len;
+
+    ErrorType accept(LocalServer *server) noexcept; // blocking
+
+    ErrorType redirect() noexcept; // stdout and stderr go to the client
+
+    void restore() noexcept;
+
+    ErrorType reply(int status) noexcept;
+
+    void close() noexcept;
+
+    StrLen getText() const { return StrLen(text,len); }
+   };
+
+  // private data
+
+  int fd;
+
+  // public
+
+  ErrorType open(StrLen path) noexcept; // the existing socket file is replaced
+
+  void close() noexcept;
+ };
+
+/* struct LocalClient */
+
+struct LocalClient
+ {
+  // public
+
+  struct WaitResult
+   {
+    int status;
+    ErrorType error;
+   };
+
+  // private data
+
+  int fd;
+
+  // public
+
+  ErrorType open(StrLen path) noexcept;
+
+  void close() noexcept;
+
+  ErrorType send(StrLen text) noexcept; // passes stdout and stderr
+
+  WaitResult wait() noexcept;
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,33 @@
+/* SysPlanInit.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysPlanInit_h
+#define CCore_inc_sys_SysPlanInit_h
+
+#include <CCore/inc/PlanInit.h>
+
+namespace CCore {
+namespace Sys {
+
+/* GetPlanInitNode_...() */
+
+PlanInitNode * GetPlanInitNode_Sys();
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
+
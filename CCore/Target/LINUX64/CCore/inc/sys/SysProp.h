@@ -0,0 +1,50 @@
+/* SysProp.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysProp_h
+#define CCore_inc_sys_SysProp_h
+
+#include <CCore/inc/PlanInit.h>
+
+namespace CCore {
+namespace Sys {
+
+/* GetPlanInitNode_...() */
+
+PlanInitNode * GetPlanInitNode_SysProp();
+
+/* struct SysLoad */
+
+struct SysLoad
+ {
+  unsigned load = 0 ; // 1 minute load average * 100 , 0 if not available
+  uint64 avail_mem = 0 ; // bytes
+  bool ok = false ;
+ };
+
+/* functions */
+
+unsigned GetCpuCount() noexcept;
+
+unsigned GetSpinCount() noexcept;
+
+SysLoad GetSysLoad() noexcept;
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
+
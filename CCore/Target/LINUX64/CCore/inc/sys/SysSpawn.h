@@ -0,0 +1,147 @@
+/* SysSpawn.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysSpawn_h
+#define CCore_inc_sys_SysSpawn_h
+
+#include <CCore/inc/GenFile.h>
+
+#include <CCore/inc/sys/SysTypes.h>
+#include <CCore/inc/sys/SysError.h>
+
+namespace CCore {
+namespace Sys {
+
+/* GetShell() */
+
+StrLen GetShell(char buf[MaxPathLen+1]) noexcept;
+
+/* classes */
+
+struct GetEnviron;
+
+struct SpawnUsage;
+
+struct SpawnChild;
+
+struct SpawnWaitList;
+
+/* struct GetEnviron */
+
+struct GetEnviron
+ {
+  // public
+
+  struct NextResult
+   {
+    StrLen env;
+    ErrorType error;
+    bool eof;
+   };
+
+  // private data
+
+  char **ptr;
+
+  // public
+
+  ErrorType init() noexcept;
+
+  ErrorType exit() noexcept;
+
+  NextResult next() noexcept;
+ };
+
+/* struct SpawnUsage */
+
+struct SpawnUsage
+ {
+  uint64 user_time = 0 ; // usec
+  uint64 sys_time = 0 ; // usec
+  uint64 max_rss = 0 ; // KByte
+  uint64 read_bytes = 0 ;
+  uint64 write_bytes = 0 ;
+ };
+
+/* struct SpawnChild */
+
+struct SpawnChild
+ {
+  // public
+
+  struct WaitResult
+   {
+    int status;
+    ErrorType error;
+    SpawnUsage usage;
+   };
+
+  // private data
+
+  using Type = pid_t ;
+
+  Type handle;
+  int output; // the read end of the output pipe, -1 if the output is not captured
+
+  // public
+
+  ErrorType spawn(char *wdir,char *path,char **argv,char **envp,bool capture=false) noexcept; // path!=0 , argv!=0 , envp!=0
+
+  // capture : stdout and stderr of the child go to one pipe, it is drained by SpawnWaitList
+
+  WaitResult wait() noexcept;
+ };
+
+/* struct SpawnWaitList */
+
+struct SpawnWaitList
+ {
+  // public
+
+  struct WaitResult
+   {
+    void *arg;
+    int status;
+    ErrorType error;
+    SpawnUsage usage;
+    PtrLen<const char> output; // captured output, valid until the next add() or wait()
+   };
+
+  // private data
+
+  class Engine;
+
+  Engine *engine;
+
+  // public
+
+  ErrorType init(ulen reserve) noexcept;
+
+  ErrorType exit() noexcept;
+
+  ErrorType add(SpawnChild *spawn,void *arg) noexcept; // makes spawn reusable
+
+  ErrorType addJob() noexcept; // a job, completed by post()
+
+  ErrorType post(void *arg,int status) noexcept; // thread-safe, completes a job
+
+  WaitResult wait() noexcept;
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
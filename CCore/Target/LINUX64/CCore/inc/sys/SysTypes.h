@@ -0,0 +1,44 @@
+/* SysTypes.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysTypes_h
+#define CCore_inc_sys_SysTypes_h
+
+#include <CCore/inc/base/PlatformBase.h>
+
+namespace CCore {
+namespace Sys {
+
+/* types */
+
+using unicode_t = unsigned int ;
+
+using handle_t = int ; // file descriptor
+
+using index_t = unsigned ;
+
+using flags_t = unsigned ;
+
+using pid_t = int ;
+
+/* consts */
+
+inline constexpr handle_t InvalidHandle = -1 ;
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,29 @@
+/* PlatformBase.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/base/PlatformBase.h>
+
+namespace CCore {
+
+/* functions */
+
+void OptimizeBarrier(void *ptr,ulen) noexcept
+ {
+  asm volatile ( "" : : "r" (ptr) : "memory" );
+ }
+
+} // namespace CCore
+
+
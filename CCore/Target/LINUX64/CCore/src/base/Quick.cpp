@@ -0,0 +1,140 @@
+/* Quick.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/base/Quick.h>
+
+namespace CCore {
+namespace Quick {
+
+/* types */
+
+using uint128 = unsigned __int128 ;
+
+/* functions */
+
+unsigned ScanLSBit(ScanUInt value) noexcept
+ {
+  return unsigned( __builtin_ctzl(value) );
+ }
+
+unsigned ScanMSBit(ScanUInt value) noexcept
+ {
+  return unsigned( 63-__builtin_clzl(value) );
+ }
+
+uint16 ByteSwap16(uint16 value) noexcept
+ {
+  return __builtin_bswap16(value);
+ }
+
+uint32 ByteSwap32(uint32 value) noexcept
+ {
+  return __builtin_bswap32(value);
+ }
+
+uint64 ByteSwap64(uint64 value) noexcept
+ {
+  return __builtin_bswap64(value);
+ }
+
+/* struct UIntMulFunc<uint32> */
+
+UIntMulFunc<uint32>::Mul::Mul(UInt a,UInt b)
+ {
+  uint64 res=uint64(a)*b;
+
+  hi=UInt(res>>32);
+  lo=UInt(res);
+ }
+
+auto UIntMulFunc<uint32>::Div(UInt hi,UInt lo,UInt den) -> UInt
+ {
+  return UInt( ((uint64(hi)<<32)|lo)/den );
+ }
+
+auto UIntMulFunc<uint32>::Mod(UInt hi,UInt lo,UInt den) -> UInt
+ {
+  return UInt( ((uint64(hi)<<32)|lo)%den );
+ }
+
+auto UIntMulFunc<uint32>::MulDiv(UInt a,UInt b,UInt den) -> UInt
+ {
+  return UInt( (uint64(a)*b)/den );
+ }
+
+UIntMulFunc<uint32>::DivMod::DivMod(UInt hi,UInt lo,UInt den)
+ {
+  uint64 x=(uint64(hi)<<32)|lo;
+
+  div=UInt(x/den);
+  mod=UInt(x%den);
+ }
+
+auto UIntMulFunc<uint32>::ModMul(UInt a,UInt b,UInt mod) -> UInt
+ {
+  return UInt( (uint64(a)*b)%mod );
+ }
+
+auto UIntMulFunc<uint32>::ModMac(UInt s,UInt a,UInt b,UInt mod) -> UInt
+ {
+  return UInt( (uint64(a)*b+s)%mod );
+ }
+
+/* struct UIntMulFunc<uint64> */
+
+UIntMulFunc<uint64>::Mul::Mul(UInt a,UInt b)
+ {
+  uint128 res=uint128(a)*b;
+
+  hi=UInt(res>>64);
+  lo=UInt(res);
+ }
+
+auto UIntMulFunc<uint64>::Div(UInt hi,UInt lo,UInt den) -> UInt
+ {
+  return UInt( ((uint128(hi)<<64)|lo)/den );
+ }
+
+auto UIntMulFunc<uint64>::Mod(UInt hi,UInt lo,UInt den) -> UInt
+ {
+  return UInt( ((uint128(hi)<<64)|lo)%den );
+ }
+
+auto UIntMulFunc<uint64>::MulDiv(UInt a,UInt b,UInt den) -> UInt
+ {
+  return UInt( (uint128(a)*b)/den );
+ }
+
+UIntMulFunc<uint64>::DivMod::DivMod(UInt hi,UInt lo,UInt den)
+ {
+  uint128 x=(uint128(hi)<<64)|lo;
+
+  div=UInt(x/den);
+  mod=UInt(x%den);
+ }
+
+auto UIntMulFunc<uint64>::ModMul(UInt a,UInt b,UInt mod) -> UInt
+ {
+  return UInt( (uint128(a)*b)%mod );
+ }
+
+auto UIntMulFunc<uint64>::ModMac(UInt s,UInt a,UInt b,UInt mod) -> UInt
+ {
+  return UInt( (uint128(a)*b+s)%mod );
+ }
+
+} // namespace Quick
+} // namespace CCore
+
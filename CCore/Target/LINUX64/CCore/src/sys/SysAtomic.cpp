@@ -0,0 +1,42 @@
+/* SysAtomic.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysAtomic.h>
+
+namespace CCore {
+namespace Sys {
+
+/* struct Atomic */
+
+Atomic::Type Atomic::Set(volatile Type *atomic,Type value) noexcept
+ {
+  return __atomic_exchange_n(atomic,value,__ATOMIC_SEQ_CST);
+ }
+
+Atomic::Type Atomic::Add(volatile Type *atomic,Type value) noexcept
+ {
+  return __atomic_fetch_add(atomic,value,__ATOMIC_SEQ_CST);
+ }
+
+Atomic::Type Atomic::TrySet(volatile Type *atomic,Type old_value,Type new_value) noexcept
+ {
+  __atomic_compare_exchange_n(atomic,&old_value,new_value,false,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST);
+
+  return old_value;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,207 @@
+/* SysCon.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysCon.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace CCore {
+namespace Sys {
+
+/* assert */
+
+static_assert( std::is_same_v<ConRead::ModeType,tcflag_t> ,"CCore::Sys::ConRead::ModeType : must be tcflag_t");
+
+/* functions */
+
+void ConWrite(StrLen str) noexcept
+ {
+  while( +str )
+    {
+     ssize_t ret=write(STDOUT_FILENO,str.ptr,str.len);
+
+     if( ret<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        return;
+       }
+
+     str+=ulen(ret);
+    }
+ }
+
+/* struct ConRead */
+
+auto ConRead::Init() noexcept -> InitType
+ {
+  InitType ret;
+
+  if( !isatty(STDIN_FILENO) )
+    {
+     // pipe or file, there is no console input
+
+     ret.handle=InvalidHandle;
+     ret.modes=0;
+     ret.error=NoError;
+
+     return ret;
+    }
+
+  ret.handle=STDIN_FILENO;
+
+  struct termios attr;
+
+  if( tcgetattr(ret.handle,&attr)!=0 )
+    {
+     ret.modes=0;
+     ret.error=NonNullError();
+
+     return ret;
+    }
+
+  ret.modes=attr.c_lflag;
+
+  BitClear(attr.c_lflag,tcflag_t(ECHO|ICANON));
+
+  attr.c_cc[VMIN]=1;
+  attr.c_cc[VTIME]=0;
+
+  if( tcsetattr(ret.handle,TCSANOW,&attr)!=0 )
+    {
+     ret.error=NonNullError();
+
+     return ret;
+    }
+
+  ret.error=NoError;
+
+  return ret;
+ }
+
+ErrorType ConRead::Exit(Type handle,ModeType modes) noexcept
+ {
+  if( handle==InvalidHandle ) return NoError;
+
+  struct termios attr;
+
+  if( tcgetattr(handle,&attr)!=0 ) return NonNullError();
+
+  attr.c_lflag=modes;
+
+  return ErrorIf( tcsetattr(handle,TCSANOW,&attr)!=0 );
+ }
+
+auto ConRead::read(char *buf,ulen len) noexcept -> IOResult
+ {
+  IOResult ret;
+
+  if( len==0 )
+    {
+     ret.error=NoError;
+     ret.len=0;
+
+     return ret;
+    }
+
+  do
+    {
+     ret=read(buf,len,DefaultTimeout);
+    }
+  while( !ret.error && ret.len==0 );
+
+  return ret;
+ }
+
+auto ConRead::read(char *buf,ulen len,TimeScope time_scope) noexcept -> IOResult
+ {
+  IOResult ret;
+
+  if( len==0 )
+    {
+     ret.error=NoError;
+     ret.len=0;
+
+     return ret;
+    }
+
+  for(unsigned to_msec; (to_msec=+time_scope.get())!=0 ;)
+    {
+     if( handle==InvalidHandle )
+       {
+        poll(0,0,int(to_msec)); // no input, wait for the timeout
+
+        continue;
+       }
+
+     struct pollfd pfd;
+
+     pfd.fd=handle;
+     pfd.events=POLLIN;
+     pfd.revents=0;
+
+     int result=poll(&pfd,1,int(to_msec));
+
+     if( result<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        ret.error=NonNullError();
+        ret.len=0;
+
+        return ret;
+       }
+
+     if( result>0 )
+       {
+        ssize_t rlen=::read(handle,buf,len);
+
+        if( rlen<0 )
+          {
+           if( errno==EINTR || errno==EAGAIN ) continue;
+
+           ret.error=NonNullError();
+           ret.len=0;
+
+           return ret;
+          }
+
+        if( rlen==0 )
+          {
+           ret.error=ErrorType(EPIPE);
+           ret.len=0;
+
+           return ret;
+          }
+
+        ret.error=NoError;
+        ret.len=ulen(rlen);
+
+        return ret;
+       }
+    }
+
+  ret.error=NoError;
+  ret.len=0;
+
+  return ret;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
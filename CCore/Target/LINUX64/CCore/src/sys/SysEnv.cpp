@@ -0,0 +1,54 @@
+/* SysEnv.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysEnv.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace CCore {
+namespace Sys {
+
+/* struct CopyEnv */
+
+CopyEnv::CopyEnv(const char *name,PtrLen<char> buf) noexcept
+ {
+  len=0;
+
+  if( const char *str=std::getenv(name) )
+    {
+     ulen str_len=std::strlen(str);
+
+     if( str_len>buf.len )
+       {
+        error=Error_TooLong;
+       }
+     else
+       {
+        Range(str,str_len).copyTo(buf.ptr);
+
+        len=str_len;
+        error=NoError;
+       }
+    }
+  else
+    {
+     error=Error_NoVariable;
+    }
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,81 @@
+/* SysError.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysError.h>
+
+#include <errno.h>
+#include <string.h>
+
+namespace CCore {
+namespace Sys {
+
+/* private functions */
+
+ErrorType NonNullError() noexcept
+ {
+  if( int ret=errno ) return ErrorType(ret);
+
+  return Error_SysErrorFault;
+ }
+
+/* struct ErrorDesc */
+
+bool ErrorDesc::set(StrLen msg)
+ {
+  str=msg.ptr;
+  len=msg.len;
+
+  return true;
+ }
+
+bool ErrorDesc::init(ErrorType error,PtrLen<char> buf) noexcept
+ {
+  switch( error )
+    {
+     case Error_SysErrorFault : return set("System failed to report a error"_c);
+
+     case Error_Task          : return set("System cannot create a task"_c);
+
+     case Error_Socket        : return set("System socket failure"_c);
+
+     case Error_BrokenUtf8    : return set("Broken UTF8 argument"_c);
+
+     case Error_Spawn         : return set("Child process spawn/wait failed"_c);
+
+     case Error_Running       : return set("Child process still running"_c);
+
+     case Error_TooLong       : return set("Too long string"_c);
+
+     case Error_NoVariable    : return set("No such variable"_c);
+    }
+
+  if( error<0 || !buf.len )
+    {
+     str=0;
+     len=0;
+
+     return false;
+    }
+
+  // GNU strerror_r() may return a static string instead of filling the buffer
+
+  const char *msg=strerror_r(error,buf.ptr,buf.len);
+
+  return set(StrLen(msg,strlen(msg)));
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,653 @@
+/* SysFile.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysFile.h>
+#include <CCore/inc/sys/SysFileInternal.h>
+
+#include <CCore/inc/MemBase.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysFile */
+
+namespace Private_SysFile {
+
+/* Make...() */
+
+int MakeOpenFlags(FileOpenFlags oflags)
+ {
+  int ret=O_CLOEXEC;
+
+  if( (oflags&Open_Read) && (oflags&Open_Write) )
+    ret|=O_RDWR;
+  else if( oflags&Open_Write )
+    ret|=O_WRONLY;
+  else
+    ret|=O_RDONLY;
+
+  if( oflags&Open_New )
+    {
+     ret|=O_CREAT|O_EXCL;
+    }
+  else
+    {
+     if( oflags&Open_Create ) ret|=O_CREAT;
+
+     if( oflags&Open_Erase ) ret|=O_TRUNC;
+    }
+
+  return ret;
+ }
+
+char * DupName(const FileName &file_name)
+ {
+  char *ret=static_cast<char *>( std::malloc(file_name.len+1) );
+
+  if( ret ) std::memcpy(ret,file_name.buf,file_name.len+1);
+
+  return ret;
+ }
+
+/* struct OpenFile */
+
+struct OpenFile : File::OpenType
+ {
+  bool set(int fd)
+   {
+    handle=fd;
+    file_name=0;
+
+    if( fd<0 )
+      {
+       error=MakeError(FileError_OpenFault);
+
+       return false;
+      }
+    else
+      {
+       error=FileError_Ok;
+
+       return true;
+      }
+   }
+
+  void close(FileError fe)
+   {
+    error=fe;
+
+    ::close(handle); // ignore unprobable error
+
+    handle=InvalidHandle;
+   }
+
+  explicit OpenFile(FileError fe)
+   {
+    handle=InvalidHandle;
+    file_name=0;
+    error=fe;
+   }
+
+  OpenFile(const FileName &name,FileOpenFlags oflags)
+   {
+    // open
+
+    if( !set( open(name,MakeOpenFlags(oflags),0666) ) ) return;
+
+    // post-open
+
+    if( oflags&Open_PosEnd )
+      {
+       if( lseek(handle,0,SEEK_END)<0 )
+         {
+          close(MakeError(FileError_OpenFault));
+
+          return;
+         }
+      }
+
+    if( !(oflags&Open_Pos) )
+      {
+       posix_fadvise(handle,0,0,POSIX_FADV_SEQUENTIAL);
+      }
+
+    if( oflags&Open_AutoDelete )
+      {
+       file_name=DupName(name);
+
+       if( !file_name )
+         {
+          close(FileError_SysOverload);
+
+          unlink(name);
+
+          return;
+         }
+      }
+   }
+ };
+
+/* struct OpenAltFile */
+
+struct OpenAltFile : AltFile::OpenType
+ {
+  bool set(int fd)
+   {
+    handle=fd;
+    file_len=0;
+    file_name=0;
+
+    if( fd<0 )
+      {
+       error=MakeError(FileError_OpenFault);
+
+       return false;
+      }
+    else
+      {
+       error=FileError_Ok;
+
+       return true;
+      }
+   }
+
+  void close(FileError fe)
+   {
+    file_len=0;
+    error=fe;
+
+    ::close(handle); // ignore unprobable error
+
+    handle=InvalidHandle;
+   }
+
+  explicit OpenAltFile(FileError fe)
+   {
+    handle=InvalidHandle;
+    file_len=0;
+    file_name=0;
+    error=fe;
+   }
+
+  OpenAltFile(const FileName &name,FileOpenFlags oflags)
+   {
+    // open
+
+    if( !set( open(name,MakeOpenFlags(oflags),0666) ) ) return;
+
+    // post-open
+
+    struct stat info;
+
+    if( fstat(handle,&info)!=0 )
+      {
+       close(MakeError(FileError_OpenFault));
+
+       return;
+      }
+
+    file_len=FilePosType(info.st_size);
+
+    if( oflags&Open_AutoDelete )
+      {
+       file_name=DupName(name);
+
+       if( !file_name )
+         {
+          close(FileError_SysOverload);
+
+          unlink(name);
+
+          return;
+         }
+      }
+   }
+ };
+
+/* FileClose() */
+
+void FileClose(FileMultiError &errout,int handle,char *file_name,bool preserve_file)
+ {
+  if( ::close(handle)!=0 )
+    {
+     preserve_file=false;
+
+     AddErrorIf(errout,FileError_CloseFault,true);
+    }
+
+  if( file_name )
+    {
+     if( !preserve_file )
+       {
+        AddErrorIf(errout,FileError_CloseFault, unlink(file_name)!=0 );
+       }
+
+     std::free(file_name);
+    }
+ }
+
+/* ...All() */
+
+FileError WriteAll(int handle,FilePosType off,const uint8 *buf,ulen len)
+ {
+  while( len )
+    {
+     ssize_t ret=pwrite(handle,buf,len,off_t(off));
+
+     if( ret<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        return MakeError(FileError_WriteFault);
+       }
+
+     if( ret==0 ) return FileError_WriteLenMismatch;
+
+     buf+=ret;
+     len-=ulen(ret);
+     off+=FilePosType(ret);
+    }
+
+  return FileError_Ok;
+ }
+
+FileError ReadAll(int handle,FilePosType off,uint8 *buf,ulen len)
+ {
+  while( len )
+    {
+     ssize_t ret=pread(handle,buf,len,off_t(off));
+
+     if( ret<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        return MakeError(FileError_ReadFault);
+       }
+
+     if( ret==0 ) return FileError_ReadLenMismatch;
+
+     buf+=ret;
+     len-=ulen(ret);
+     off+=FilePosType(ret);
+    }
+
+  return FileError_Ok;
+ }
+
+} // namespace Private_SysFile
+
+using namespace Private_SysFile;
+
+/* struct File */
+
+auto File::Open(StrLen file_name_,FileOpenFlags oflags) noexcept -> OpenType
+ {
+  FileName file_name;
+
+  if( auto fe=file_name.prepare(file_name_) ) return OpenFile(fe);
+
+  return OpenFile(file_name,oflags);
+ }
+
+void File::Close(FileMultiError &errout,Type handle,FileOpenFlags,char *file_name,bool preserve_file) noexcept
+ {
+  FileClose(errout,handle,file_name,preserve_file);
+ }
+
+auto File::Write(Type handle,FileOpenFlags oflags,const uint8 *buf,ulen len) noexcept -> IOResult
+ {
+  IOResult ret;
+
+  if( oflags&Open_Write )
+    {
+     ulen done=0;
+
+     while( done<len )
+       {
+        ssize_t result=::write(handle,buf+done,len-done);
+
+        if( result<0 )
+          {
+           if( errno==EINTR ) continue;
+
+           ret.len=done;
+           ret.error=MakeError(FileError_WriteFault);
+
+           return ret;
+          }
+
+        if( result==0 ) break;
+
+        done+=ulen(result);
+       }
+
+     ret.len=done;
+     ret.error=FileError_Ok;
+    }
+  else
+    {
+     ret.len=0;
+     ret.error=FileError_NoMethod;
+    }
+
+  return ret;
+ }
+
+auto File::Read(Type handle,FileOpenFlags oflags,uint8 *buf,ulen len) noexcept -> IOResult
+ {
+  IOResult ret;
+
+  if( oflags&Open_Read )
+    {
+     for(;;)
+       {
+        ssize_t result=::read(handle,buf,len);
+
+        if( result<0 )
+          {
+           if( errno==EINTR ) continue;
+
+           ret.len=0;
+           ret.error=MakeError(FileError_ReadFault);
+          }
+        else
+          {
+           ret.len=ulen(result);
+           ret.error=FileError_Ok;
+          }
+
+        break;
+       }
+    }
+  else
+    {
+     ret.len=0;
+     ret.error=FileError_NoMethod;
+    }
+
+  return ret;
+ }
+
+auto File::GetLen(Type handle,FileOpenFlags oflags) noexcept -> PosResult
+ {
+  PosResult ret;
+
+  if( oflags&Open_Pos )
+    {
+     struct stat info;
+
+     if( fstat(handle,&info)!=0 )
+       {
+        ret.pos=0;
+        ret.error=MakeError(FileError_PosFault);
+       }
+     else
+       {
+        ret.pos=FilePosType(info.st_size);
+        ret.error=FileError_Ok;
+       }
+    }
+  else
+    {
+     ret.pos=0;
+     ret.error=FileError_NoMethod;
+    }
+
+  return ret;
+ }
+
+auto File::GetPos(Type handle,FileOpenFlags oflags) noexcept -> PosResult
+ {
+  PosResult ret;
+
+  if( oflags&Open_Pos )
+    {
+     off_t pos=lseek(handle,0,SEEK_CUR);
+
+     if( pos<0 )
+       {
+        ret.pos=0;
+        ret.error=MakeError(FileError_PosFault);
+       }
+     else
+       {
+        ret.pos=FilePosType(pos);
+        ret.error=FileError_Ok;
+       }
+    }
+  else
+    {
+     ret.pos=0;
+     ret.error=FileError_NoMethod;
+    }
+
+  return ret;
+ }
+
+FileError File::SetPos(Type handle,FileOpenFlags oflags,FilePosType pos) noexcept
+ {
+  if( oflags&Open_Pos )
+    {
+     return MakeErrorIf(FileError_PosFault, lseek(handle,off_t(pos),SEEK_SET)<0 );
+    }
+  else
+    {
+     return FileError_NoMethod;
+    }
+ }
+
+FileError File::Reserve(Type handle,FileOpenFlags oflags,FilePosType len) noexcept
+ {
+  if( !(oflags&Open_Write) ) return FileError_NoMethod;
+
+  if( !len ) return FileError_Ok;
+
+  off_t pos=lseek(handle,0,SEEK_CUR);
+
+  if( pos<0 ) return MakeError(FileError_PosFault);
+
+  return MakeErrorIf(FileError_WriteFault, fallocate(handle,FALLOC_FL_KEEP_SIZE,pos,off_t(len))!=0 );
+ }
+
+ //
+ // reflink of the aligned tail, then copy_file_range, then sendfile, then read/write with a large buffer
+ //
+
+auto File::CopyFrom(Type handle,FileOpenFlags oflags,Type src_handle,FileOpenFlags src_oflags) noexcept -> PosResult
+ {
+  if( !(oflags&Open_Write) || !(src_oflags&Open_Read) ) return {0,FileError_NoMethod};
+
+  FilePosType done=0;
+
+  // reflink
+
+  struct stat info;
+
+  off_t src_pos=lseek(src_handle,0,SEEK_CUR);
+  off_t dst_pos=lseek(handle,0,SEEK_CUR);
+
+  if( src_pos>=0 && dst_pos>=0 && fstat(src_handle,&info)==0 && info.st_size>src_pos && info.st_blksize>0 )
+    {
+     off_t blk=info.st_blksize;
+
+     if( src_pos%blk==0 && dst_pos%blk==0 )
+       {
+        struct file_clone_range range;
+
+        range.src_fd=src_handle;
+        range.src_offset=uint64(src_pos);
+        range.src_length=0; // to the end
+        range.dest_offset=uint64(dst_pos);
+
+        if( ioctl(handle,FICLONERANGE,&range)==0 )
+          {
+           off_t len=info.st_size-src_pos;
+
+           if( lseek(handle,dst_pos+len,SEEK_SET)<0 ) return {0,MakeError(FileError_PosFault)};
+
+           if( lseek(src_handle,info.st_size,SEEK_SET)<0 ) return {0,MakeError(FileError_PosFault)};
+
+           return {FilePosType(len),FileError_Ok};
+          }
+       }
+    }
+
+  // in-kernel copy, both file positions are used and advanced
+
+  auto fallback = [] (int error) { return error==EXDEV || error==EINVAL || error==ENOSYS || error==EOPNOTSUPP || error==EBADF ; } ;
+
+  for(;;)
+    {
+     ssize_t result=copy_file_range(src_handle,0,handle,0,size_t(1)<<30,0);
+
+     if( result==0 ) return {done,FileError_Ok};
+
+     if( result<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        if( fallback(errno) ) break;
+
+        return {done,MakeError(FileError_WriteFault)};
+       }
+
+     done+=FilePosType(result);
+    }
+
+  for(;;)
+    {
+     ssize_t result=sendfile(handle,src_handle,0,size_t(1)<<30);
+
+     if( result==0 ) return {done,FileError_Ok};
+
+     if( result<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        if( fallback(errno) ) break;
+
+        return {done,MakeError(FileError_WriteFault)};
+       }
+
+     done+=FilePosType(result);
+    }
+
+  // streaming copy
+
+  const ulen BufLen = 1_MByte ;
+
+  char small[64_KByte];
+
+  char *buf=static_cast<char *>(TryMemAlloc(BufLen));
+  ulen buf_len=BufLen;
+
+  if( !buf )
+    {
+     buf=small;
+     buf_len=sizeof small;
+    }
+
+  PosResult ret{done,FileError_Ok};
+
+  for(;;)
+    {
+     ssize_t result=::read(src_handle,buf,buf_len);
+
+     if( result==0 ) break;
+
+     if( result<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        ret.error=MakeError(FileError_ReadFault);
+
+        break;
+       }
+
+     IOResult wr=Write(handle,oflags,MutatePtr<const uint8>(buf),ulen(result));
+
+     ret.pos+=wr.len;
+
+     if( wr.error )
+       {
+        ret.error=wr.error;
+
+        break;
+       }
+
+     if( wr.len!=ulen(result) )
+       {
+        ret.error=FileError_WriteLenMismatch;
+
+        break;
+       }
+    }
+
+  if( buf!=small ) MemFree(buf);
+
+  return ret;
+ }
+
+/* struct AltFile */
+
+auto AltFile::Open(StrLen file_name_,FileOpenFlags oflags) noexcept -> OpenType
+ {
+  FileName file_name;
+
+  if( auto fe=file_name.prepare(file_name_) ) return OpenAltFile(fe);
+
+  return OpenAltFile(file_name,oflags);
+ }
+
+void AltFile::Close(FileMultiError &errout,Type handle,FileOpenFlags,char *file_name,bool preserve_file) noexcept
+ {
+  FileClose(errout,handle,file_name,preserve_file);
+ }
+
+FileError AltFile::Write(Type handle,FileOpenFlags oflags,FilePosType off,const uint8 *buf,ulen len) noexcept
+ {
+  if( oflags&Open_Write )
+    {
+     return WriteAll(handle,off,buf,len);
+    }
+  else
+    {
+     return FileError_NoMethod;
+    }
+ }
+
+FileError AltFile::Read(Type handle,FileOpenFlags oflags,FilePosType off,uint8 *buf,ulen len) noexcept
+ {
+  if( oflags&Open_Read )
+    {
+     return ReadAll(handle,off,buf,len);
+    }
+  else
+    {
+     return FileError_NoMethod;
+    }
+ }
+
+} // namespace Sys
+} // namespace CCore
+
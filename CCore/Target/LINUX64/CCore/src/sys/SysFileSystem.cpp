@@ -0,0 +1,814 @@
+/* SysFileSystem.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysFileSystem.h>
+#include <CCore/inc/sys/SysFileInternal.h>
+
+#include <CCore/inc/Path.h>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <cstring>
+
+extern char **environ;
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysFileSystem */
+
+namespace Private_SysFileSystem {
+
+/* functions */
+
+inline DIR * ToDir(FileSystem::DirCursor::Type handle) { return static_cast<DIR *>(handle); }
+
+bool IsSpecial(const char *name)
+ {
+  return name[0]=='.' && ( name[1]==0 || ( name[1]=='.' && name[2]==0 ) );
+ }
+
+bool IsDirEntry(int dir_fd,const struct dirent *entry)
+ {
+  switch( entry->d_type )
+    {
+     case DT_DIR : return true;
+
+     case DT_UNKNOWN :
+      {
+       struct stat info;
+
+       if( fstatat(dir_fd,entry->d_name,&info,AT_SYMLINK_NOFOLLOW)!=0 ) return false;
+
+       return S_ISDIR(info.st_mode);
+      }
+
+     default: return false;
+    }
+ }
+
+void SetStatus(FileStatus &ret,const struct stat &info)
+ {
+  ret.type=ToFileType(info.st_mode);
+  ret.time=ToCmpFileTime(info.st_mtim);
+  ret.len=FilePosType(info.st_size);
+  ret.id=uint64(info.st_ino);
+ }
+
+/* DeleteDirRecursive() */
+
+FileError EmptyDir(int dir_fd)
+ {
+  DIR *dir=fdopendir(dir_fd);
+
+  if( !dir )
+    {
+     FileError fe=MakeError(FileError_OpFault);
+
+     close(dir_fd);
+
+     return fe;
+    }
+
+  FileError ret=FileError_Ok;
+
+  errno=0;
+
+  while( struct dirent *entry=readdir(dir) )
+    {
+     if( IsSpecial(entry->d_name) ) continue;
+
+     if( IsDirEntry(dir_fd,entry) )
+       {
+        int sub_fd=openat(dir_fd,entry->d_name,O_RDONLY|O_DIRECTORY|O_NOFOLLOW|O_CLOEXEC);
+
+        if( sub_fd<0 )
+          {
+           ret=MakeError(FileError_OpFault);
+
+           break;
+          }
+
+        if( FileError fe=EmptyDir(sub_fd) )
+          {
+           ret=fe;
+
+           break;
+          }
+
+        if( unlinkat(dir_fd,entry->d_name,AT_REMOVEDIR)!=0 )
+          {
+           ret=MakeError(FileError_OpFault);
+
+           break;
+          }
+       }
+     else
+       {
+        if( unlinkat(dir_fd,entry->d_name,0)!=0 )
+          {
+           ret=MakeError(FileError_OpFault);
+
+           break;
+          }
+       }
+
+     errno=0;
+    }
+
+  if( !ret && errno ) ret=MakeError(FileError_OpFault);
+
+  closedir(dir);
+
+  return ret;
+ }
+
+FileError DeleteDirRecursive(const char *dir_name)
+ {
+  int dir_fd=open(dir_name,O_RDONLY|O_DIRECTORY|O_NOFOLLOW|O_CLOEXEC);
+
+  if( dir_fd<0 ) return MakeError(FileError_OpFault);
+
+  if( FileError fe=EmptyDir(dir_fd) ) return fe;
+
+  return MakeErrorIf(FileError_OpFault, rmdir(dir_name)!=0 );
+ }
+
+/* CopyData() */
+
+ // reflink, then in-kernel copy, then plain read/write
+
+FileError CopyData(int src_fd,int dst_fd) noexcept
+ {
+  if( ioctl(dst_fd,FICLONE,src_fd)==0 ) return FileError_Ok;
+
+  for(;;)
+    {
+     ssize_t result=copy_file_range(src_fd,0,dst_fd,0,size_t(1)<<30,0);
+
+     if( result==0 ) return FileError_Ok;
+
+     if( result<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        if( errno==EXDEV || errno==EINVAL || errno==ENOSYS || errno==EOPNOTSUPP ) break;
+
+        return MakeError(FileError_WriteFault);
+       }
+    }
+
+  char buf[64_KByte];
+
+  for(;;)
+    {
+     ssize_t result=::read(src_fd,buf,sizeof buf);
+
+     if( result==0 ) return FileError_Ok;
+
+     if( result<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        return MakeError(FileError_ReadFault);
+       }
+
+     for(const char *ptr=buf; result>0 ;)
+       {
+        ssize_t len=::write(dst_fd,ptr,size_t(result));
+
+        if( len<0 )
+          {
+           if( errno==EINTR ) continue;
+
+           return MakeError(FileError_WriteFault);
+          }
+
+        ptr+=len;
+        result-=len;
+       }
+    }
+ }
+
+/* Execz() */
+
+ // cmdline ends with " &", the shell detaches the program and exits at once
+
+FileError Execz(const char *dir,const char *cmdline)
+ {
+  posix_spawn_file_actions_t actions;
+
+  if( posix_spawn_file_actions_init(&actions) ) return FileError_SysOverload;
+
+  if( *dir && posix_spawn_file_actions_addchdir_np(&actions,dir) )
+    {
+     posix_spawn_file_actions_destroy(&actions);
+
+     return FileError_SysOverload;
+    }
+
+  char sh[]="/bin/sh";
+  char opt[]="-c";
+
+  char *argv[]={sh,opt,const_cast<char *>(cmdline),0};
+
+  pid_t pid;
+
+  int error=posix_spawn(&pid,sh,&actions,0,argv,environ);
+
+  posix_spawn_file_actions_destroy(&actions);
+
+  if( error ) return MakeError(FileError_OpFault,error);
+
+  int status;
+
+  while( waitpid(pid,&status,0)<0 && errno==EINTR );
+
+  return FileError_Ok;
+ }
+
+/* struct Normalize */
+
+struct Normalize
+ {
+  char *buf;
+  ulen len;
+
+  explicit Normalize(char *buf_) : buf(buf_),len(0) {}
+
+  void back()
+   {
+    while( len>1 && buf[len-1]!='/' ) len--;
+
+    if( len>1 ) len--;
+   }
+
+  bool add(StrLen name,ulen cap)
+   {
+    if( !name || PathBase::IsDot(name) ) return true;
+
+    if( PathBase::IsDotDot(name) )
+      {
+       back();
+
+       return true;
+      }
+
+    ulen extra=( len>1 )? name.len+1 : name.len ;
+
+    if( extra>cap-len ) return false;
+
+    if( len>1 ) buf[len++]='/';
+
+    name.copyTo(buf+len);
+
+    len+=name.len;
+
+    return true;
+   }
+
+  bool feed(StrLen path,ulen cap)
+   {
+    while( +path )
+      {
+       ulen i=0;
+
+       for(; i<path.len && path[i]!='/' ;i++);
+
+       if( !add(path.prefix(i),cap) ) return false;
+
+       if( i<path.len ) i++;
+
+       path+=i;
+      }
+
+    return true;
+   }
+ };
+
+} // namespace Private_SysFileSystem
+
+using namespace Private_SysFileSystem;
+
+/* struct FileSystem::DirCursor */
+
+void FileSystem::DirCursor::init(FileSystem *,StrLen dir_name) noexcept
+ {
+  is_closed=true;
+
+  if( !dir_name )
+    {
+     error=FileError_BadName;
+
+     return;
+    }
+
+  FileName path;
+
+  if( auto fe=path.prepare(dir_name) )
+    {
+     error=fe;
+    }
+  else
+    {
+     DIR *dir=opendir(path);
+
+     if( !dir )
+       {
+        int error_=errno;
+
+        if( error_!=ENOENT )
+          {
+           error=MakeError(FileError_OpFault,error_);
+          }
+        else
+          {
+           error=FileError_Ok;
+          }
+       }
+     else
+       {
+        handle=dir;
+        is_closed=false;
+
+        error=FileError_Ok;
+       }
+    }
+ }
+
+void FileSystem::DirCursor::exit() noexcept
+ {
+  if( !is_closed )
+    {
+     closedir(ToDir(handle));
+    }
+ }
+
+bool FileSystem::DirCursor::next() noexcept
+ {
+  if( is_closed ) return false;
+
+  DIR *dir=ToDir(handle);
+
+  errno=0;
+
+  while( struct dirent *entry=readdir(dir) )
+    {
+     ulen name_len=std::strlen(entry->d_name);
+
+     if( name_len>DimOf(file_name) )
+       {
+        is_closed=true;
+
+        closedir(dir);
+
+        error=FileError_TooLongPath;
+
+        return false;
+       }
+
+     Range(entry->d_name,name_len).copyTo(file_name);
+
+     len=name_len;
+     type=IsDirEntry(dirfd(dir),entry)?FileType_dir:FileType_file;
+
+     return true;
+    }
+
+  if( int error_=errno )
+    {
+     error=MakeError(FileError_OpFault,error_);
+    }
+
+  is_closed=true;
+
+  closedir(dir);
+
+  return false;
+ }
+
+/* struct FileSystem::DirHandle */
+
+void FileSystem::DirHandle::init(FileSystem *,StrLen dir_name) noexcept
+ {
+  is_closed=true;
+
+  if( !dir_name )
+    {
+     error=FileError_BadName;
+
+     return;
+    }
+
+  FileName path;
+
+  if( auto fe=path.prepare(dir_name) )
+    {
+     error=fe;
+    }
+  else
+    {
+     int ret=open(path,O_PATH|O_DIRECTORY|O_CLOEXEC);
+
+     if( ret<0 )
+       {
+        int error_=errno;
+
+        if( error_!=ENOENT && error_!=ENOTDIR )
+          {
+           error=MakeError(FileError_OpFault,error_);
+          }
+        else
+          {
+           error=FileError_Ok;
+          }
+       }
+     else
+       {
+        fd=ret;
+        is_closed=false;
+
+        error=FileError_Ok;
+       }
+    }
+ }
+
+void FileSystem::DirHandle::exit() noexcept
+ {
+  if( !is_closed )
+    {
+     close(fd);
+    }
+ }
+
+auto FileSystem::DirHandle::getFileStatus(StrLen file_name) noexcept -> StatusResult
+ {
+  StatusResult ret;
+
+  if( is_closed )
+    {
+     ret.error=FileError_Ok;
+
+     return ret;
+    }
+
+  FileName path;
+
+  if( auto fe=path.prepare(file_name) )
+    {
+     ret.error=fe;
+    }
+  else
+    {
+     struct stat info;
+
+     if( fstatat(fd,path,&info,0)==0 ) SetStatus(ret.status,info);
+
+     ret.error=FileError_Ok;
+    }
+
+  return ret;
+ }
+
+/* struct FileSystem */
+
+FileError FileSystem::init() noexcept
+ {
+  return FileError_Ok;
+ }
+
+FileError FileSystem::exit() noexcept
+ {
+  return FileError_Ok;
+ }
+
+auto FileSystem::getFileType(StrLen path_) noexcept -> TypeResult
+ {
+  TypeResult ret;
+  FileName path;
+
+  if( auto fe=path.prepare(path_) )
+    {
+     ret.type=FileType_none;
+     ret.error=fe;
+    }
+  else
+    {
+     struct stat info;
+
+     if( stat(path,&info)!=0 )
+       {
+        ret.type=FileType_none;
+        ret.error=FileError_Ok;
+       }
+     else
+       {
+        ret.type=ToFileType(info.st_mode);
+        ret.error=FileError_Ok;
+       }
+    }
+
+  return ret;
+ }
+
+auto FileSystem::getFileUpdateTime(StrLen path_) noexcept -> CmpTimeResult
+ {
+  CmpTimeResult ret;
+  FileName path;
+
+  if( auto fe=path.prepare(path_) )
+    {
+     ret.time=0;
+     ret.error=fe;
+    }
+  else
+    {
+     struct stat info;
+
+     if( stat(path,&info)!=0 )
+       {
+        ret.time=0;
+        ret.error=FileError_Ok;
+       }
+     else
+       {
+        ret.time=ToCmpFileTime(info.st_mtim);
+        ret.error=FileError_Ok;
+       }
+    }
+
+  return ret;
+ }
+
+auto FileSystem::getFileStatus(StrLen path_) noexcept -> StatusResult
+ {
+  StatusResult ret;
+  FileName path;
+
+  if( auto fe=path.prepare(path_) )
+    {
+     ret.error=fe;
+    }
+  else
+    {
+     struct stat info;
+
+     if( stat(path,&info)==0 ) SetStatus(ret.status,info);
+
+     ret.error=FileError_Ok;
+    }
+
+  return ret;
+ }
+
+FileError FileSystem::createFile(StrLen file_name) noexcept
+ {
+  FileName path;
+
+  if( auto fe=path.prepare(file_name) ) return fe;
+
+  int fd=open(path,O_WRONLY|O_CREAT|O_EXCL|O_CLOEXEC,0666);
+
+  if( fd<0 ) return MakeError(FileError_OpenFault);
+
+  close(fd);
+
+  return FileError_Ok;
+ }
+
+FileError FileSystem::deleteFile(StrLen file_name) noexcept
+ {
+  FileName path;
+
+  if( auto fe=path.prepare(file_name) ) return fe;
+
+  return MakeErrorIf(FileError_OpFault, unlink(path)!=0 );
+ }
+
+FileError FileSystem::createDir(StrLen dir_name) noexcept
+ {
+  FileName path;
+
+  if( auto fe=path.prepare(dir_name) ) return fe;
+
+  return MakeErrorIf(FileError_OpFault, mkdir(path,0777)!=0 );
+ }
+
+FileError FileSystem::deleteDir(StrLen dir_name,bool recursive) noexcept
+ {
+  if( !dir_name ) return FileError_BadName;
+
+  FileName path;
+
+  if( auto fe=path.prepare(dir_name) ) return fe;
+
+  if( recursive ) return DeleteDirRecursive(path);
+
+  return MakeErrorIf(FileError_OpFault, rmdir(path)!=0 );
+ }
+
+FileError FileSystem::rename(StrLen old_path_,StrLen new_path_,bool allow_overwrite) noexcept
+ {
+  FileName old_path;
+
+  if( auto fe=old_path.prepare(old_path_) ) return fe;
+
+  FileName new_path;
+
+  if( auto fe=new_path.prepare(new_path_) ) return fe;
+
+  unsigned flags = allow_overwrite? 0 : RENAME_NOREPLACE ;
+
+  return MakeErrorIf(FileError_OpFault, renameat2(AT_FDCWD,old_path,AT_FDCWD,new_path,flags)!=0 );
+ }
+
+FileError FileSystem::copyFile(StrLen src_file_,StrLen dst_file_) noexcept
+ {
+  FileName src_file;
+
+  if( auto fe=src_file.prepare(src_file_) ) return fe;
+
+  FileName dst_file;
+
+  if( auto fe=dst_file.prepare(dst_file_) ) return fe;
+
+  int src_fd=open(src_file,O_RDONLY|O_CLOEXEC);
+
+  if( src_fd<0 ) return MakeError(FileError_OpenFault);
+
+  struct stat info;
+
+  if( fstat(src_fd,&info)!=0 )
+    {
+     FileError fe=MakeError(FileError_OpFault);
+
+     close(src_fd);
+
+     return fe;
+    }
+
+  int dst_fd=open(dst_file,O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,info.st_mode&0777);
+
+  if( dst_fd<0 )
+    {
+     FileError fe=MakeError(FileError_OpenFault);
+
+     close(src_fd);
+
+     return fe;
+    }
+
+  FileError fe=CopyData(src_fd,dst_fd);
+
+  close(src_fd);
+
+  if( close(dst_fd)!=0 && !fe ) fe=MakeError(FileError_CloseFault);
+
+  if( fe ) unlink(dst_file);
+
+  return fe;
+ }
+
+FileError FileSystem::touchFile(StrLen file_name) noexcept
+ {
+  FileName path;
+
+  if( auto fe=path.prepare(file_name) ) return fe;
+
+  int fd=open(path,O_WRONLY|O_CREAT|O_NOCTTY|O_CLOEXEC,0666);
+
+  if( fd<0 ) return MakeError(FileError_OpenFault);
+
+  FileError fe=MakeErrorIf(FileError_OpFault, futimens(fd,0)!=0 );
+
+  close(fd);
+
+  return fe;
+ }
+
+FileError FileSystem::linkFile(StrLen src_file_,StrLen dst_file_,bool sym) noexcept
+ {
+  FileName src_file;
+
+  if( auto fe=src_file.prepare(src_file_) ) return fe;
+
+  FileName dst_file;
+
+  if( auto fe=dst_file.prepare(dst_file_) ) return fe;
+
+  if( unlink(dst_file)!=0 && errno!=ENOENT ) return MakeError(FileError_OpFault);
+
+  if( sym ) return MakeErrorIf(FileError_OpFault, symlink(src_file,dst_file)!=0 );
+
+  return MakeErrorIf(FileError_OpFault, link(src_file,dst_file)!=0 );
+ }
+
+FileError FileSystem::remove(StrLen path_) noexcept
+ {
+  FileName path;
+
+  if( auto fe=path.prepare(path_) ) return fe;
+
+  struct stat info;
+
+  if( lstat(path,&info)!=0 ) return MakeError(FileError_NoPath);
+
+  if( S_ISDIR(info.st_mode) )
+    {
+     return MakeErrorIf(FileError_OpFault, rmdir(path)!=0 );
+    }
+  else
+    {
+     return MakeErrorIf(FileError_OpFault, unlink(path)!=0 );
+    }
+ }
+
+FileError FileSystem::exec(StrLen dir,StrLen program,StrLen arg) noexcept
+ {
+  FileName dirz;
+
+  if( auto fe=dirz.prepare(dir) ) return fe;
+
+  char cmdline[MaxPathLen+32_KByte +4];
+
+  if( program.len>MaxPathLen || arg.len>32_KByte ) return FileError_TooLongPath;
+
+  ulen len=program.len;
+
+  program.copyTo(cmdline);
+  cmdline[len++]=' ';
+  arg.copyTo(cmdline+len);
+  len+=arg.len;
+  cmdline[len++]=' ';
+  cmdline[len++]='&';
+  cmdline[len]=0;
+
+  return Execz(dirz,cmdline);
+ }
+
+auto FileSystem::pathOf(StrLen path_,char buf[MaxPathLen+1]) noexcept -> PathOfResult
+ {
+  PathOfResult ret;
+
+  Normalize out(buf);
+
+  buf[out.len++]='/';
+
+  if( !PathIsRooted(path_) )
+    {
+     char cwd[MaxPathLen+1];
+
+     if( !getcwd(cwd,DimOf(cwd)) )
+       {
+        ret.path=Empty;
+        ret.error=MakeError(FileError_OpFault);
+
+        return ret;
+       }
+
+     if( !out.feed(StrLen(cwd,std::strlen(cwd)),MaxPathLen) )
+       {
+        ret.path=Empty;
+        ret.error=FileError_TooLongPath;
+
+        return ret;
+       }
+    }
+
+  if( !out.feed(path_,MaxPathLen) )
+    {
+     ret.path=Empty;
+     ret.error=FileError_TooLongPath;
+
+     return ret;
+    }
+
+  buf[out.len]=0;
+
+  ret.path=StrLen(buf,out.len);
+  ret.error=FileError_Ok;
+
+  return ret;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,130 @@
+/* SysFileWatch.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysFileWatch.h>
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <cstring>
+
+namespace CCore {
+namespace Sys {
+
+/* struct FileWatch */
+
+ErrorType FileWatch::open() noexcept
+ {
+  fd=inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+
+  if( fd==-1 ) return NonNullError();
+
+  return NoError;
+ }
+
+void FileWatch::close() noexcept
+ {
+  if( fd!=-1 )
+    {
+     ::close(fd);
+
+     fd=-1;
+    }
+ }
+
+auto FileWatch::add(StrLen dir_name) noexcept -> AddResult
+ {
+  char path[MaxPathLen+1];
+
+  if( dir_name.len>MaxPathLen ) return {-1,Error_TooLong};
+
+  dir_name.copyTo(path);
+
+  path[dir_name.len]=0;
+
+  const uint32_t mask = IN_CREATE|IN_DELETE|IN_MODIFY|IN_ATTRIB|IN_CLOSE_WRITE|IN_MOVED_FROM|IN_MOVED_TO
+                       |IN_DELETE_SELF|IN_MOVE_SELF|IN_ONLYDIR ;
+
+  int wd=inotify_add_watch(fd,path,mask);
+
+  if( wd==-1 ) return {-1,NonNullError()};
+
+  return {wd,NoError};
+ }
+
+auto FileWatch::read(PtrLen<char> buf) noexcept -> ReadResult
+ {
+  ssize_t ret=::read(fd,buf.ptr,buf.len);
+
+  if( ret<0 )
+    {
+     int error=errno;
+
+     if( error==EAGAIN ) return {0,NoError};
+
+     return {0,ErrorType(error)};
+    }
+
+  return {ulen(ret),NoError};
+ }
+
+bool FileWatch::Next(PtrLen<const char> &data,Event &ret) noexcept
+ {
+  for(;;)
+    {
+     struct inotify_event event;
+
+     if( data.len<sizeof event ) return false;
+
+     std::memcpy(&event,data.ptr,sizeof event);
+
+     ulen len=sizeof event+event.len;
+
+     if( data.len<len ) return false;
+
+     const char *name=data.ptr+sizeof event;
+
+     data+=len;
+
+     ret.wd=event.wd;
+     ret.name=Empty;
+
+     if( event.mask&IN_Q_OVERFLOW )
+       {
+        ret.type=Event_Overflow;
+
+        return true;
+       }
+
+     if( event.mask&(IN_DELETE_SELF|IN_MOVE_SELF|IN_IGNORED|IN_UNMOUNT) )
+       {
+        ret.type=Event_Lost;
+
+        return true;
+       }
+
+     if( event.len )
+       {
+        ret.type=Event_Change;
+        ret.name=StrLen(name,strnlen(name,event.len)); // zero padded
+
+        return true;
+       }
+    }
+ }
+
+} // namespace Sys
+} // namespace CCore
+
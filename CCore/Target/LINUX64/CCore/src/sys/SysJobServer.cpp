@@ -0,0 +1,241 @@
+/* SysJobServer.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysJobServer.h>
+
+#include <CCore/inc/CharProp.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysJobServer */
+
+namespace Private_SysJobServer {
+
+/* functions */
+
+bool ParseFd(StrLen &str,int &ret)
+ {
+  if( !str || charDecValue(*str)<0 ) return false;
+
+  int val=0;
+
+  for(int dig; +str && (dig=charDecValue(*str))>=0 ;++str)
+    {
+     if( val>100000 ) return false;
+
+     val=10*val+dig;
+    }
+
+  ret=val;
+
+  return true;
+ }
+
+bool ParseFds(StrLen str,int &rfd,int &wfd) // "<read fd>,<write fd>"
+ {
+  if( !ParseFd(str,rfd) || !str || *str!=',' ) return false;
+
+  ++str;
+
+  return ParseFd(str,wfd) && !str ;
+ }
+
+bool CheckFd(int fd)
+ {
+  return fcntl(fd,F_GETFD)!=-1;
+ }
+
+int OpenPrivate(int fd) // the pipe description is shared with other processes, a private non-blocking one is used for read
+ {
+  char path[64];
+
+  std::snprintf(path,sizeof path,"/proc/self/fd/%d",fd);
+
+  return open(path,O_RDONLY|O_NONBLOCK|O_CLOEXEC);
+ }
+
+} // namespace Private_SysJobServer
+
+using namespace Private_SysJobServer;
+
+/* struct JobServer */
+
+ErrorType JobServer::openClient(StrLen auth_) noexcept
+ {
+  read_fd=-1;
+  write_fd=-1;
+  pipe_fd=-1;
+  auth_len=0;
+
+  if( auth_.len>MaxAuthLen ) return Error_TooLong;
+
+  auth_.copyTo(auth);
+
+  auth_len=auth_.len;
+
+  StrLen fifo_prefix="fifo:"_c;
+
+  if( auth_.hasPrefix(fifo_prefix) )
+    {
+     char path[MaxPathLen+1];
+
+     StrLen file=auth_.part(fifo_prefix.len);
+
+     if( file.len>MaxPathLen ) return Error_TooLong;
+
+     file.copyTo(path);
+
+     path[file.len]=0;
+
+     // the fifo has its own file description, so O_NONBLOCK does not affect other processes
+
+     int fd=open(path,O_RDWR|O_NONBLOCK|O_CLOEXEC);
+
+     if( fd==-1 ) return NonNullError();
+
+     read_fd=fd;
+     write_fd=fd;
+
+     return NoError;
+    }
+
+  int rfd,wfd;
+
+  if( ParseFds(auth_,rfd,wfd) )
+    {
+     if( !CheckFd(rfd) || !CheckFd(wfd) ) return ErrorType(EBADF);
+
+     int fd=OpenPrivate(rfd);
+
+     if( fd==-1 ) return NonNullError();
+
+     read_fd=fd;
+     write_fd=wfd;
+
+     return NoError;
+    }
+
+  return ErrorType(EINVAL);
+ }
+
+ErrorType JobServer::openServer(ulen token_count) noexcept
+ {
+  read_fd=-1;
+  write_fd=-1;
+  pipe_fd=-1;
+  auth_len=0;
+
+  int fds[2];
+
+  if( pipe(fds)==-1 ) return NonNullError(); // inherited by children
+
+  int fd=OpenPrivate(fds[0]);
+
+  if( fd==-1 )
+    {
+     ErrorType error=NonNullError();
+
+     ::close(fds[0]);
+     ::close(fds[1]);
+
+     return error;
+    }
+
+  // a blocked write must not happen, the pipe buffer has at least 4096 bytes
+
+  for(token_count=Min<ulen>(token_count,4096); token_count ;token_count--)
+    {
+     char token='+';
+
+     if( write(fds[1],&token,1)!=1 ) break;
+    }
+
+  read_fd=fd;
+  write_fd=fds[1];
+  pipe_fd=fds[0];
+
+  std::snprintf(auth,sizeof auth,"%d,%d",fds[0],fds[1]);
+
+  auth_len=std::strlen(auth);
+
+  return NoError;
+ }
+
+ErrorType JobServer::close() noexcept
+ {
+  ErrorType error=NoError;
+
+  if( read_fd!=-1 && ::close(read_fd)==-1 ) error=NonNullError();
+
+  // the inherited descriptors of the client are not closed
+
+  if( pipe_fd!=-1 )
+    {
+     if( ::close(pipe_fd)==-1 && !error ) error=NonNullError();
+
+     if( ::close(write_fd)==-1 && !error ) error=NonNullError();
+    }
+
+  read_fd=-1;
+  write_fd=-1;
+  pipe_fd=-1;
+
+  return error;
+ }
+
+auto JobServer::tryTake() noexcept -> TakeResult
+ {
+  char token;
+
+  for(;;)
+    {
+     ssize_t ret=read(read_fd,&token,1);
+
+     if( ret==1 ) return {token,true,NoError};
+
+     if( ret==0 ) return {0,false,ErrorType(EPIPE)};
+
+     if( errno==EINTR ) continue;
+
+     if( errno==EAGAIN || errno==EWOULDBLOCK ) return {0,false,NoError};
+
+     return {0,false,NonNullError()};
+    }
+ }
+
+ErrorType JobServer::give(char token) noexcept
+ {
+  for(;;)
+    {
+     ssize_t ret=write(write_fd,&token,1);
+
+     if( ret==1 ) return NoError;
+
+     if( ret==-1 && errno==EINTR ) continue;
+
+     return NonNullError();
+    }
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,376 @@
+/* SysLocalSocket.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysLocalSocket.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <cstring>
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysLocalSocket */
+
+namespace Private_SysLocalSocket {
+
+/* functions */
+
+bool SetAddress(struct sockaddr_un &addr,StrLen path)
+ {
+  std::memset(&addr,0,sizeof addr);
+
+  addr.sun_family=AF_UNIX;
+
+  if( !path || path.len>=sizeof addr.sun_path ) return false;
+
+  path.copyTo(addr.sun_path);
+
+  return true;
+ }
+
+ErrorType ReadAll(int fd,void *ptr,ulen len)
+ {
+  char *buf=static_cast<char *>(ptr);
+
+  while( len )
+    {
+     ssize_t ret=::read(fd,buf,len);
+
+     if( ret<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        return NonNullError();
+       }
+
+     if( ret==0 ) return ErrorType(EPIPE);
+
+     buf+=ret;
+     len-=ulen(ret);
+    }
+
+  return NoError;
+ }
+
+ErrorType WriteAll(int fd,const void *ptr,ulen len)
+ {
+  const char *buf=static_cast<const char *>(ptr);
+
+  while( len )
+    {
+     ssize_t ret=::send(fd,buf,len,MSG_NOSIGNAL);
+
+     if( ret<0 )
+       {
+        if( errno==EINTR ) continue;
+
+        return NonNullError();
+       }
+
+     buf+=ret;
+     len-=ulen(ret);
+    }
+
+  return NoError;
+ }
+
+} // namespace Private_SysLocalSocket
+
+using namespace Private_SysLocalSocket;
+
+/* struct LocalServer::Request */
+
+ErrorType LocalServer::Request::accept(LocalServer *server) noexcept
+ {
+  fd=-1;
+  out_fd[0]=-1;
+  out_fd[1]=-1;
+  save_fd[0]=-1;
+  save_fd[1]=-1;
+  len=0;
+
+  for(;;)
+    {
+     fd=accept4(server->fd,0,0,SOCK_CLOEXEC);
+
+     if( fd!=-1 ) break;
+
+     if( errno!=EINTR ) return NonNullError();
+    }
+
+  // header and descriptors
+
+  uint32 text_len;
+
+  struct iovec iov;
+
+  iov.iov_base=&text_len;
+  iov.iov_len=sizeof text_len;
+
+  alignas(struct cmsghdr) char control[CMSG_SPACE(2*sizeof (int))];
+
+  struct msghdr msg;
+
+  std::memset(&msg,0,sizeof msg);
+
+  msg.msg_iov=&iov;
+  msg.msg_iovlen=1;
+  msg.msg_control=control;
+  msg.msg_controllen=sizeof control;
+
+  ssize_t ret=recvmsg(fd,&msg,MSG_CMSG_CLOEXEC|MSG_WAITALL);
+
+  if( ret<0 ) return NonNullError();
+
+  for(struct cmsghdr *cmsg=CMSG_FIRSTHDR(&msg); cmsg ;cmsg=CMSG_NXTHDR(&msg,cmsg))
+    {
+     if( cmsg->cmsg_level==SOL_SOCKET && cmsg->cmsg_type==SCM_RIGHTS && cmsg->cmsg_len==CMSG_LEN(2*sizeof (int)) )
+       {
+        std::memcpy(out_fd,CMSG_DATA(cmsg),2*sizeof (int));
+       }
+    }
+
+  if( ulen(ret)!=sizeof text_len || out_fd[0]==-1 || out_fd[1]==-1 ) return ErrorType(EPROTO);
+
+  if( text_len>MaxTextLen ) return Error_TooLong;
+
+  len=text_len;
+
+  return ReadAll(fd,text,len);
+ }
+
+ErrorType LocalServer::Request::redirect() noexcept
+ {
+  for(int i=0; i<2 ;i++)
+    {
+     save_fd[i]=fcntl(i+1,F_DUPFD_CLOEXEC,3);
+
+     if( save_fd[i]==-1 )
+       {
+        ErrorType error=NonNullError();
+
+        restore();
+
+        return error;
+       }
+
+     if( dup2(out_fd[i],i+1)==-1 )
+       {
+        ErrorType error=NonNullError();
+
+        ::close(save_fd[i]);
+
+        save_fd[i]=-1;
+
+        restore();
+
+        return error;
+       }
+    }
+
+  return NoError;
+ }
+
+void LocalServer::Request::restore() noexcept
+ {
+  for(int i=0; i<2 ;i++)
+    {
+     if( save_fd[i]!=-1 )
+       {
+        dup2(save_fd[i],i+1);
+
+        ::close(save_fd[i]);
+
+        save_fd[i]=-1;
+       }
+    }
+ }
+
+ErrorType LocalServer::Request::reply(int status) noexcept
+ {
+  sint32 value=status;
+
+  return WriteAll(fd,&value,sizeof value);
+ }
+
+void LocalServer::Request::close() noexcept
+ {
+  restore();
+
+  for(int i=0; i<2 ;i++) if( out_fd[i]!=-1 ) ::close(out_fd[i]);
+
+  if( fd!=-1 ) ::close(fd);
+
+  fd=-1;
+  out_fd[0]=-1;
+  out_fd[1]=-1;
+ }
+
+/* struct LocalServer */
+
+ErrorType LocalServer::open(StrLen path) noexcept
+ {
+  fd=-1;
+
+  struct sockaddr_un addr;
+
+  if( !SetAddress(addr,path) ) return Error_TooLong;
+
+  // the client output may be a closed pipe
+
+  signal(SIGPIPE,SIG_IGN);
+
+  int sock=socket(AF_UNIX,SOCK_STREAM|SOCK_CLOEXEC,0);
+
+  if( sock==-1 ) return NonNullError();
+
+  unlink(addr.sun_path);
+
+  mode_t mask=umask(0077);
+
+  int ret=bind(sock,reinterpret_cast<struct sockaddr *>(&addr),sizeof addr);
+
+  umask(mask);
+
+  if( ret==-1 || listen(sock,16)==-1 )
+    {
+     ErrorType error=NonNullError();
+
+     ::close(sock);
+
+     return error;
+    }
+
+  fd=sock;
+
+  return NoError;
+ }
+
+void LocalServer::close() noexcept
+ {
+  if( fd!=-1 )
+    {
+     ::close(fd);
+
+     fd=-1;
+    }
+ }
+
+/* struct LocalClient */
+
+ErrorType LocalClient::open(StrLen path) noexcept
+ {
+  fd=-1;
+
+  struct sockaddr_un addr;
+
+  if( !SetAddress(addr,path) ) return Error_TooLong;
+
+  int sock=socket(AF_UNIX,SOCK_STREAM|SOCK_CLOEXEC,0);
+
+  if( sock==-1 ) return NonNullError();
+
+  if( connect(sock,reinterpret_cast<struct sockaddr *>(&addr),sizeof addr)==-1 )
+    {
+     ErrorType error=NonNullError();
+
+     ::close(sock);
+
+     return error;
+    }
+
+  fd=sock;
+
+  return NoError;
+ }
+
+void LocalClient::close() noexcept
+ {
+  if( fd!=-1 )
+    {
+     ::close(fd);
+
+     fd=-1;
+    }
+ }
+
+ErrorType LocalClient::send(StrLen text) noexcept
+ {
+  if( text.len>LocalServer::MaxTextLen ) return Error_TooLong;
+
+  uint32 text_len=uint32(text.len);
+
+  struct iovec iov;
+
+  iov.iov_base=&text_len;
+  iov.iov_len=sizeof text_len;
+
+  alignas(struct cmsghdr) char control[CMSG_SPACE(2*sizeof (int))];
+
+  std::memset(control,0,sizeof control);
+
+  struct msghdr msg;
+
+  std::memset(&msg,0,sizeof msg);
+
+  msg.msg_iov=&iov;
+  msg.msg_iovlen=1;
+  msg.msg_control=control;
+  msg.msg_controllen=sizeof control;
+
+  struct cmsghdr *cmsg=CMSG_FIRSTHDR(&msg);
+
+  cmsg->cmsg_level=SOL_SOCKET;
+  cmsg->cmsg_type=SCM_RIGHTS;
+  cmsg->cmsg_len=CMSG_LEN(2*sizeof (int));
+
+  int fds[2]={1,2};
+
+  std::memcpy(CMSG_DATA(cmsg),fds,sizeof fds);
+
+  for(;;)
+    {
+     ssize_t ret=sendmsg(fd,&msg,MSG_NOSIGNAL);
+
+     if( ret==sizeof text_len ) break;
+
+     if( ret<0 && errno==EINTR ) continue;
+
+     if( ret<0 ) return NonNullError();
+
+     return ErrorType(EPROTO);
+    }
+
+  return WriteAll(fd,text.ptr,text.len);
+ }
+
+auto LocalClient::wait() noexcept -> WaitResult
+ {
+  sint32 value;
+
+  if( ErrorType error=ReadAll(fd,&value,sizeof value) ) return {0,error};
+
+  return {value,NoError};
+ }
+
+} // namespace Sys
+} // namespace CCore
+
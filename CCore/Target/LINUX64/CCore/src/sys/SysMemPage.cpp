@@ -0,0 +1,67 @@
+/* SysMemPage.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysMemPage.h>
+#include <CCore/inc/sys/SysAbort.h>
+
+#include <sys/mman.h>
+
+namespace CCore {
+namespace Sys {
+
+/* functions */
+
+void * MemPageAlloc(ulen num_pages) noexcept
+ {
+  if( num_pages>MaxULen/MemPageLen ) return 0;
+
+  ulen len=num_pages*MemPageLen;
+
+  void *ret=mmap(0,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+
+  if( ret==MAP_FAILED ) return 0;
+
+  return ret;
+ }
+
+void MemPageFree(void *mem,ulen num_pages) noexcept
+ {
+  AbortIf( munmap(mem,num_pages*MemPageLen)!=0 ,"CCore::Sys::MemPageFree()");
+ }
+
+bool MemPageExtend(void *mem,ulen num_pages,ulen plus_num_pages) noexcept
+ {
+  if( plus_num_pages>MaxULen/MemPageLen-num_pages ) return false;
+
+  ulen len=num_pages*MemPageLen;
+  ulen new_len=len+plus_num_pages*MemPageLen;
+
+  return mremap(mem,len,new_len,0)!=MAP_FAILED;
+ }
+
+ulen MemPageShrink(void *mem,ulen num_pages,ulen minus_num_pages) noexcept
+ {
+  if( minus_num_pages>=num_pages ) return 0;
+
+  char *tail=static_cast<char *>(mem)+(num_pages-minus_num_pages)*MemPageLen;
+
+  if( munmap(tail,minus_num_pages*MemPageLen)!=0 ) return 0;
+
+  return minus_num_pages;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,127 @@
+/* SysProp.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysProp.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/sysinfo.h>
+
+namespace CCore {
+namespace Sys {
+
+/* GetPlanInitNode_...() */
+
+namespace Private_SysProp {
+
+/* struct Info */
+
+struct Info
+ {
+  unsigned cpu_count;
+
+  unsigned spin_count;
+
+  Info()
+   {
+    long count=sysconf(_SC_NPROCESSORS_ONLN);
+
+    cpu_count=(count>0)?unsigned(count):1u;
+
+    spin_count=(cpu_count>1)?1000:0;
+   }
+
+  static const char * GetTag() { return "SysProp"; }
+ };
+
+PlanInitObject<Info> Object CCORE_INITPRI_1 ;
+
+} // namespace Private_SysProp
+
+using namespace Private_SysProp;
+
+PlanInitNode * GetPlanInitNode_SysProp() { return &Object; }
+
+/* functions */
+
+unsigned GetCpuCount() noexcept
+ {
+  return Object->cpu_count;
+ }
+
+unsigned GetSpinCount() noexcept
+ {
+  return Object->spin_count;
+ }
+
+static uint64 MemAvailable() noexcept // KByte , 0 if not found
+ {
+  int fd=open("/proc/meminfo",O_RDONLY|O_CLOEXEC);
+
+  if( fd<0 ) return 0;
+
+  char buf[4096];
+
+  ssize_t len=read(fd,buf,sizeof buf);
+
+  close(fd);
+
+  if( len<=0 ) return 0;
+
+  StrLen text(buf,ulen(len));
+  StrLen key="MemAvailable:"_c;
+
+  for(; text.len>key.len ;++text)
+    {
+     if( text.ptr[0]==key.ptr[0] && key.equal(text.prefix(key.len)) )
+       {
+        text+=key.len;
+
+        for(; +text && *text==' ' ;++text);
+
+        uint64 ret=0;
+
+        for(; +text && *text>='0' && *text<='9' ;++text) ret=10*ret+uint64(*text-'0');
+
+        return ret;
+       }
+    }
+
+  return 0;
+ }
+
+SysLoad GetSysLoad() noexcept
+ {
+  SysLoad ret;
+
+  struct sysinfo info;
+
+  if( sysinfo(&info)!=0 ) return ret;
+
+  ret.load=unsigned( (uint64(info.loads[0])*100)>>SI_LOAD_SHIFT );
+
+  if( uint64 avail=MemAvailable() )
+    ret.avail_mem=avail<<10;
+  else
+    ret.avail_mem=(uint64(info.freeram)+uint64(info.bufferram))*info.mem_unit;
+
+  ret.ok=true;
+
+  return ret;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
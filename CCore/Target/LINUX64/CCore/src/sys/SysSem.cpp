@@ -0,0 +1,153 @@
+/* SysSem.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysSem.h>
+
+#include <CCore/inc/sys/SysAbort.h>
+
+#include <errno.h>
+#include <semaphore.h>
+#include <time.h>
+#include <climits>
+#include <cstdlib>
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysSem */
+
+namespace Private_SysSem {
+
+inline sem_t * ToSem(Sem::Type handle) { return static_cast<sem_t *>(handle); }
+
+struct timespec Deadline(MSec timeout)
+ {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  ts.tv_sec+=+timeout/1000;
+  ts.tv_nsec+=long(+timeout%1000)*1'000'000;
+
+  if( ts.tv_nsec>=1'000'000'000 )
+    {
+     ts.tv_sec++;
+     ts.tv_nsec-=1'000'000'000;
+    }
+
+  return ts;
+ }
+
+} // namespace Private_SysSem
+
+using namespace Private_SysSem;
+
+/* struct Sem */
+
+auto Sem::Create(ulen count) noexcept -> CreateType
+ {
+  CreateType ret;
+
+  sem_t *sem=static_cast<sem_t *>( std::malloc(sizeof (sem_t)) );
+
+  if( !sem )
+    {
+     ret.handle=0;
+     ret.error=ErrorType(ENOMEM);
+
+     return ret;
+    }
+
+  if( count>SEM_VALUE_MAX || sem_init(sem,0,unsigned(count))!=0 )
+    {
+     ret.error=( count>SEM_VALUE_MAX )? ErrorType(EINVAL) : NonNullError() ;
+
+     std::free(sem);
+
+     ret.handle=0;
+
+     return ret;
+    }
+
+  ret.handle=sem;
+  ret.error=NoError;
+
+  return ret;
+ }
+
+void Sem::Destroy(Type handle) noexcept
+ {
+  AbortIf( sem_destroy(ToSem(handle))!=0 ,"CCore::Sys::Sem::Destroy()");
+
+  std::free(handle);
+ }
+
+void Sem::Give(Type handle) noexcept
+ {
+  AbortIf( sem_post(ToSem(handle))!=0 ,"CCore::Sys::Sem::Give()");
+ }
+
+void Sem::GiveMany(Type handle,ulen count) noexcept
+ {
+  for(; count ;count--) Give(handle);
+ }
+
+bool Sem::TryTake(Type handle) noexcept
+ {
+  for(;;)
+    {
+     if( sem_trywait(ToSem(handle))==0 ) return true;
+
+     int error=errno;
+
+     if( error==EINTR ) continue;
+
+     AbortIf( error!=EAGAIN ,"CCore::Sys::Sem::TryTake()");
+
+     return false;
+    }
+ }
+
+void Sem::Take(Type handle) noexcept
+ {
+  for(;;)
+    {
+     if( sem_wait(ToSem(handle))==0 ) return;
+
+     AbortIf( errno!=EINTR ,"CCore::Sys::Sem::Take()");
+    }
+ }
+
+bool Sem::Take(Type handle,MSec timeout) noexcept
+ {
+  struct timespec deadline=Deadline(timeout);
+
+  for(;;)
+    {
+     if( sem_clockwait(ToSem(handle),CLOCK_MONOTONIC,&deadline)==0 ) return true;
+
+     int error=errno;
+
+     if( error==EINTR ) continue;
+
+     AbortIf( error!=ETIMEDOUT ,"CCore::Sys::Sem::Take()");
+
+     return false;
+    }
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,684 @@
+/* SysSpawn.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysSpawn.h>
+
+#include <CCore/inc/sys/SysEnv.h>
+
+#include <CCore/inc/MemBase.h>
+#include <CCore/inc/Exception.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <cstring>
+
+extern char **environ;
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysSpawn */
+
+namespace Private_SysSpawn {
+
+/* functions */
+
+int ToStatus(int status)
+ {
+  if( WIFEXITED(status) ) return WEXITSTATUS(status);
+
+  if( WIFSIGNALED(status) ) return 128+WTERMSIG(status);
+
+  return 1000;
+ }
+
+uint64 ToUSec(const struct timeval &tv)
+ {
+  return uint64(tv.tv_sec)*1'000'000+uint64(tv.tv_usec);
+ }
+
+SpawnUsage ToUsage(const struct rusage &ru)
+ {
+  SpawnUsage ret;
+
+  ret.user_time=ToUSec(ru.ru_utime);
+  ret.sys_time=ToUSec(ru.ru_stime);
+  ret.max_rss=uint64(ru.ru_maxrss);
+  ret.read_bytes=uint64(ru.ru_inblock)*512; // block i/o
+  ret.write_bytes=uint64(ru.ru_oublock)*512;
+
+  return ret;
+ }
+
+struct WaitPidResult
+ {
+  int status;
+  ErrorType error;
+  SpawnUsage usage;
+ };
+
+WaitPidResult WaitPid(pid_t pid)
+ {
+  int status;
+  struct rusage ru;
+
+  for(;;)
+    {
+     if( wait4(pid,&status,0,&ru)==pid ) return {ToStatus(status),NoError,ToUsage(ru)};
+
+     if( errno!=EINTR ) return {1000,NonNullError(),{}};
+    }
+ }
+
+int PidFdOpen(pid_t pid)
+ {
+#ifdef SYS_pidfd_open
+
+  return (int)syscall(SYS_pidfd_open,pid,0);
+
+#else
+
+  (void)pid;
+
+  errno=ENOSYS;
+
+  return -1;
+
+#endif
+ }
+
+void ReserveFileLimit(ulen reserve) // each child holds a pidfd
+ {
+  struct rlimit lim;
+
+  if( getrlimit(RLIMIT_NOFILE,&lim)!=0 ) return;
+
+  rlim_t need=rlim_t(reserve)+256;
+
+  if( lim.rlim_cur>=need ) return;
+
+  lim.rlim_cur=( lim.rlim_max==RLIM_INFINITY || lim.rlim_max>=need )? need : lim.rlim_max ;
+
+  setrlimit(RLIMIT_NOFILE,&lim);
+ }
+
+} // namespace Private_SysSpawn
+
+using namespace Private_SysSpawn;
+
+/* GetShell() */
+
+StrLen GetShell(char buf[MaxPathLen+1]) noexcept
+ {
+  TryGetEnv<32,MaxPathLen> tryget(Range(buf,MaxPathLen),"UNIXSHELL");
+
+  if( tryget.ok ) return tryget.str;
+
+  return "/bin/sh"_c;
+ }
+
+/* struct GetEnviron */
+
+ErrorType GetEnviron::init() noexcept
+ {
+  ptr=environ;
+
+  return NoError;
+ }
+
+ErrorType GetEnviron::exit() noexcept
+ {
+  return NoError;
+ }
+
+auto GetEnviron::next() noexcept -> NextResult
+ {
+  if( ptr && *ptr )
+    {
+     const char *str=*(ptr++);
+
+     return {StrLen(str,std::strlen(str)),NoError,false};
+    }
+  else
+    {
+     return {Empty,NoError,true};
+    }
+ }
+
+/* struct SpawnChild */
+
+ErrorType SpawnChild::spawn(char *wdir,char *path,char **argv,char **envp,bool capture) noexcept
+ {
+  output=-1;
+
+  int pipe_fd[2];
+
+  if( capture )
+    {
+     // both ends are close-on-exec, so other children do not hold the pipe
+
+     if( pipe2(pipe_fd,O_CLOEXEC)!=0 ) return NonNullError();
+    }
+
+  posix_spawn_file_actions_t actions;
+
+  auto close_pipe = [&] ()
+                        {
+                         if( capture )
+                           {
+                            close(pipe_fd[0]);
+                            close(pipe_fd[1]);
+                           }
+                        } ;
+
+  if( int error=posix_spawn_file_actions_init(&actions) )
+    {
+     close_pipe();
+
+     return ErrorType(error);
+    }
+
+  int error=0;
+
+  if( wdir && *wdir ) error=posix_spawn_file_actions_addchdir_np(&actions,wdir);
+
+  if( capture && !error )
+    {
+     error=posix_spawn_file_actions_adddup2(&actions,pipe_fd[1],1);
+
+     if( !error ) error=posix_spawn_file_actions_adddup2(&actions,pipe_fd[1],2);
+    }
+
+  if( !error ) error=posix_spawnp(&handle,path,&actions,0,argv,envp);
+
+  posix_spawn_file_actions_destroy(&actions);
+
+  if( error )
+    {
+     close_pipe();
+
+     return ErrorType(error);
+    }
+
+  if( capture )
+    {
+     close(pipe_fd[1]);
+
+     output=pipe_fd[0];
+    }
+
+  return NoError;
+ }
+
+auto SpawnChild::wait() noexcept -> WaitResult
+ {
+  if( output>=0 ) // not drained here
+    {
+     close(output);
+
+     output=-1;
+    }
+
+  auto result=WaitPid(handle);
+
+  return {result.status,result.error,result.usage};
+ }
+
+/* class SpawnWaitList::Engine */
+
+class SpawnWaitList::Engine : public MemBase_nocopy
+ {
+   struct Rec : MemBase_nocopy
+    {
+     pid_t pid;
+     int pidfd;
+     int outfd;
+     void *arg;
+
+     bool is_polled; // no pidfd
+     bool exited;
+     int status;
+     ErrorType error;
+     SpawnUsage usage;
+
+     // output buffer, kept for the next child
+
+     char *buf = 0 ;
+     ulen len = 0 ;
+     ulen cap = 0 ;
+
+     Rec *prev;
+     Rec *next;
+
+     ~Rec() { MemFree(buf); }
+
+     void append(const char *ptr,ulen delta) // drops the output on no memory
+      {
+       if( delta>cap-len )
+         {
+          ulen new_cap=Max<ulen>(Max(cap*2,len+delta),4_KByte);
+
+          char *new_buf=static_cast<char *>(TryMemAlloc(new_cap));
+
+          if( !new_buf ) return;
+
+          if( len ) std::memcpy(new_buf,buf,len);
+
+          MemFree(buf);
+
+          buf=new_buf;
+          cap=new_cap;
+         }
+
+       std::memcpy(buf+len,ptr,delta);
+
+       len+=delta;
+      }
+
+     void setExit(int status_,ErrorType error_,SpawnUsage usage_)
+      {
+       exited=true;
+       status=status_;
+       error=error_;
+       usage=usage_;
+      }
+
+     bool isDone() const { return exited && outfd<0 ; }
+    };
+
+   struct List
+    {
+     Rec *first = 0 ;
+
+     void ins(Rec *rec)
+      {
+       rec->prev=0;
+       rec->next=first;
+
+       if( first ) first->prev=rec;
+
+       first=rec;
+      }
+
+     void del(Rec *rec)
+      {
+       if( rec->prev ) rec->prev->next=rec->next; else first=rec->next;
+
+       if( rec->next ) rec->next->prev=rec->prev;
+      }
+
+     void destroy()
+      {
+       while( Rec *rec=first )
+         {
+          first=rec->next;
+
+          if( rec->pidfd>=0 ) close(rec->pidfd);
+
+          if( rec->outfd>=0 ) close(rec->outfd);
+
+          delete rec;
+         }
+      }
+    };
+
+   int epoll_fd;
+   int post_fd[2]; // job completions from other threads
+
+   struct PostMsg
+    {
+     void *arg;
+     int status;
+    };
+
+   List active;  // children watched by pidfd
+   List polled;  // children without pidfd, checked by WNOHANG
+   List avail;
+
+   ulen count = 0 ;
+
+   static constexpr int PollTimeout = 10 ; // msec
+
+   static constexpr ulen ReadLen = 16_KByte ;
+
+   static constexpr uint64 OutputTag = 1 ; // epoll data : Rec address , the low bit marks the output pipe
+
+  private:
+
+   Rec * alloc()
+    {
+     if( Rec *rec=avail.first )
+       {
+        avail.del(rec);
+
+        return rec;
+       }
+
+     return new Rec;
+    }
+
+   void closeFd(int &fd)
+    {
+     if( fd>=0 )
+       {
+        epoll_ctl(epoll_fd,EPOLL_CTL_DEL,fd,0);
+
+        close(fd);
+
+        fd=-1;
+       }
+    }
+
+   WaitResult finish(Rec *rec)
+    {
+     if( rec->is_polled ) polled.del(rec); else active.del(rec);
+
+     closeFd(rec->pidfd);
+
+     avail.ins(rec);
+
+     count--;
+
+     return {rec->arg,rec->status,rec->error,rec->usage,Range_const(rec->buf,rec->len)};
+    }
+
+   bool exited(Rec *rec)
+    {
+     auto result=WaitPid(rec->pid);
+
+     rec->setExit(result.status,result.error,result.usage);
+
+     closeFd(rec->pidfd);
+
+     return rec->isDone();
+    }
+
+   bool drain(Rec *rec) // one read per event
+    {
+     char temp[ReadLen];
+
+     for(;;)
+       {
+        ssize_t result=read(rec->outfd,temp,ReadLen);
+
+        if( result>0 )
+          {
+           rec->append(temp,ulen(result));
+
+           return false;
+          }
+
+        if( result<0 && errno==EINTR ) continue;
+
+        break;
+       }
+
+     closeFd(rec->outfd); // eof or error
+
+     return rec->isDone();
+    }
+
+   bool tryPolled(WaitResult &ret)
+    {
+     for(Rec *rec=polled.first; rec ;rec=rec->next)
+       {
+        if( rec->exited ) continue;
+
+        int status;
+        struct rusage ru;
+
+        pid_t result=wait4(rec->pid,&status,WNOHANG,&ru);
+
+        if( result==rec->pid )
+          {
+           rec->setExit(ToStatus(status),NoError,ToUsage(ru));
+          }
+        else if( result<0 && errno!=EINTR )
+          {
+           rec->setExit(1000,NonNullError(),{});
+          }
+
+        if( rec->isDone() )
+          {
+           ret=finish(rec);
+
+           return true;
+          }
+       }
+
+     return false;
+    }
+
+   bool watch(int fd,uint64 data)
+    {
+     struct epoll_event event;
+
+     event.events=EPOLLIN;
+     event.data.u64=data;
+
+     return epoll_ctl(epoll_fd,EPOLL_CTL_ADD,fd,&event)==0;
+    }
+
+  public:
+
+   explicit Engine(ulen reserve)
+    {
+     epoll_fd=epoll_create1(EPOLL_CLOEXEC);
+
+     if( epoll_fd<0 ) GuardNoMem(0);
+
+     if( pipe2(post_fd,O_CLOEXEC)!=0 )
+       {
+        close(epoll_fd);
+
+        GuardNoMem(0);
+       }
+
+     if( !watch(post_fd[0],0) ) // Rec addresses are not null
+       {
+        close(post_fd[0]);
+        close(post_fd[1]);
+        close(epoll_fd);
+
+        GuardNoMem(0);
+       }
+
+     ReserveFileLimit(reserve);
+
+     for(; reserve ;reserve--) avail.ins(new Rec);
+    }
+
+   ~Engine()
+    {
+     active.destroy();
+     polled.destroy();
+     avail.destroy();
+
+     close(post_fd[0]);
+     close(post_fd[1]);
+
+     close(epoll_fd);
+    }
+
+   bool notEmpty() const { return count; }
+
+   void add(pid_t pid,int outfd,void *arg)
+    {
+     Rec *rec=alloc();
+
+     rec->pid=pid;
+     rec->arg=arg;
+     rec->exited=false;
+     rec->len=0;
+     rec->pidfd=PidFdOpen(pid);
+     rec->outfd=outfd;
+
+     if( rec->pidfd>=0 && !watch(rec->pidfd,uint64( uptr(rec) )) )
+       {
+        close(rec->pidfd);
+
+        rec->pidfd=-1;
+       }
+
+     if( outfd>=0 && !watch(outfd,uint64( uptr(rec) )|OutputTag) )
+       {
+        close(outfd);
+
+        rec->outfd=-1;
+       }
+
+     rec->is_polled=( rec->pidfd<0 );
+
+     if( rec->is_polled ) polled.ins(rec); else active.ins(rec);
+
+     count++;
+    }
+
+   void addJob()
+    {
+     count++;
+    }
+
+   ErrorType post(void *arg,int status)
+    {
+     PostMsg msg{arg,status};
+
+     for(;;)
+       {
+        if( write(post_fd[1],&msg,sizeof msg)==(ssize_t)sizeof msg ) return NoError; // atomic, less than PIPE_BUF
+
+        if( errno!=EINTR ) return NonNullError();
+       }
+    }
+
+   WaitResult getPost()
+    {
+     PostMsg msg;
+
+     for(;;)
+       {
+        if( read(post_fd[0],&msg,sizeof msg)==(ssize_t)sizeof msg ) break;
+
+        if( errno!=EINTR ) return {0,0,NonNullError(),{},{}};
+       }
+
+     count--;
+
+     return {msg.arg,msg.status,NoError,{},{}};
+    }
+
+   WaitResult wait()
+    {
+     if( !count ) return {0,0,NoError,{}};
+
+     for(;;)
+       {
+        WaitResult ret;
+
+        if( tryPolled(ret) ) return ret;
+
+        int timeout = polled.first? PollTimeout : -1 ;
+
+        struct epoll_event event;
+
+        int result=epoll_wait(epoll_fd,&event,1,timeout);
+
+        if( result>0 )
+          {
+           if( !event.data.u64 ) return getPost();
+
+           Rec *rec=reinterpret_cast<Rec *>( uptr( event.data.u64&~OutputTag ) );
+
+           bool done = (event.data.u64&OutputTag)? drain(rec) : exited(rec) ;
+
+           if( done ) return finish(rec);
+          }
+
+        if( result<0 && errno!=EINTR ) return {0,0,NonNullError(),{}};
+       }
+    }
+ };
+
+/* struct SpawnWaitList */
+
+ErrorType SpawnWaitList::init(ulen reserve) noexcept
+ {
+  SilentReportException report;
+
+  try
+    {
+     engine=new Engine(reserve);
+
+     return NoError;
+    }
+  catch(CatchType)
+    {
+     return ErrorType(ENOMEM);
+    }
+ }
+
+ErrorType SpawnWaitList::exit() noexcept
+ {
+  bool nok=engine->notEmpty();
+
+  delete Replace_null(engine);
+
+  return nok?Error_Running:NoError;
+ }
+
+ErrorType SpawnWaitList::add(SpawnChild *spawn,void *arg) noexcept
+ {
+  SilentReportException report;
+
+  try
+    {
+     engine->add(spawn->handle,spawn->output,arg);
+
+     spawn->output=-1; // owned by the engine
+
+     return NoError;
+    }
+  catch(CatchType)
+    {
+     return ErrorType(ENOMEM);
+    }
+ }
+
+ErrorType SpawnWaitList::addJob() noexcept
+ {
+  engine->addJob();
+
+  return NoError;
+ }
+
+ErrorType SpawnWaitList::post(void *arg,int status) noexcept
+ {
+  return engine->post(arg,status);
+ }
+
+auto SpawnWaitList::wait() noexcept -> WaitResult
+ {
+  return engine->wait();
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,79 @@
+/* SysTask.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysTask.h>
+#include <CCore/inc/sys/SysAtomic.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace CCore {
+namespace Sys {
+
+/* assert */
+
+static_assert( MaxUInt<TaskIdType> <= MaxUInt<Atomic::Type> ,"CCore::Sys::TaskIdType : too long type");
+
+/* functions */
+
+void YieldTask() noexcept { sched_yield(); }
+
+void SleepTask(MSec time) noexcept
+ {
+  struct timespec ts;
+
+  ts.tv_sec=+time/1000;
+  ts.tv_nsec=long(+time%1000)*1'000'000;
+
+  while( nanosleep(&ts,&ts)!=0 );
+ }
+
+TaskIdType GetTaskId() noexcept { return TaskIdType( gettid() ); }
+
+/* struct TaskEntry */
+
+void * TaskEntry::Entry(void *obj_)
+ {
+  TaskEntry *obj=static_cast<TaskEntry *>(obj_);
+
+  obj->entry(obj);
+
+  return 0;
+ }
+
+ErrorType TaskEntry::create() noexcept
+ {
+  pthread_attr_t attr;
+
+  if( pthread_attr_init(&attr) ) return Error_Task;
+
+  pthread_attr_setdetachstate(&attr,PTHREAD_CREATE_DETACHED);
+
+  pthread_t tid;
+
+  int error=pthread_create(&tid,&attr,Entry,this);
+
+  pthread_attr_destroy(&attr);
+
+  if( error ) return Error_Task;
+
+  return NoError;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,59 @@
+/* SysTime.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysTime.h>
+
+#include <time.h>
+
+namespace CCore {
+namespace Sys {
+
+/* functions */
+
+MSecTimeType GetMSecTime() noexcept
+ {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return MSecTimeType( uint64(ts.tv_sec)*1000+uint64(ts.tv_nsec)/1'000'000 );
+ }
+
+SecTimeType GetSecTime() noexcept
+ {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME,&ts);
+
+  return SecTimeType( ts.tv_sec );
+ }
+
+ClockTimeType GetClockTime() noexcept
+ {
+  return __builtin_ia32_rdtsc();
+ }
+
+USecTimeType GetUSecTime() noexcept
+ {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+
+  return USecTimeType( uint64(ts.tv_sec)*1'000'000+uint64(ts.tv_nsec)/1'000 );
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,64 @@
+/* SysTlsSlot.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/LINUX64
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysTlsSlot.h>
+#include <CCore/inc/sys/SysAbort.h>
+
+#include <pthread.h>
+
+namespace CCore {
+namespace Sys {
+
+/* assert */
+
+static_assert( std::is_same_v<TlsSlot::Type,pthread_key_t> ,"CCore::Sys::TlsSlot::Type : must be pthread_key_t");
+
+/* struct TlsSlot */
+
+auto TlsSlot::Alloc() noexcept -> AllocType
+ {
+  TlsSlot::AllocType ret;
+
+  if( int error=pthread_key_create(&ret.index,0) )
+    {
+     ret.index=0;
+     ret.error=ErrorType(error);
+    }
+  else
+    {
+     ret.error=NoError;
+    }
+
+  return ret;
+ }
+
+void TlsSlot::Free(Type index) noexcept
+ {
+  AbortIf( pthread_key_delete(index)!=0 ,"CCore::Sys::TlsSlot::Free()");
+ }
+
+void * TlsSlot::Get(Type index) noexcept
+ {
+  return pthread_getspecific(index);
+ }
+
+void TlsSlot::Set(Type index,void *value) noexcept
+ {
+  AbortIf( pthread_setspecific(index,value)!=0 ,"CCore::Sys::TlsSlot::Set()");
+ }
+
+} // namespace Sys
+} // namespace CCore
+
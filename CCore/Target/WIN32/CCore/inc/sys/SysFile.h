@@ -77,6 +77,10 @@ struct File
 
   static FileError SetPos(Type handle,FileOpenFlags oflags,FilePosType pos) noexcept;
 
+  static FileError Reserve(Type handle,FileOpenFlags oflags,FilePosType len) noexcept;
+
+  static PosResult CopyFrom(Type handle,FileOpenFlags oflags,Type src_handle,FileOpenFlags src_oflags) noexcept;
+
   // public
 
   FileError open(StrLen file_name,FileOpenFlags oflags_)
@@ -110,6 +114,10 @@ struct File
   PosResult getPos() { return GetPos(handle,oflags); }
 
   FileError setPos(FilePosType pos) { return SetPos(handle,oflags,pos); }
+
+  FileError reserve(FilePosType len) { return Reserve(handle,oflags,len); } // space for len bytes from the current position, the file length is not changed
+
+  PosResult copyFrom(File &src) { return CopyFrom(handle,oflags,src.handle,src.oflags); } // appends src from its position to the end, returns the length
  };
 
 /* struct AltFile */
@@ -45,6 +45,12 @@ struct FileSystem
     FileError error;
    };
 
+  struct StatusResult
+   {
+    FileStatus status;
+    FileError error;
+   };
+
   struct PathOfResult
    {
     StrLen path;
@@ -75,6 +81,24 @@ struct FileSystem
     bool next() noexcept;
    };
 
+  struct DirHandle
+   {
+    // private data
+
+    char dir_name[MaxPathLen+1]; // with the trailing separator
+    ulen len;
+
+    // public
+
+    FileError error;
+
+    void init(FileSystem *fs,StrLen dir_name) noexcept;
+
+    void exit() noexcept;
+
+    StatusResult getFileStatus(StrLen file_name) noexcept; // file name only
+   };
+
   // public
 
   static FileError init() noexcept;
@@ -85,6 +109,8 @@ struct FileSystem
 
   static CmpTimeResult getFileUpdateTime(StrLen path) noexcept;
 
+  static StatusResult getFileStatus(StrLen path) noexcept;
+
   static FileError createFile(StrLen file_name) noexcept;
 
   static FileError deleteFile(StrLen file_name) noexcept;
@@ -95,6 +121,12 @@ struct FileSystem
 
   static FileError rename(StrLen old_path,StrLen new_path,bool allow_overwrite) noexcept;
 
+  static FileError copyFile(StrLen src_file,StrLen dst_file) noexcept; // dst_file is overwritten
+
+  static FileError touchFile(StrLen file_name) noexcept; // created, if does not exist
+
+  static FileError linkFile(StrLen src_file,StrLen dst_file,bool sym) noexcept; // dst_file is replaced
+
   static FileError remove(StrLen path) noexcept;
 
   static FileError exec(StrLen dir,StrLen program,StrLen arg) noexcept;
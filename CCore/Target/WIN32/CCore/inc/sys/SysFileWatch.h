@@ -0,0 +1,85 @@
+/* SysFileWatch.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/WIN32
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysFileWatch_h
+#define CCore_inc_sys_SysFileWatch_h
+
+#include <CCore/inc/GenFile.h>
+
+#include <CCore/inc/sys/SysError.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct FileWatch;
+
+/* struct FileWatch */
+
+ //
+ // Directory change notifications, not supported on this target
+ //
+
+struct FileWatch
+ {
+  // public
+
+  enum EventType
+   {
+    Event_Change,   // the named entry of the dir is changed
+    Event_Lost,     // the dir is removed or moved, the watch is dropped
+    Event_Overflow  // some events are lost
+   };
+
+  struct Event
+   {
+    int wd;
+    EventType type;
+    StrLen name; // Event_Change only
+   };
+
+  struct AddResult
+   {
+    int wd;
+    ErrorType error;
+   };
+
+  struct ReadResult
+   {
+    ulen len; // 0 if there are no events
+    ErrorType error;
+   };
+
+  static constexpr ulen MinBufLen = 4_KByte ;
+
+  // public
+
+  ErrorType open() noexcept;
+
+  void close() noexcept;
+
+  AddResult add(StrLen dir_name) noexcept;
+
+  ReadResult read(PtrLen<char> buf) noexcept; // non-blocking, buf.len >= MinBufLen
+
+  static bool Next(PtrLen<const char> &data,Event &ret) noexcept; // parses the next event from the read data
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
@@ -0,0 +1,75 @@
+/* SysJobServer.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/WIN32
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef CCore_inc_sys_SysJobServer_h
+#define CCore_inc_sys_SysJobServer_h
+
+#include <CCore/inc/sys/SysError.h>
+
+namespace CCore {
+namespace Sys {
+
+/* classes */
+
+struct JobServer;
+
+/* struct JobServer */
+
+ //
+ // GNU make jobserver : the named semaphore counts job tokens
+ //
+
+struct JobServer
+ {
+  // public
+
+  static constexpr ulen MaxAuthLen = 127 ;
+
+  struct TakeResult
+   {
+    char token;
+    bool ok;
+    ErrorType error;
+   };
+
+  // private data
+
+  using Type = void * ;
+
+  Type handle;
+
+  char auth[MaxAuthLen+1];
+  ulen auth_len;
+
+  // public
+
+  ErrorType openClient(StrLen auth) noexcept; // the semaphore name
+
+  ErrorType openServer(ulen token_count) noexcept;
+
+  ErrorType close() noexcept;
+
+  StrLen getAuth() const noexcept { return StrLen(auth,auth_len); }
+
+  TakeResult tryTake() noexcept; // non-blocking
+
+  ErrorType give(char token) noexcept;
+ };
+
+} // namespace Sys
+} // namespace CCore
+
+#endif
+
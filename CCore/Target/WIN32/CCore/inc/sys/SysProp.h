@@ -25,12 +25,23 @@ namespace Sys {
 
 PlanInitNode * GetPlanInitNode_SysProp();
 
+/* struct SysLoad */
+
+struct SysLoad
+ {
+  unsigned load = 0 ; // 1 minute load average * 100 , 0 if not available
+  uint64 avail_mem = 0 ; // bytes
+  bool ok = false ;
+ };
+
 /* functions */
 
 unsigned GetCpuCount() noexcept;
 
 unsigned GetSpinCount() noexcept;
 
+SysLoad GetSysLoad() noexcept;
+
 } // namespace Sys
 } // namespace CCore
 
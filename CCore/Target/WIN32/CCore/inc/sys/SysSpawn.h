@@ -32,6 +32,8 @@ StrLen GetShell(char buf[MaxPathLen+1]) noexcept;
 
 struct GetEnviron;
 
+struct SpawnUsage;
+
 struct SpawnChild;
 
 struct SpawnWaitList;
@@ -79,6 +81,17 @@ struct GetEnviron
   NextResult next() noexcept;
  };
 
+/* struct SpawnUsage */
+
+struct SpawnUsage
+ {
+  uint64 user_time = 0 ; // usec
+  uint64 sys_time = 0 ; // usec
+  uint64 max_rss = 0 ; // KByte
+  uint64 read_bytes = 0 ;
+  uint64 write_bytes = 0 ;
+ };
+
 /* struct SpawnChild */
 
 struct SpawnChild
@@ -89,6 +102,7 @@ struct SpawnChild
    {
     int status;
     ErrorType error;
+    SpawnUsage usage;
    };
 
   // private data
@@ -99,7 +113,9 @@ struct SpawnChild
 
   // public
 
-  ErrorType spawn(char *wdir,char *path,char **argv,char **envp) noexcept; // path!=0 , argv!=0 , envp!=0
+  ErrorType spawn(char *wdir,char *path,char **argv,char **envp,bool capture=false) noexcept; // path!=0 , argv!=0 , envp!=0
+
+  // capture : not supported, the child uses the console
 
   WaitResult wait() noexcept;
  };
@@ -115,6 +131,8 @@ struct SpawnWaitList
     void *arg;
     int status;
     ErrorType error;
+    SpawnUsage usage;
+    PtrLen<const char> output; // always empty
    };
 
   // private data
@@ -131,6 +149,10 @@ struct SpawnWaitList
 
   ErrorType add(SpawnChild *spawn,void *arg) noexcept; // makes spawn reusable
 
+  ErrorType addJob() noexcept; // a job, completed by post()
+
+  ErrorType post(void *arg,int status) noexcept; // thread-safe, completes a job
+
   WaitResult wait() noexcept;
  };
 
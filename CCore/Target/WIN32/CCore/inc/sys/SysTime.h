@@ -29,6 +29,8 @@ using SecTimeType   = uint32 ; // unsigned integral type
 
 using ClockTimeType = uint64 ; // unsigned integral type
 
+using USecTimeType  = uint64 ; // unsigned integral type
+
 /* functions */
 
 MSecTimeType GetMSecTime() noexcept;
@@ -37,6 +39,8 @@ SecTimeType GetSecTime() noexcept;
 
 ClockTimeType GetClockTime() noexcept;
 
+USecTimeType GetUSecTime() noexcept;
+
 } // namespace Sys
 } // namespace CCore
 
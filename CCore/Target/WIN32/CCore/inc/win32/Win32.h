@@ -91,6 +91,7 @@ enum ErrorCodes
   ErrorWriteFault       =  29,
   ErrorReadFault        =  30,
   ErrorHandleEOF        =  38,
+  ErrorNotSupported     =  50,
   ErrorFileExists       =  80,
   ErrorInvalidParameter =  87,
   ErrorBrokenPipe       = 109,
@@ -209,6 +210,25 @@ struct SystemInfo
 
 void WIN32_API GetSystemInfo(SystemInfo *info);
 
+/* struct MemoryStatusEx */
+
+struct MemoryStatusEx
+ {
+  unsigned len;
+  unsigned memory_load;
+  unsigned long long total_phys;
+  unsigned long long avail_phys;
+  unsigned long long total_page_file;
+  unsigned long long avail_page_file;
+  unsigned long long total_virtual;
+  unsigned long long avail_virtual;
+  unsigned long long avail_extended_virtual;
+ };
+
+/* GlobalMemoryStatusEx() */
+
+bool_t WIN32_API GlobalMemoryStatusEx(MemoryStatusEx *status);
+
 /*--------------------------------------------------------------------------------------*/
 /* Time functions                                                                       */
 /*--------------------------------------------------------------------------------------*/
@@ -346,6 +366,69 @@ options_t WIN32_API WaitForMultipleObjects(ulen_t hcount,
                                            bool_t wait_all,
                                            timeout_t timeout);
 
+/*--------------------------------------------------------------------------------------*/
+/* Thread pool wait constants                                                           */
+/*--------------------------------------------------------------------------------------*/
+
+/* enum WaitCallbackFlags */
+
+enum WaitCallbackFlags
+ {
+  WaitCallback_InWaitThread = 0x0004,
+  WaitCallback_OnlyOnce     = 0x0008
+ };
+
+/* const WaitBlock */
+
+inline constexpr handle_t WaitBlock = -1 ;
+
+/*--------------------------------------------------------------------------------------*/
+/* Thread pool wait functions                                                           */
+/*--------------------------------------------------------------------------------------*/
+
+/* type wait_callback_t */
+
+using wait_callback_t = void (WIN32_CALLTYPE *)(void_ptr arg,unsigned char timer_fired) ;
+
+/* RegisterWaitForSingleObject() */
+
+bool_t WIN32_API RegisterWaitForSingleObject(handle_t *h_wait,
+                                             handle_t h_any,
+                                             wait_callback_t callback,
+                                             void_ptr arg,
+                                             timeout_t timeout,
+                                             flags_t flags);
+
+/* UnregisterWaitEx() */
+
+bool_t WIN32_API UnregisterWaitEx(handle_t h_wait, handle_t h_complete_event);
+
+/*--------------------------------------------------------------------------------------*/
+/* Completion port functions                                                            */
+/*--------------------------------------------------------------------------------------*/
+
+/* CreateIoCompletionPort() */
+
+handle_t WIN32_API CreateIoCompletionPort(handle_t h_file,
+                                          handle_t h_port,
+                                          ulen_t key,
+                                          ulen_t thread_count);
+
+/* PostQueuedCompletionStatus() */
+
+bool_t WIN32_API PostQueuedCompletionStatus(handle_t h_port,
+                                            ulen_t len,
+                                            ulen_t key,
+                                            Overlapped *olap);
+
+/* GetQueuedCompletionStatus() */
+
+bool_t WIN32_API GetQueuedCompletionStatus(handle_t h_port,
+                                           ulen_t *ret_len,
+                                           ulen_t *ret_key,
+                                           Overlapped **ret_olap,
+                                           timeout_t timeout);
+
 /*--------------------------------------------------------------------------------------*/
 /* DLL functions                                                                        */
 /*--------------------------------------------------------------------------------------*/
@@ -411,6 +494,14 @@ bool_t WIN32_API SetEvent(handle_t h_event);
 
 inline constexpr sem_count_t MaxSemaphoreCount = 0x7FFF'FFFF ;
 
+/* enum SemaphoreAccessFlags */
+
+enum SemaphoreAccessFlags
+ {
+  SemaphoreModifyState = 0x0002,
+  SemaphoreSynchronize = 0x0010'0000
+ };
+
 /*--------------------------------------------------------------------------------------*/
 /* Semaphore functions                                                                  */
 /*--------------------------------------------------------------------------------------*/
@@ -422,6 +513,12 @@ handle_t WIN32_API CreateSemaphoreW(SecurityAttributes *,
                                     sem_count_t max_count,
                                     const wchar *object_name);
 
+/* OpenSemaphoreW() */
+
+handle_t WIN32_API OpenSemaphoreW(flags_t access_flags,
+                                  bool_t inherit,
+                                  const wchar *object_name);
+
 /* ReleaseSemaphore() */
 
 bool_t WIN32_API ReleaseSemaphore(handle_t h_sem,
@@ -506,6 +603,34 @@ struct ProcessInfo
   numid_t thread_id;
  };
 
+/* struct IoCounters */
+
+struct IoCounters
+ {
+  unsigned long long read_ops;
+  unsigned long long write_ops;
+  unsigned long long other_ops;
+  unsigned long long read_bytes;
+  unsigned long long write_bytes;
+  unsigned long long other_bytes;
+ };
+
+/* struct ProcessMemoryCounters */
+
+struct ProcessMemoryCounters
+ {
+  unsigned cb;
+  unsigned page_fault_count;
+  ulen_t peak_working_set_size;
+  ulen_t working_set_size;
+  ulen_t quota_peak_paged_pool_usage;
+  ulen_t quota_paged_pool_usage;
+  ulen_t quota_peak_nonpaged_pool_usage;
+  ulen_t quota_nonpaged_pool_usage;
+  ulen_t pagefile_usage;
+  ulen_t peak_pagefile_usage;
+ };
+
 /*--------------------------------------------------------------------------------------*/
 /* Process functions                                                                    */
 /*--------------------------------------------------------------------------------------*/
@@ -532,6 +657,10 @@ void WIN32_API GetStartupInfoW(StartupInfo *info);
 
 handle_t WIN32_API GetCurrentProcess(void);
 
+/* GetCurrentProcessId() */
+
+numid_t WIN32_API GetCurrentProcessId(void);
+
 /* GetCurrentThread() */
 
 handle_t WIN32_API GetCurrentThread(void);
@@ -565,6 +694,22 @@ bool_t WIN32_API CreateProcessW(const wchar *program,
 
 bool_t WIN32_API GetExitCodeProcess(handle_t h_process, unsigned *exit_code);
 
+/* GetProcessTimes() */
+
+bool_t WIN32_API GetProcessTimes(handle_t h_process,
+                                 file_time_t *creation_time,
+                                 file_time_t *exit_time,
+                                 file_time_t *kernel_time,
+                                 file_time_t *user_time);
+
+/* GetProcessIoCounters() */
+
+bool_t WIN32_API GetProcessIoCounters(handle_t h_process, IoCounters *counters);
+
+/* K32GetProcessMemoryInfo() */
+
+bool_t WIN32_API K32GetProcessMemoryInfo(handle_t h_process, ProcessMemoryCounters *counters, unsigned cb);
+
 /* SetThreadPriority() */
 
 bool_t WIN32_API SetThreadPriority(handle_t h_thread, options_t priority);
@@ -813,6 +958,14 @@ enum MoveFileExFlags
   MoveFileEx_AllowOverwrite = 0x0001
  };
 
+/* enum SymbolicLinkFlags */
+
+enum SymbolicLinkFlags
+ {
+  SymbolicLink_Directory          = 0x0001,
+  SymbolicLink_AllowUnprivileged  = 0x0002
+ };
+
 /*--------------------------------------------------------------------------------------*/
 /* File structures                                                                      */
 /*--------------------------------------------------------------------------------------*/
@@ -919,10 +1072,35 @@ struct FindFileData
   wchar alt_file_name[14];
  };
 
+/* struct FileInformation */
+
+struct FileInformation
+ {
+  flags_t attr;
+
+  FileTime creation_time;
+  FileTime last_access_time;
+  FileTime last_write_time;
+
+  unsigned volume_serial;
+
+  ulen_t file_len_hi;
+  ulen_t file_len_lo;
+
+  unsigned link_count;
+
+  unsigned file_index_hi;
+  unsigned file_index_lo;
+ };
+
 /*--------------------------------------------------------------------------------------*/
 /* File system functions                                                                */
 /*--------------------------------------------------------------------------------------*/
 
+/* GetFileInformationByHandle() */
+
+bool_t WIN32_API GetFileInformationByHandle(handle_t h_file, FileInformation *info);
+
 /* GetFileTime() */
 
 bool_t WIN32_API GetFileTime(handle_t h_file, FileTime *creation_time,
@@ -933,6 +1111,10 @@ bool_t WIN32_API GetFileTime(handle_t h_file, FileTime *creation_time,
 
 flags_t WIN32_API GetFileAttributesW(const wchar *path);
 
+/* CopyFileW() */
+
+bool_t WIN32_API CopyFileW(const wchar *src_path, const wchar *dst_path, bool_t fail_if_exists);
+
 /* DeleteFileW() */
 
 bool_t WIN32_API DeleteFileW(const wchar *path);
@@ -949,6 +1131,20 @@ bool_t WIN32_API RemoveDirectoryW(const wchar *path);
 
 bool_t WIN32_API MoveFileExW(const wchar *old_path, const wchar *new_path, flags_t flags);
 
+/* SetFileTime() */
+
+bool_t WIN32_API SetFileTime(handle_t h_file, const FileTime *creation_time,
+                                              const FileTime *last_access_time,
+                                              const FileTime *last_write_time);
+
+/* CreateHardLinkW() */
+
+bool_t WIN32_API CreateHardLinkW(const wchar *new_path, const wchar *old_path, SecurityAttributes *);
+
+/* CreateSymbolicLinkW() */
+
+unsigned char WIN32_API CreateSymbolicLinkW(const wchar *new_path, const wchar *old_path, flags_t flags); // BOOLEAN
+
 /* FindFirstFileW() */
 
 handle_t WIN32_API FindFirstFileW(const wchar *path, FindFileData *find_data);
@@ -18,6 +18,7 @@
 #include <CCore/inc/sys/SysAbort.h>
 
 #include <CCore/inc/Exception.h>
+#include <CCore/inc/MemBase.h>
 
 namespace CCore {
 namespace Sys {
@@ -390,6 +391,69 @@ FileError File::SetPos(Type handle,FileOpenFlags oflags,FilePosType pos) noexcep
     }
  }
 
+FileError File::Reserve(Type,FileOpenFlags oflags,FilePosType) noexcept // not used, the space is allocated by writes
+ {
+  if( !(oflags&Open_Write) ) return FileError_NoMethod;
+
+  return FileError_Ok;
+ }
+
+auto File::CopyFrom(Type handle,FileOpenFlags oflags,Type src_handle,FileOpenFlags src_oflags) noexcept -> PosResult // streaming copy
+ {
+  if( !(oflags&Open_Write) || !(src_oflags&Open_Read) ) return {0,FileError_NoMethod};
+
+  const ulen BufLen = 1_MByte ;
+
+  uint8 small[64_KByte];
+
+  uint8 *buf=static_cast<uint8 *>(TryMemAlloc(BufLen));
+  ulen buf_len=BufLen;
+
+  if( !buf )
+    {
+     buf=small;
+     buf_len=sizeof small;
+    }
+
+  PosResult ret{0,FileError_Ok};
+
+  for(;;)
+    {
+     IOResult rd=Read(src_handle,src_oflags,buf,buf_len);
+
+     if( rd.error )
+       {
+        ret.error=rd.error;
+
+        break;
+       }
+
+     if( !rd.len ) break;
+
+     IOResult wr=Write(handle,oflags,buf,rd.len);
+
+     ret.pos+=wr.len;
+
+     if( wr.error )
+       {
+        ret.error=wr.error;
+
+        break;
+       }
+
+     if( wr.len!=rd.len )
+       {
+        ret.error=FileError_WriteLenMismatch;
+
+        break;
+       }
+    }
+
+  if( buf!=small ) MemFree(buf);
+
+  return ret;
+ }
+
 /* struct AltFile */
 
 auto AltFile::Open(StrLen file_name_,FileOpenFlags oflags) noexcept -> OpenType
@@ -37,6 +37,45 @@ StrLen Dotcard(StrLen dir)
   return PathIsBase(dir)? "."_c : ""_c ;
  }
 
+/* GetFileStatus() */
+
+void GetFileStatus(const FileName &path,FileSystem::StatusResult &ret)
+ {
+  WinNN::flags_t access_flags = 0 ;
+
+  WinNN::flags_t share_flags = WinNN::ShareRead|WinNN::ShareWrite ;
+
+  WinNN::options_t creation_options = WinNN::OpenExisting ;
+
+  WinNN::flags_t file_flags = WinNN::FileBackupSemantic ;
+
+  WinNN::handle_t h_file=WinNN::CreateFileW(path,access_flags,share_flags,0,creation_options,file_flags,0);
+
+  if( h_file==WinNN::InvalidFileHandle )
+    {
+     ret.error=FileError_Ok;
+    }
+  else
+    {
+     WinNN::FileInformation info;
+
+     if( WinNN::GetFileInformationByHandle(h_file,&info) )
+       {
+        ret.status.type=(info.attr&WinNN::FileAttributes_Directory)?FileType_dir:FileType_file;
+        ret.status.time=ToCmpFileTime(info.last_write_time);
+        ret.status.len=info.file_len_lo|(FilePosType(info.file_len_hi)<<32);
+        ret.status.id=info.file_index_lo|(uint64(info.file_index_hi)<<32);
+        ret.error=FileError_Ok;
+       }
+     else
+       {
+        ret.error=MakeError(FileError_OpFault);
+       }
+
+     WinNN::CloseHandle(h_file);
+    }
+ }
+
 /* class EmptyDirEngine */
 
 class EmptyDirEngine : NoCopy
@@ -306,6 +345,55 @@ bool FileSystem::DirCursor::next() noexcept
   return false;
  }
 
+/* struct FileSystem::DirHandle */
+
+void FileSystem::DirHandle::init(FileSystem *,StrLen dir_name_) noexcept
+ {
+  if( !dir_name_ )
+    {
+     error=FileError_BadName;
+
+     return;
+    }
+
+  StrLen sep=PathIsBase(dir_name_)? ""_c : "/"_c ;
+
+  if( dir_name_.len>MaxPathLen-sep.len )
+    {
+     error=FileError_TooLongPath;
+
+     return;
+    }
+
+  dir_name_.copyTo(dir_name);
+  sep.copyTo(dir_name+dir_name_.len);
+
+  len=dir_name_.len+sep.len;
+
+  error=FileError_Ok;
+ }
+
+void FileSystem::DirHandle::exit() noexcept
+ {
+ }
+
+auto FileSystem::DirHandle::getFileStatus(StrLen file_name) noexcept -> StatusResult
+ {
+  StatusResult ret;
+  FileName path;
+
+  if( auto fe=path.prepare(StrLen(dir_name,len),file_name) )
+    {
+     ret.error=fe;
+    }
+  else
+    {
+     GetFileStatus(path,ret);
+    }
+
+  return ret;
+ }
+
 /* struct FileSystem */
 
 FileError FileSystem::init() noexcept
@@ -396,6 +484,23 @@ auto FileSystem::getFileUpdateTime(StrLen path_) noexcept -> CmpTimeResult
   return ret;
  }
 
+auto FileSystem::getFileStatus(StrLen path_) noexcept -> StatusResult
+ {
+  StatusResult ret;
+  FileName path;
+
+  if( auto fe=path.prepare(path_) )
+    {
+     ret.error=fe;
+    }
+  else
+    {
+     GetFileStatus(path,ret);
+    }
+
+  return ret;
+ }
+
 FileError FileSystem::createFile(StrLen file_name) noexcept
  {
   FileName path;
@@ -465,6 +570,70 @@ FileError FileSystem::rename(StrLen old_path_,StrLen new_path_,bool allow_overwr
   return MakeErrorIf(FileError_OpFault, !WinNN::MoveFileExW(old_path,new_path,flags) );
  }
 
+FileError FileSystem::copyFile(StrLen src_file_,StrLen dst_file_) noexcept
+ {
+  FileName src_file;
+
+  if( auto fe=src_file.prepare(src_file_) ) return fe;
+
+  FileName dst_file;
+
+  if( auto fe=dst_file.prepare(dst_file_) ) return fe;
+
+  return MakeErrorIf(FileError_OpFault, !WinNN::CopyFileW(src_file,dst_file,false) );
+ }
+
+FileError FileSystem::touchFile(StrLen file_name) noexcept
+ {
+  FileName path;
+
+  if( auto fe=path.prepare(file_name) ) return fe;
+
+  WinNN::flags_t access_flags = WinNN::AccessWrite ;
+
+  WinNN::flags_t share_flags = WinNN::ShareRead|WinNN::ShareWrite ;
+
+  WinNN::options_t creation_options = WinNN::OpenAlways ;
+
+  WinNN::flags_t file_flags = WinNN::FileAttributeNormal ;
+
+  WinNN::handle_t h_file = WinNN::CreateFileW(path,access_flags,share_flags,0,creation_options,file_flags,0) ;
+
+  if( h_file==WinNN::InvalidFileHandle ) return MakeError(FileError_OpenFault);
+
+  WinNN::file_time_t now;
+
+  WinNN::GetSystemTimeAsFileTime(&now);
+
+  WinNN::FileTime time{unsigned(now),unsigned(now>>32)};
+
+  FileError fe=MakeErrorIf(FileError_OpFault, !WinNN::SetFileTime(h_file,0,0,&time) );
+
+  WinNN::CloseHandle(h_file);
+
+  return fe;
+ }
+
+FileError FileSystem::linkFile(StrLen src_file_,StrLen dst_file_,bool sym) noexcept
+ {
+  FileName src_file;
+
+  if( auto fe=src_file.prepare(src_file_) ) return fe;
+
+  FileName dst_file;
+
+  if( auto fe=dst_file.prepare(dst_file_) ) return fe;
+
+  if( !WinNN::DeleteFileW(dst_file) && WinNN::GetLastError()!=WinNN::ErrorFileNotFound ) return MakeError(FileError_OpFault);
+
+  if( sym )
+    {
+     return MakeErrorIf(FileError_OpFault, !WinNN::CreateSymbolicLinkW(dst_file,src_file,WinNN::SymbolicLink_AllowUnprivileged) );
+    }
+
+  return MakeErrorIf(FileError_OpFault, !WinNN::CreateHardLinkW(dst_file,src_file,0) );
+ }
+
 FileError FileSystem::remove(StrLen path_) noexcept
  {
   FileName path;
@@ -0,0 +1,51 @@
+/* SysFileWatch.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/WIN32
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysFileWatch.h>
+
+#include <CCore/inc/win32/Win32.h>
+
+namespace CCore {
+namespace Sys {
+
+/* struct FileWatch */
+
+ErrorType FileWatch::open() noexcept
+ {
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+void FileWatch::close() noexcept
+ {
+ }
+
+auto FileWatch::add(StrLen) noexcept -> AddResult
+ {
+  return {-1,ErrorType(WinNN::ErrorNotSupported)};
+ }
+
+auto FileWatch::read(PtrLen<char>) noexcept -> ReadResult
+ {
+  return {0,ErrorType(WinNN::ErrorNotSupported)};
+ }
+
+bool FileWatch::Next(PtrLen<const char> &,Event &) noexcept
+ {
+  return false;
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,115 @@
+/* SysJobServer.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/WIN32
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysJobServer.h>
+
+#include <CCore/inc/win32/Win32.h>
+
+#include <CCore/inc/Print.h>
+
+namespace CCore {
+namespace Sys {
+
+/* namespace Private_SysJobServer */
+
+namespace Private_SysJobServer {
+
+/* struct SemName */
+
+struct SemName
+ {
+  WinNN::wchar buf[JobServer::MaxAuthLen+1];
+
+  explicit SemName(StrLen name) // name.len<=MaxAuthLen , ASCII
+   {
+    for(ulen i=0; i<name.len ;i++) buf[i]=WinNN::wchar( (unsigned char)name[i] );
+
+    buf[name.len]=0;
+   }
+
+  operator const WinNN::wchar * () const { return buf; }
+ };
+
+} // namespace Private_SysJobServer
+
+using namespace Private_SysJobServer;
+
+/* struct JobServer */
+
+ErrorType JobServer::openClient(StrLen auth_) noexcept
+ {
+  handle=0;
+  auth_len=0;
+
+  if( auth_.len>MaxAuthLen ) return Error_TooLong;
+
+  auth_.copyTo(auth);
+
+  auth_len=auth_.len;
+
+  SemName name(auth_);
+
+  handle=WinNN::OpenSemaphoreW(WinNN::SemaphoreModifyState|WinNN::SemaphoreSynchronize,false,name);
+
+  return ErrorIf( !handle );
+ }
+
+ErrorType JobServer::openServer(ulen token_count) noexcept
+ {
+  handle=0;
+  auth_len=0;
+
+  PrintBuf out(Range(auth));
+
+  Printf(out,"vmake_jobserver_#;",WinNN::GetCurrentProcessId());
+
+  auth_len=out.close().len;
+
+  SemName name(getAuth());
+
+  WinNN::sem_count_t count=(WinNN::sem_count_t)Min<ulen>(token_count,WinNN::MaxSemaphoreCount);
+
+  handle=WinNN::CreateSemaphoreW(0,count,WinNN::MaxSemaphoreCount,name);
+
+  return ErrorIf( !handle );
+ }
+
+ErrorType JobServer::close() noexcept
+ {
+  if( !handle ) return NoError;
+
+  return ErrorIf( !WinNN::CloseHandle(Replace_null(handle)) );
+ }
+
+auto JobServer::tryTake() noexcept -> TakeResult
+ {
+  switch( WinNN::WaitForSingleObject(handle,WinNN::TryTimeout) )
+    {
+     case WinNN::WaitObject_0 : return {'+',true,NoError};
+
+     case WinNN::WaitTimeout : return {0,false,NoError};
+
+     default: return {0,false,NonNullError()};
+    }
+ }
+
+ErrorType JobServer::give(char) noexcept
+ {
+  return ErrorIf( !WinNN::ReleaseSemaphore(handle,1,0) );
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -0,0 +1,84 @@
+/* SysLocalSocket.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: CCore 4.01
+//
+//  Tag: Target/WIN32
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2020 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <CCore/inc/sys/SysLocalSocket.h>
+
+#include <CCore/inc/win32/Win32.h>
+
+namespace CCore {
+namespace Sys {
+
+/* struct LocalServer::Request */
+
+ErrorType LocalServer::Request::accept(LocalServer *) noexcept
+ {
+  len=0;
+
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+ErrorType LocalServer::Request::redirect() noexcept
+ {
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+void LocalServer::Request::restore() noexcept
+ {
+ }
+
+ErrorType LocalServer::Request::reply(int) noexcept
+ {
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+void LocalServer::Request::close() noexcept
+ {
+ }
+
+/* struct LocalServer */
+
+ErrorType LocalServer::open(StrLen) noexcept
+ {
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+void LocalServer::close() noexcept
+ {
+ }
+
+/* struct LocalClient */
+
+ErrorType LocalClient::open(StrLen) noexcept
+ {
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+void LocalClient::close() noexcept
+ {
+ }
+
+ErrorType LocalClient::send(StrLen) noexcept
+ {
+  return ErrorType(WinNN::ErrorNotSupported);
+ }
+
+auto LocalClient::wait() noexcept -> WaitResult
+ {
+  return {0,ErrorType(WinNN::ErrorNotSupported)};
+ }
+
+} // namespace Sys
+} // namespace CCore
+
@@ -63,6 +63,23 @@ unsigned GetSpinCount() noexcept
   return Object->spin_count;
  }
 
+SysLoad GetSysLoad() noexcept
+ {
+  SysLoad ret;
+
+  WinNN::MemoryStatusEx status;
+
+  status.len=sizeof status;
+
+  if( !WinNN::GlobalMemoryStatusEx(&status) ) return ret;
+
+  ret.avail_mem=status.avail_phys; // no load average
+
+  ret.ok=true;
+
+  return ret;
+ }
+
 } // namespace Sys
 } // namespace CCore
 
@@ -19,7 +19,6 @@
 #include <CCore/inc/sys/SysSpawnInternal.h>
 
 #include <CCore/inc/MemBase.h>
-#include <CCore/inc/Array.h>
 #include <CCore/inc/Exception.h>
 
 #include <CCore/inc/win32/Win32.h>
@@ -129,13 +128,42 @@ auto GetEnviron::next() noexcept -> NextResult
 
 /* struct SpawnChild */
 
-ErrorType SpawnChild::spawn(char *wdir,char *path,char **argv,char **envp) noexcept
+ErrorType SpawnChild::spawn(char *wdir,char *path,char **argv,char **envp,bool) noexcept
  {
   ProcessSetup setup(wdir,path,argv,envp);
 
   return setup.create(handle);
  }
 
+static SpawnUsage GetUsage(handle_t handle)
+ {
+  SpawnUsage ret;
+
+  WinNN::file_time_t creation_time,exit_time,kernel_time,user_time;
+
+  if( WinNN::GetProcessTimes(handle,&creation_time,&exit_time,&kernel_time,&user_time) )
+    {
+     ret.user_time=user_time/10;
+     ret.sys_time=kernel_time/10;
+    }
+
+  WinNN::ProcessMemoryCounters mem;
+
+  mem.cb=sizeof mem;
+
+  if( WinNN::K32GetProcessMemoryInfo(handle,&mem,sizeof mem) ) ret.max_rss=mem.peak_working_set_size/1024;
+
+  WinNN::IoCounters io;
+
+  if( WinNN::GetProcessIoCounters(handle,&io) )
+    {
+     ret.read_bytes=io.read_bytes;
+     ret.write_bytes=io.write_bytes;
+    }
+
+  return ret;
+ }
+
 auto SpawnChild::wait() noexcept -> WaitResult
  {
   WaitResult ret;
@@ -156,6 +184,8 @@ auto SpawnChild::wait() noexcept -> WaitResult
           ret.status=1000;
           ret.error=NonNullError();
          }
+
+       ret.usage=GetUsage(handle);
       }
      break;
 
@@ -180,13 +210,75 @@ auto SpawnChild::wait() noexcept -> WaitResult
 
 /* class SpawnWaitList::Engine */
 
+ //
+ // Each child is watched by a thread pool wait, the wait callback posts the child record
+ // to the completion port. There is no limit on the number of children and
+ // the completion dispatch is O(1).
+ //
+
 class SpawnWaitList::Engine : public MemBase_nocopy
  {
-   DynArray<handle_t> list;
-   DynArray<void *> arglist;
+   struct Rec : MemBase_nocopy
+    {
+     handle_t port;
+     handle_t handle;
+     handle_t h_wait;
+     void *arg;
+
+     Rec *prev;
+     Rec *next;
+    };
+
+   struct List
+    {
+     Rec *first = 0 ;
+
+     void ins(Rec *rec)
+      {
+       rec->prev=0;
+       rec->next=first;
+
+       if( first ) first->prev=rec;
+
+       first=rec;
+      }
+
+     void del(Rec *rec)
+      {
+       if( rec->prev ) rec->prev->next=rec->next; else first=rec->next;
+
+       if( rec->next ) rec->next->prev=rec->prev;
+      }
+
+     void destroy(bool unreg)
+      {
+       while( Rec *rec=first )
+         {
+          first=rec->next;
+
+          if( unreg ) WinNN::UnregisterWaitEx(rec->h_wait,WinNN::WaitBlock);
+
+          delete rec;
+         }
+      }
+    };
+
+   handle_t port;
+
+   List active;
+   List avail;
+
+   ulen count = 0 ;
 
   private:
 
+   static void WIN32_CALLTYPE Callback(void *arg,unsigned char)
+    {
+     Rec *rec=static_cast<Rec *>(arg);
+
+     WinNN::PostQueuedCompletionStatus(rec->port,0,reinterpret_cast<WinNN::ulen_t>(rec),0);
+    }
+
    static WaitResult Finish(handle_t handle,void *arg)
     {
      WaitResult ret;
@@ -206,78 +298,117 @@ class SpawnWaitList::Engine : public MemBase_nocopy
         ret.error=NonNullError();
        }
 
+     ret.usage=GetUsage(handle);
+
      WinNN::CloseHandle(handle);
 
      return ret;
     }
 
-   WaitResult finish(ulen ind)
+   WaitResult finish(Rec *rec)
     {
-     auto handle=list[ind];
-     auto arg=arglist[ind];
+     WinNN::UnregisterWaitEx(rec->h_wait,WinNN::WaitBlock);
 
-     ulen last=list.getLen()-1;
+     active.del(rec);
 
-     if( ind<last )
-       {
-        list[ind]=list[last];
-        arglist[ind]=arglist[last];
-       }
+     auto handle=rec->handle;
+     auto arg=rec->arg;
+
+     avail.ins(rec);
 
-     list.shrink_one();
-     arglist.shrink_one();
+     count--;
 
      return Finish(handle,arg);
     }
 
+   Rec * alloc()
+    {
+     if( Rec *rec=avail.first )
+       {
+        avail.del(rec);
+
+        return rec;
+       }
+
+     return new Rec;
+    }
+
   public:
 
-   explicit Engine(ulen reserve) : list(DoReserve,reserve),arglist(DoReserve,reserve) {}
+   explicit Engine(ulen reserve)
+    {
+     port=WinNN::CreateIoCompletionPort(WinNN::InvalidFileHandle,0,0,1);
 
-   ~Engine() {}
+     if( !port ) GuardNoMem(0);
 
-   bool notEmpty() const { return list.notEmpty(); }
+     for(; reserve ;reserve--) avail.ins(new Rec);
+    }
 
-   void add(handle_t handle,void *arg)
+   ~Engine()
     {
-     arglist.reserve(1);
+     active.destroy(true);
+     avail.destroy(false);
 
-     list.append_copy(handle);
-     arglist.append_copy(arg);
+     WinNN::CloseHandle(port);
     }
 
-   WaitResult wait()
+   bool notEmpty() const { return count; }
+
+   ErrorType add(handle_t handle,void *arg)
     {
-     if( list.isEmpty() ) return {0,0,NoError};
+     Rec *rec=alloc();
+
+     rec->port=port;
+     rec->handle=handle;
+     rec->arg=arg;
 
-     auto result=WaitAny(Range(list));
+     if( !WinNN::RegisterWaitForSingleObject(&rec->h_wait,handle,Callback,rec,WinNN::NoTimeout,
+                                             WinNN::WaitCallback_InWaitThread|WinNN::WaitCallback_OnlyOnce) )
+       {
+        ErrorType error=NonNullError();
 
-     if( result.error ) return {0,0,result.error};
+        avail.ins(rec);
 
-     return finish(result.ind);
+        return error;
+       }
+
+     active.ins(rec);
+
+     count++;
+
+     return NoError;
     }
 
-   struct WaitAnyResult
+   void addJob()
     {
-     ulen ind;
-     ErrorType error;
-    };
+     count++;
+    }
 
-   static WaitAnyResult WaitAny(PtrLen<handle_t> list)
+   ErrorType post(void *arg,int status) // key 0 , the status is passed as the length
     {
-     auto result=WinNN::WaitForMultipleObjects(list.len,list.ptr,false,WinNN::NoTimeout);
+     if( !WinNN::PostQueuedCompletionStatus(port,(unsigned)status,0,static_cast<WinNN::Overlapped *>(arg)) ) return NonNullError();
 
-     if( result==WinNN::WaitFailed )
-       {
-        return {0,NonNullError()};
-       }
+     return NoError;
+    }
+
+   WaitResult wait()
+    {
+     if( !count ) return {0,0,NoError,{}};
+
+     WinNN::ulen_t len;
+     WinNN::ulen_t key;
+     WinNN::Overlapped *olap;
+
+     if( !WinNN::GetQueuedCompletionStatus(port,&len,&key,&olap,WinNN::NoTimeout) ) return {0,0,NonNullError(),{}};
 
-     if( result>=WinNN::WaitObject_0 && ulen(result-WinNN::WaitObject_0)<list.len )
+     if( !key )
        {
-        return {ulen(result-WinNN::WaitObject_0),NoError};
+        count--;
+
+        return {static_cast<void *>(olap),(int)len,NoError,{}};
        }
 
-     return {0,Error_Spawn};
+     return finish(reinterpret_cast<Rec *>(key));
     }
  };
 
@@ -314,9 +445,7 @@ ErrorType SpawnWaitList::add(SpawnChild *spawn,void *arg) noexcept
 
   try
     {
-     engine->add(spawn->handle,arg);
-
-     return NoError;
+     return engine->add(spawn->handle,arg);
     }
   catch(CatchType)
     {
@@ -324,6 +453,18 @@ ErrorType SpawnWaitList::add(SpawnChild *spawn,void *arg) noexcept
     }
  }
 
+ErrorType SpawnWaitList::addJob() noexcept
+ {
+  engine->addJob();
+
+  return NoError;
+ }
+
+ErrorType SpawnWaitList::post(void *arg,int status) noexcept
+ {
+  return engine->post(arg,status);
+ }
+
 auto SpawnWaitList::wait() noexcept -> WaitResult
  {
   return engine->wait();
@@ -37,6 +37,15 @@ SecTimeType GetSecTime() noexcept
   return SecTimeType( sys_time/10'000'000-11'644'473'600ull );
  }
 
+USecTimeType GetUSecTime() noexcept
+ {
+  WinNN::file_time_t sys_time;
+
+  WinNN::GetSystemTimeAsFileTime(&sys_time);
+
+  return USecTimeType( sys_time/10 );
+ }
+
 #if 0
 
 struct DoubleUns
@@ -0,0 +1,108 @@
+/* VMakeCache.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeCache_h
+#define App_VMakeCache_h
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/Tree.h>
+#include <CCore/inc/ElementPool.h>
+#include <CCore/inc/FileSystem.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+class ArtifactCache;
+
+/* class ArtifactCache */
+
+ //
+ // <dir>/<key>/<ind> : ind-th dst file of the rule
+ //
+ // <dir>/index : lines <key> <size> <stamp> , the least stamp is evicted first
+ //
+
+class ArtifactCache : NoCopy
+ {
+   struct Node : NoCopy
+    {
+     RBTreeLink<Node,uint64> link;
+
+     uint64 size;
+     uint64 stamp;
+    };
+
+   using TreeAlgo = RBTreeLink<Node,uint64>::Algo<&Node::link,uint64> ;
+
+   FileSystem fs;
+
+   String dir;
+   uint64 max_size;
+
+   ElementPool pool;
+   TreeAlgo::Root root;
+   DynArray<Node *> list;
+
+   uint64 total_size = 0 ;
+   uint64 next_stamp = 1 ;
+
+   ulen hit_count = 0 ;
+   ulen miss_count = 0 ;
+   ulen store_count = 0 ;
+   ulen evict_count = 0 ;
+
+   bool changed = false ;
+
+  private:
+
+   String entryDir(uint64 key) const;
+
+   String entryFile(StrLen entry_dir,ulen ind) const;
+
+   Node * add(uint64 key,uint64 size,uint64 stamp);
+
+   void remove(Node *node);
+
+   void restoreFile(StrLen src,StrLen dst); // hardlink or copy, the dst dir is created
+
+   void load();
+
+   void evict();
+
+   void save();
+
+  public:
+
+   ArtifactCache(StrLen dir,uint64 max_size);
+
+   ~ArtifactCache();
+
+   bool restore(uint64 key,PtrLen<const String> files);
+
+   void store(uint64 key,PtrLen<const String> files);
+
+   void finish(); // evict, save index and print statistics
+ };
+
+} // namespace VMake
+} // namespace App
+
+#endif
@@ -15,9 +15,15 @@
 #define App_VMakeData_h
 
 #include <CCore/inc/Array.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/StrKey.h>
+#include <CCore/inc/Tree.h>
+#include <CCore/inc/ElementPool.h>
 
 #include <CCore/inc/ddl/DDLMapTypes.h>
 
+#include <inc/VMakeTrace.h>
+
 namespace App {
 
 /* using */
@@ -42,27 +48,112 @@ class DataFile;
 class DataFile : NoCopy
  {
    void *mem = 0 ;
+   ulen mem_len = 0 ;
 
    TypeDef::Target *target = 0 ;
 
    DynArray<TypeDef::Rule *> rules;
    DynArray<TypeDef::Dep *> deps;
 
+   DynArray<String> files; // loaded ddl files, the vmake file and included files
+
+   struct TargetNode : NoCopy
+    {
+     RBTreeLink<TargetNode,StrKey> link;
+
+     TypeDef::Target *target;
+    };
+
+   using TreeAlgo = RBTreeLink<TargetNode,StrKey>::Algo<&TargetNode::link,const StrKey &> ;
+
+   ElementPool pool;
+   TreeAlgo::Root root;
+   DynArray<TargetNode *> names;
+
+   Tracer *tracer;
+
+   //
+   // <vm-file>.image
+   //
+   // ImageHeader , ImageFileRec[file_count] , ImageNameRec[name_count] , uint64 table[rule_count+dep_count] , uint64 reloc[reloc_count] , char text[text_len] , uint8 block[block_len]
+   //
+   // block is the mapped data with pointers replaced by block offsets, reloc is the list of pointer positions.
+   // The image is valid, if the vmake file and all included files are not changed.
+   //
+
+   static constexpr uint32 ImageMagic = 0x494D5656 ;
+   static constexpr uint32 ImageVersion = 1 ;
+
+   struct ImageHeader
+    {
+     uint32 magic;
+     uint32 version;
+     uint32 ptr_len;
+     uint32 pad;
+     uint64 sig; // pretext hash
+     uint64 target; // block offset
+     uint64 block_len;
+     uint64 reloc_count;
+     uint64 rule_count;
+     uint64 dep_count;
+     uint64 name_count;
+     uint64 file_count;
+     uint64 text_len;
+    };
+
+   struct ImageFileRec
+    {
+     uint64 time;
+     uint64 len;
+     uint64 id;
+     uint64 name_off;
+     uint64 name_len;
+    };
+
+   struct ImageNameRec
+    {
+     uint64 target; // block offset
+     uint64 name_off;
+     uint64 name_len;
+    };
+
+   class RelocList;
+
   private:
 
    static StrLen Pretext();
 
+   static uint64 PretextSig();
+
+   template <class Func>
+   void load(StrLen file_name,Func func);
+
+   void loadText(StrLen file_name,StrLen target_name,bool named);
+
+   void addName(StrLen name,TypeDef::Target *ptr);
+
+   bool loadImage(StrLen image_name,StrLen file_name); // false, if the image is absent or not valid
+
+   void saveImage(StrLen image_name) const;
+
   public:
 
-   DataFile(StrLen file_name,StrLen target_name);
+   DataFile(StrLen file_name,StrLen target_name,bool named=false,bool image=false,Tracer *tracer=0); // named : all targets are available by name
+                                                                                                    // image : use <file_name>.image, all targets are named
 
    ~DataFile();
 
    TypeDef::Target * getTarget() const { return target; }
 
+   TypeDef::Target * findTarget(StrLen target_name) const;
+
    PtrLen<TypeDef::Rule *const> getRules() const { return Range(rules); }
 
    PtrLen<TypeDef::Dep *const> getDeps() const { return Range(deps); }
+
+   PtrLen<const String> getFiles() const { return Range(files); }
+
+   void clearExt(TypeDef::Target *root) const; // the file can be processed again
  };
 
 } // namespace VMake
@@ -0,0 +1,247 @@
+/* VMakeDepLog.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeDepLog_h
+#define App_VMakeDepLog_h
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/StrKey.h>
+#include <CCore/inc/Tree.h>
+#include <CCore/inc/ElementPool.h>
+#include <CCore/inc/FileToMem.h>
+#include <CCore/inc/GenFile.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+class DepFile;
+
+class DepLog;
+
+/* class DepFile */
+
+ //
+ // gcc/clang -MD output : target ... : src ... , lines are continued by \ , "\ " and "\#" are escapes , "$$" is $
+ //
+
+class DepFile : NoCopy
+ {
+   FileToMem text;
+
+   DynArray<char> temp; // unescaped name
+
+  private:
+
+   static bool IsSpace(char ch) { return ch==' ' || ch=='\t' ; }
+
+   static bool IsEOL(char ch) { return ch=='\n' || ch=='\r' ; }
+
+   static bool IsSep(PtrLen<const char> cur); // ':' , which ends targets
+
+   StrLen name(PtrLen<const char> &cur);
+
+  public:
+
+   explicit DepFile(StrLen file_name);
+
+   ~DepFile();
+
+   template <class Func>
+   void apply(Func func); // func(StrLen src_file) , the name is valid during the call
+ };
+
+template <class Func>
+void DepFile::apply(Func func)
+ {
+  auto cur=Mutate<const char>(Range(text.getPtr(),text.getLen()));
+
+  bool src=false;
+
+  while( +cur )
+    {
+     char ch=*cur;
+
+     if( IsSpace(ch) )
+       {
+        ++cur;
+       }
+     else if( IsEOL(ch) )
+       {
+        src=false;
+
+        ++cur;
+       }
+     else if( ch=='\\' && cur.len>1 && IsEOL(cur[1]) )
+       {
+        cur+=2; // continuation, \r\n is skipped in two steps
+       }
+     else if( ch=='#' )
+       {
+        while( +cur && !IsEOL(*cur) ) ++cur;
+       }
+     else if( IsSep(cur) )
+       {
+        src=true;
+
+        ++cur;
+       }
+     else
+       {
+        StrLen str=name(cur);
+
+        if( src && +str ) func(str);
+       }
+    }
+ }
+
+/* class DepLog */
+
+ //
+ // <vm-file>.deps , <vm-file>.includes
+ //
+ // Header , uint32 slot[slot_count] , KeyRec[key_count] , NameRec[name_count] , uint32 ref[ref_count] , char text[text_len]
+ //
+ // KeyRec is a depfile of a rule or a scanned file, ref[ref_off,ref_off+ref_count) are NameRec indexes of the names.
+ // slot is a KeyRec index + 1 , 0 for the empty slot , open addressing by the key hash.
+ //
+
+class DepLog : NoCopy
+ {
+  public:
+
+   static constexpr uint32 Magic = 0x44504D56 ;
+   static constexpr uint32 Version = 2 ;
+
+   struct Header
+    {
+     uint32 magic;
+     uint32 version;
+     uint32 slot_count; // power of 2
+     uint32 key_count;
+     uint32 name_count;
+     uint32 ref_count;
+     uint32 text_len;
+     uint32 pad;
+    };
+
+   struct KeyRec
+    {
+     uint64 time; // status of the key file, if used
+     uint64 len;
+     uint32 hash;
+     uint32 name_off;
+     uint32 name_len;
+     uint32 ref_off;
+     uint32 ref_count;
+     uint32 pad;
+    };
+
+   struct NameRec
+    {
+     uint32 name_off;
+     uint32 name_len;
+    };
+
+  private:
+
+   String file_name;
+
+   FileToMem image;
+
+   const Header *header = 0 ;
+   const uint32 *slot = 0 ;
+   const KeyRec *key_list = 0 ;
+   const NameRec *name_list = 0 ;
+   const uint32 *ref_list = 0 ;
+   const char *text = 0 ;
+
+   struct Entry : NoCopy
+    {
+     RBTreeLink<Entry,StrKey> link;
+
+     PtrLen<StrLen> names;
+     FileStatus status;
+    };
+
+   using TreeAlgo = RBTreeLink<Entry,StrKey>::Algo<&Entry::link,const StrKey &> ;
+
+   ElementPool pool;
+   TreeAlgo::Root root;
+   DynArray<Entry *> entries;
+
+   bool changed = false ;
+
+  private:
+
+   bool checkName(uint32 off,uint32 len) const { return off<=header->text_len && len<=header->text_len-off ; }
+
+   bool checkKey(const KeyRec &rec) const;
+
+   StrLen getName(uint32 off,uint32 len) const { return StrLen(text+off,len); }
+
+   const KeyRec * find(StrLen key) const;
+
+   void load();
+
+  public:
+
+   explicit DepLog(StrLen file_name);
+
+   ~DepLog();
+
+   // old log
+
+   template <class Func>
+   bool apply(StrLen key,Func func,const FileStatus *status=0) const; // func(StrLen name) , false if there is no record or the status is changed
+
+   // new log
+
+   void add(StrLen key,PtrLen<const String> names,const FileStatus &status={}); // replaces the old record
+
+   void save(); // if changed
+ };
+
+template <class Func>
+bool DepLog::apply(StrLen key,Func func,const FileStatus *status) const
+ {
+  const KeyRec *rec=find(key);
+
+  if( !rec ) return false;
+
+  if( status && ( rec->time!=uint64(status->time) || rec->len!=uint64(status->len) ) ) return false;
+
+  for(uint32 ind : Range(ref_list+rec->ref_off,rec->ref_count) )
+    {
+     if( ind>=header->name_count ) continue;
+
+     const NameRec &name=name_list[ind];
+
+     if( checkName(name.name_off,name.name_len) ) func(getName(name.name_off,name.name_len));
+    }
+
+  return true;
+ }
+
+} // namespace VMake
+} // namespace App
+
+#endif
+
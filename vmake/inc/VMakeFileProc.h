@@ -15,11 +15,17 @@
 #define App_VMakeFileProc_h
 
 #include <inc/VMakeIntCmd.h>
+#include <inc/VMakeHash.h>
+#include <inc/VMakeCache.h>
+#include <inc/VMakeTrace.h>
+#include <inc/VMakeUsage.h>
 
 #include <CCore/inc/OptMember.h>
 #include <CCore/inc/Array.h>
 #include <CCore/inc/FileSystem.h>
 #include <CCore/inc/SpawnProcess.h>
+#include <CCore/inc/JobServer.h>
+#include <CCore/inc/Timer.h>
 
 #include <CCore/inc/ReadCon.h>
 #include <CCore/inc/Task.h>
@@ -39,17 +45,109 @@ namespace VMake {
 
 #endif
 
+/* struct Options */
+
+struct Options
+ {
+  unsigned pcap = 0 ;
+
+  bool trust = false ; // trust the build state for unchanged dirs
+  bool hash = false ; // content hash up-to-date check
+
+  StrLen cache_dir; // artifact cache directory, empty if not used
+  unsigned cache_size = 1024 ; // MByte
+
+  bool merge = false ; // merge nested vmake files into one build graph
+
+  bool image = false ; // use the precompiled graph image <vmake-file>.image
+
+  StrLen trace; // Chrome trace file, empty if not used
+
+  StrLen usage; // per-rule resource usage file (CSV), empty if not used
+
+  unsigned max_load = 0 ; // no new processes above this load average, 0 if not used
+  unsigned min_mem = 0 ; // MByte , no new processes below this available memory, 0 if not used
+
+  bool capture = true ; // capture the output of parallel processes
+ };
+
+/* TraceName() */
+
+inline StrLen TraceName(TypeDef::Rule *rule)
+ {
+  for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr && +ptr->desc.getStr() ) return ptr->desc;
+
+  return "rule"_c;
+ }
+
 /* type CompleteFunction */
 
-using CompleteFunction = Function<void (TypeDef::Rule *rule,int status)> ;
+using CompleteFunction = Function<void (TypeDef::Rule *rule,int status,MSecTimer::ValueType time)> ;
+
+/* type IntCmdFunction */
+
+using IntCmdFunction = Function<int (StrLen wdir,TypeDef::IntCmd *cmd,PrintBase &out)> ;
+
+/* struct SpawnBase */
+
+struct SpawnBase : NoCopy // taken once, shared by all spawns
+ {
+  ShellPath shell;
+  SpawnEnviron env;
+ };
 
 /* SpawnCommand() */
 
-void SpawnCommand(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,SpawnSlot &slot);
+void SpawnCommand(const SpawnBase &base,SpawnArena &arena,StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,StrLen makeflags,SpawnSlot &slot);
 
 /* SpawnExecute() */
 
-void SpawnExecute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,SpawnSlot &slot);
+void SpawnExecute(const SpawnBase &base,SpawnArena &arena,StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,StrLen makeflags,SpawnSlot &slot);
+
+/* RunParallel() */
+
+template <class Func>
+void RunParallel(ulen len,ulen max_count,Func func) // func(ind) for ind in [0,len)
+ {
+  if( !len ) return;
+
+  ulen count=Min<ulen>(Max<ulen>(max_count,1),len);
+
+  Atomic next;
+  AntiSem asem;
+
+  auto run = [&] ()
+                 {
+                  for(;;)
+                    {
+                     ulen ind=next++;
+
+                     if( ind>=len ) break;
+
+                     func(ind);
+                    }
+                 } ;
+
+  for(ulen cnt=count-1; cnt ;cnt--)
+    {
+     asem.inc();
+
+     try
+       {
+        RunFuncTask(run,asem.function_dec());
+       }
+     catch(...)
+       {
+        asem.wait();
+
+        throw;
+       }
+    }
+
+  run();
+
+  asem.wait();
+ }
 
 /* classes */
 
@@ -57,6 +155,8 @@ struct ExeRule;
 
 class ExeList;
 
+class Admission;
+
 class PExeProc;
 
 class FileProc;
@@ -97,36 +197,124 @@ struct ExeRule : NoCopy
   ulen ind = 0 ;
 
   TypeDef::Rule *rule = 0 ;
+  unsigned prio = 0 ;
+  StrLen wdir;
+
+  ulen pool = 0 ; // pool index + 1 , 0 if no pool
+  ulen weight = 0 ;
+  ExeRule *next = 0 ; // blocked list
 
   int status = 0 ;
   PtrLen<DDL::MapPolyPtr<TypeDef::Exe,TypeDef::Cmd,TypeDef::VMake,TypeDef::IntCmd> > list;
 
-  void set(TypeDef::Rule *rule_)
+  MSecTimer::ValueType start_time = 0 ;
+
+  RuleUsage usage;
+
+  void set(TypeDef::Rule *rule_,unsigned prio_,StrLen wdir_)
    {
     rule=rule_;
+    prio=prio_;
+    wdir=wdir_;
+
+    pool=0;
+    weight=0;
+    next=0;
 
     status=0;
     list=rule->cmd.getRange();
+
+    usage={};
    }
 
   template <class Func>
-  bool start(Func func);
+  bool start(bool merged,Func func); // merged : skip VMake commands
+
+  bool nextCmd(bool merged) const; // the next start() runs a command, it requires a free slot
 
   TypeDef::VMake * getVMake();
  };
 
 /* class ExeList */
 
+ //
+ // Rules of a pool are fed while the total weight of the pool rules in progress fits the pool capacity.
+ // The rest is blocked on the pool and returned to the heap, when the pool capacity is released.
+ //
+
 class ExeList : NoCopy
  {
+   struct Pool
+    {
+     TypeDef::Pool *pool;
+     ulen capacity;
+     ulen used = 0 ;
+
+     ExeRule *first = 0 ; // blocked list
+     ExeRule *last = 0 ;
+
+     explicit Pool(TypeDef::Pool *pool_) : pool(pool_),capacity(Max<ulen>(pool_->capacity,1)) {}
+
+     bool fit(ulen weight) const { return weight<=capacity-used; }
+
+     void block(ExeRule *obj)
+      {
+       obj->next=0;
+
+       if( last )
+         last->next=obj;
+       else
+         first=obj;
+
+       last=obj;
+      }
+
+     ExeRule * unblock()
+      {
+       ExeRule *ret=first;
+
+       if( ret )
+         {
+          first=ret->next;
+
+          if( !first ) last=0;
+         }
+
+       return ret;
+      }
+    };
+
+   PtrLen<ExeRule> rule_buf;
    ExeRule **buf;
    ulen running;
    ulen ready;
    ulen count;
+   ExeRule **heap;
+   ulen pending;
    CompleteFunction complete;
+   bool merged;
+   Tracer *tracer;
+   UsageLog *usage_log;
+
+   DynArray<Pool> pools;
+   ulen blocked;
 
   private:
 
+   ulen findPool(TypeDef::Pool *pool); // index + 1
+
+   void push(ExeRule *obj);
+
+   bool acquire(ExeRule *obj);
+
+   void release(ExeRule *obj);
+
+   static bool Less(ExeRule *a,ExeRule *b) { return a->prio<b->prio; }
+
+   void heapUp(ulen ind);
+
+   void heapDown(ulen ind);
+
    void swap(ulen a,ulen b);
 
    void moveOut(ulen ind);
@@ -148,23 +336,69 @@ class ExeList : NoCopy
 
   public:
 
-   ExeList(PtrLen<ExeRule> list,ExeRule * buf[],CompleteFunction complete);
+   ExeList(PtrLen<ExeRule> rule_buf,ExeRule * buf[],ExeRule * heap[],CompleteFunction complete,bool merged,Tracer *tracer=0,UsageLog *usage_log=0); // buf.len == heap.len == rule_buf.len
+
+   ulen notEmpty() const { return count+pending+blocked; }
+
+   void add(TypeDef::Rule *rule,unsigned prio,StrLen wdir); // can be called from complete, the rule is pending
 
-   ulen notEmpty() const { return count; }
+   ulen hasPending() const { return pending; }
+
+   bool feed(); // move the pending rule with the highest prio to ready, rules with the full pool are blocked
 
    ulen hasReady() const { return ready; }
 
+   ulen hasWaiting() const { return ready-running; }
+
    ulen hasRunning() const { return running; }
 
    template <class Func>
-   void loop(Func func); // func(ExeRule *,{TypeDef::Exe,TypeDef::Cmd} *)
+   bool loop(ulen lim,Func func); // func(ExeRule *,{TypeDef::Exe,TypeDef::Cmd,TypeDef::IntCmd} *) , up to lim commands are started, false if nothing is done
 
    template <class Func>
-   void vmake(Func func); // func(TypeDef::VMake *)
+   void vmake(Func func); // func(ExeRule *,TypeDef::VMake *)
 
    void completeObj(ExeRule *exeobj,int status);
  };
 
+/* class Admission */
+
+ //
+ // Limits the number of running processes by the system load average and the available memory.
+ // The limit drops to the running count on overload and ramps back up, while the system is not overloaded.
+ //
+
+class Admission : NoCopy
+ {
+   unsigned max_load; // load average * 100 , 0 if not used
+   uint64 min_mem; // bytes , 0 if not used
+   ulen max_cap;
+
+   ulen cap;
+
+   MSecTimer timer;
+   bool sampled = false ;
+
+   static constexpr MSecTimer::ValueType SamplePeriod = 250 ;
+
+   uint64 throttle_time = 0 ; // usec
+   ulen throttle_count = 0 ;
+
+  private:
+
+   void sample(ulen running);
+
+  public:
+
+   Admission(unsigned max_load,unsigned min_mem,ulen max_cap);
+
+   ulen limit(ulen running); // how many processes can be started
+
+   void addThrottle(uint64 time) { throttle_time+=time; throttle_count++; }
+
+   void report(); // and reset the counters
+ };
+
 /* class PExeProc */
 
 class PExeProc : NoCopy
@@ -192,27 +426,101 @@ class PExeProc : NoCopy
      CompleteArg arg = {} ;
 
      ulen ind = 0 ;
+     ulen num = 0 ; // stable slot number
+
+     uint64 start = 0 ; // trace
+     uint64 wall_start = 0 ; // usec
+
+     StrLen echo; // printed with the captured output
+
+     TypeDef::IntCmd *intcmd = 0 ; // worker job
+     StrLen intcmd_wdir;
+     String intcmd_output; // console output of the job
+     Slot *next = 0 ;
+
+     SpawnArena arena; // argv and envp, reused
 
      Slot() noexcept {}
     };
 
+   //
+   // Internal commands run on worker threads, the completion is posted to the wait set.
+   // Workers are started on demand, up to MaxWorkers.
+   //
+
+   class Workers : NoCopy
+    {
+      SpawnSet &waitset;
+      IntCmdFunction func;
+      ulen max_count;
+      ulen count = 0 ;
+
+      Mutex mutex;
+      Sem sem;
+      AntiSem asem;
+
+      Slot *first = 0 ; // job queue
+      Slot *last = 0 ;
+
+     private:
+
+      Slot * get(); // null on stop
+
+      void run();
+
+     public:
+
+      Workers(SpawnSet &waitset,IntCmdFunction func,ulen max_count);
+
+      ~Workers();
+
+      void addWorker(); // if less than max_count
+
+      void start(Slot *slot);
+    };
+
+   static constexpr ulen MaxWorkers = 4 ;
+
    SimpleArray<Slot> slotbuf;
    SimpleArray<Slot *> slots;
    ulen free;
 
    SpawnSet waitset;
 
+   const SpawnBase &base;
+
+   OptMember<JobServer> jobs; // GNU make jobserver
+   String makeflags; // exported to children, if vmake is the jobserver
+
+   Tracer *tracer;
+
+   OptMember<Admission> admission;
+   bool throttled = false ;
+
+   bool capture = false ;
+   DynArray<char> out_buf; // console output of a completed process, printed with one write
+
+   OptMember<Workers> workers;
+   IntCmdFunction intcmd_func;
+
   private:
 
+   void print(StrLen str) { out_buf.extend_copy(Range(str)); }
+
+   void print(StrLen echo,PtrLen<const char> output);
+
+   void openJobServer(ulen pcap);
+
    void movetoFree(ulen ind);
 
    struct WaitOneResult
     {
      Slot *slot;
      int status;
+     SpawnUsage usage;
     };
 
-   WaitOneResult waitOneFinish(Slot *slot,int status);
+   WaitOneResult waitOneFinish(Slot *slot,int status,const SpawnUsage &usage);
 
    WaitOneResult waitOne();
 
@@ -220,10 +528,26 @@ class PExeProc : NoCopy
 
   public:
 
-   explicit PExeProc(ulen pcap);
+   PExeProc(ulen pcap,const SpawnBase &base,Tracer *tracer=0);
 
    ~PExeProc();
 
+   void setAdmission(unsigned max_load,unsigned min_mem);
+
+   void setCapture(bool on);
+
+   void setIntCmd(IntCmdFunction func) { intcmd_func=func; }
+
+   ulen getFree(); // takes jobserver tokens for free slots
+
+   bool isThrottled() const { return throttled; } // the last getFree() is limited by admission
+
+   void addThrottle(uint64 time) { if( +admission ) admission->addThrottle(time); }
+
+   void reportThrottle() { if( +admission ) admission->report(); }
+
+   void trimTokens(); // gives back tokens, which are not used by running processes
+
    void waitFree(CompleteCtx ctx);
 
    void waitOne(CompleteCtx ctx);
@@ -232,31 +556,81 @@ class PExeProc : NoCopy
 
    void waitAll() noexcept;
 
-   void command(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,CompleteExe complete);
+   void command(StrLen echo,StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,CompleteExe complete);
 
-   void execute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,CompleteExe complete);
+   void execute(StrLen echo,StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,CompleteExe complete);
+
+   void intcmd(StrLen echo,StrLen wdir,TypeDef::IntCmd *cmd,CompleteExe complete);
  };
 
 /* class FileProc */
 
-class FileProc : NoCopy
+class FileProc : public Funchor_nocopy
  {
    OptMember<StopFlag> stop_flag;
 
    IntCmdProc intproc;
 
-   unsigned level = 100 ;
+   static constexpr unsigned MaxLevel = 100 ;
+
+   unsigned level = MaxLevel ;
+
+   Options opt;
+
+   OptMember<SpawnBase> spawn_base;
+
+   SpawnArena spawn_arena; // serial spawns
 
    OptMember<PExeProc> pexe;
 
+   OptMember<ArtifactCache> cache;
+
+   OptMember<Tracer> tracer;
+
+   OptMember<UsageLog> usage_log;
+
+   RuleUsage *cur_usage = 0 ; // serial rule
+
+   static constexpr unsigned MaxPCap = 4096 ;
+
   private:
 
-   static int Command(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env);
+   int Command(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env);
 
-   static int Execute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env);
+   int Execute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env);
 
    static int VMake(FileProc &file_proc,StrLen file_name,StrLen target,StrLen wdir);
 
+   static void AddText(ContentHash &hash,StrLen str);
+
+   static void AddWDir(ContentHash &hash,StrLen wdir,StrLen new_wdir);
+
+   static void AddEnv(ContentHash &hash,PtrLen<TypeDef::Env> env);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Echo *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Cat *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Rm *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Mkdir *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Copy *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Touch *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Link *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Stamp *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Exe *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::Cmd *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::VMake *cmd);
+
+   static void AddSig(ContentHash &hash,StrLen wdir,TypeDef::IntCmd *cmd);
+
   public:
 
    FileProc();
@@ -265,10 +639,38 @@ class FileProc : NoCopy
 
    void guard() { if( +stop_flag ) stop_flag->guard(); }
 
-   void prepare(unsigned pcap);
+   void prepare(const Options &opt);
 
    bool usePExe() const { return +pexe; }
 
+   bool useTrust() const { return opt.trust; }
+
+   bool useHash() const { return opt.hash; }
+
+   bool useMerge() const { return opt.merge; }
+
+   bool useImage() const { return opt.image; }
+
+   ArtifactCache * getCache() const { return +cache; }
+
+   Tracer * getTracer() const { return +tracer; }
+
+   void saveTrace() { if( +tracer ) tracer->save(opt.trace); }
+
+   UsageLog * getUsageLog() const { return +usage_log; }
+
+   void saveUsage() { if( +usage_log ) { usage_log->report(); usage_log->save(opt.usage); } }
+
+   bool isTopLevel() const { return level==MaxLevel; }
+
+   // stat cache
+
+   void openStatCache(StrLen wdir) { intproc.openCache(wdir); }
+
+   void closeStatCache() { intproc.closeCache(); }
+
+   void openWatch() { intproc.openWatch(); } // resident server : keep the file status between builds
+
    // check
 
    bool checkExist(StrLen wdir,StrLen dst)
@@ -281,6 +683,11 @@ class FileProc : NoCopy
      return intproc.getFileTime(wdir,file);
     }
 
+   FileStatus getFileStatus(StrLen wdir,StrLen file)
+    {
+     return intproc.getFileStatus(wdir,file);
+    }
+
    bool checkOlder(StrLen wdir,StrLen dst,StrLen src) // dst.noexist OR dst.time < src.time
     {
      return intproc.checkOlder(wdir,dst,src);
@@ -288,13 +695,21 @@ class FileProc : NoCopy
 
    // int
 
-   int exeCmd(StrLen wdir,TypeDef::Echo *cmd);
+   int exeCmd(StrLen wdir,TypeDef::Echo *cmd,PrintBase &out);
 
-   int exeCmd(StrLen wdir,TypeDef::Cat *cmd);
+   int exeCmd(StrLen wdir,TypeDef::Cat *cmd,PrintBase &out);
 
-   int exeCmd(StrLen wdir,TypeDef::Rm *cmd);
+   int exeCmd(StrLen wdir,TypeDef::Rm *cmd,PrintBase &out);
 
-   int exeCmd(StrLen wdir,TypeDef::Mkdir *cmd);
+   int exeCmd(StrLen wdir,TypeDef::Mkdir *cmd,PrintBase &out);
+
+   int exeCmd(StrLen wdir,TypeDef::Copy *cmd,PrintBase &out);
+
+   int exeCmd(StrLen wdir,TypeDef::Touch *cmd,PrintBase &out);
+
+   int exeCmd(StrLen wdir,TypeDef::Link *cmd,PrintBase &out);
+
+   int exeCmd(StrLen wdir,TypeDef::Stamp *cmd,PrintBase &out);
 
    // exe
 
@@ -306,8 +721,16 @@ class FileProc : NoCopy
 
    int exeCmd(StrLen wdir,TypeDef::IntCmd *cmd);
 
+   int runIntCmd(StrLen wdir,TypeDef::IntCmd *cmd,PrintBase &out); // no echo, thread-safe
+
+   IntCmdFunction function_runIntCmd() { return FunctionOf(this,&FileProc::runIntCmd); }
+
    int exeRule(StrLen wdir,TypeDef::Rule *rule);
 
+   // signature
+
+   static uint64 GetSignature(StrLen wdir,TypeDef::Rule *rule); // never 0
+
    // pexe
 
    void startCmd(StrLen wdir,TypeDef::Exe *cmd,PExeProc::CompleteExe complete);
@@ -316,7 +739,20 @@ class FileProc : NoCopy
 
    void startCmd(StrLen wdir,TypeDef::IntCmd *cmd,PExeProc::CompleteExe complete);
 
-   void exeRuleList(StrLen wdir,PtrLen<ExeRule> list,ExeRule * buf[],CompleteFunction complete);
+   void exeRuleList(ExeList &exelist);
+ };
+
+/* class StatCacheScope */
+
+class StatCacheScope : NoCopy
+ {
+   FileProc &file_proc;
+
+  public:
+
+   StatCacheScope(FileProc &file_proc_,StrLen wdir) : file_proc(file_proc_) { file_proc_.openStatCache(wdir); }
+
+   ~StatCacheScope() { file_proc.closeStatCache(); }
  };
 
 } // namespace VMake
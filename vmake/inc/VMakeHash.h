@@ -0,0 +1,91 @@
+/* VMakeHash.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeHash_h
+#define App_VMakeHash_h
+
+#include <CCore/inc/Gadget.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+class ContentHash;
+
+/* class ContentHash */
+
+ //
+ // 64-bit XXH64 compatible hash, four independent lanes per 32-byte stripe.
+ //
+
+class ContentHash : NoCopy
+ {
+   static constexpr uint64 P1 = 11400714785074694791u ;
+   static constexpr uint64 P2 = 14029467366897019727u ;
+   static constexpr uint64 P3 =  1609587929392839161u ;
+   static constexpr uint64 P4 =  9650029242287828579u ;
+   static constexpr uint64 P5 =  2870177450012600261u ;
+
+   static constexpr ulen StripeLen = 32 ;
+
+   uint64 v1;
+   uint64 v2;
+   uint64 v3;
+   uint64 v4;
+
+   uint64 total = 0 ;
+
+   uint8 buf[StripeLen];
+   ulen buf_len = 0 ;
+
+  private:
+
+   static uint64 Rotl(uint64 x,unsigned r) { return (x<<r)|(x>>(64-r)); }
+
+   static uint64 Load64(const uint8 *ptr);
+
+   static uint32 Load32(const uint8 *ptr);
+
+   static uint64 Round(uint64 acc,uint64 lane) { return Rotl(acc+lane*P2,31)*P1; }
+
+   static uint64 Merge(uint64 acc,uint64 v) { return (acc^Round(0,v))*P1+P4; }
+
+   void stripe(const uint8 *ptr);
+
+  public:
+
+   explicit ContentHash(uint64 seed=0);
+
+   void add(PtrLen<const uint8> data);
+
+   void add(StrLen str) { add(Mutate<const uint8>(str)); }
+
+   void add(uint64 value);
+
+   uint64 finish() const;
+ };
+
+/* HashFile() */
+
+uint64 HashFile(StrLen file_name); // 0 on error, never 0 on success
+
+} // namespace VMake
+} // namespace App
+
+#endif
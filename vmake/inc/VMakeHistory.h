@@ -0,0 +1,88 @@
+/* VMakeHistory.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeHistory_h
+#define App_VMakeHistory_h
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/StrKey.h>
+#include <CCore/inc/Tree.h>
+#include <CCore/inc/ElementPool.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+class RuleHistory;
+
+/* class RuleHistory */
+
+ //
+ // Text file, one line per rule : <msec> <key>
+ //
+
+class RuleHistory : NoCopy
+ {
+   struct Node : NoCopy
+    {
+     RBTreeLink<Node,StrKey> link;
+
+     unsigned time; // msec
+    };
+
+   using TreeAlgo = RBTreeLink<Node,StrKey>::Algo<&Node::link,const StrKey &> ;
+
+   ElementPool pool;
+   StrLen file_name;
+
+   TreeAlgo::Root root;
+   DynArray<Node *> list;
+
+   unsigned average = 1 ;
+   bool changed = false ;
+
+  private:
+
+   Node * find(StrLen key);
+
+   void add(StrLen key,unsigned time);
+
+   void load();
+
+  public:
+
+   explicit RuleHistory(StrLen file_name);
+
+   ~RuleHistory();
+
+   unsigned getAverage() const { return average; }
+
+   bool isEmpty() const { return list.getLen()==0; }
+
+   unsigned get(StrLen key); // 0 if unknown
+
+   void set(StrLen key,unsigned time);
+
+   void save();
+ };
+
+} // namespace VMake
+} // namespace App
+
+#endif
@@ -0,0 +1,165 @@
+/* VMakeIncScan.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeIncScan_h
+#define App_VMakeIncScan_h
+
+#include <inc/VMakeFileProc.h>
+#include <inc/VMakeDepLog.h>
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/StrKey.h>
+#include <CCore/inc/Tree.h>
+#include <CCore/inc/ElementPool.h>
+#include <CCore/inc/OwnPtr.h>
+
+namespace App {
+namespace VMake {
+
+/* classes */
+
+class IncludeScanner;
+
+/* class IncludeScanner */
+
+ //
+ // Finds #include "file" and #include <file> lines, resolves them by the include path and follows the found files.
+ // Raw include lists are cached in <vm-file>.includes by the file status.
+ //
+
+class IncludeScanner : NoCopy
+ {
+   FileProc &file_proc;
+   StrLen wdir;
+
+   DepLog cache; // raw includes of files, '"' or '<' is the first char
+
+   ElementPool pool;
+
+   struct FileNode : NoCopy
+    {
+     RBTreeLink<FileNode,StrKey> link; // file
+
+     PtrLen<FileNode *> incs; // resolved includes
+
+     ulen mark = 0 ;
+    };
+
+   using TreeAlgo = RBTreeLink<FileNode,StrKey>::Algo<&FileNode::link,const StrKey &> ;
+
+   struct Context : NoCopy
+    {
+     PtrLen<StrLen> path;
+
+     TreeAlgo::Root root;
+
+     DynArray<FileNode *> pending;
+    };
+
+   DynArray<OwnPtr<Context> > contexts;
+
+   ulen mark = 0 ;
+
+   static constexpr ulen ScanThreads = 16 ; // i/o bound
+
+   struct Item : NoCopy
+    {
+     Context *ctx = 0 ;
+     FileNode *node = 0 ;
+
+     FileStatus status;
+     bool hit = false ;
+
+     DynArray<String> raw;
+     DynArray<String> found;
+
+     bool ok = false ;
+    };
+
+  private:
+
+   static uint64 Load64(const char *ptr);
+
+   static const char * FindHash(const char *ptr,const char *lim); // word-at-a-time search of '#'
+
+   static StrLen Include(const char *ptr,const char *lim); // ptr after '#' , raw include or empty
+
+   static void Scan(PtrLen<const char> text,DynArray<String> &raw);
+
+   FileNode * getNode(Context *ctx,StrLen file);
+
+   bool exist(StrLen file);
+
+   void resolve(Context *ctx,StrLen includer,StrLen raw,DynArray<String> &found);
+
+   void work(Item &item);
+
+  public:
+
+   IncludeScanner(FileProc &file_proc,StrLen wdir,StrLen cache_file);
+
+   ~IncludeScanner();
+
+   ulen addContext(PtrLen<const StrLen> path); // path is relative to wdir
+
+   void addRoot(ulen ctx,StrLen file);
+
+   void run();
+
+   template <class Func>
+   void apply(ulen ctx,PtrLen<const StrLen> roots,Func func); // func(StrLen file) for all files included by roots
+
+   void save() { cache.save(); }
+ };
+
+template <class Func>
+void IncludeScanner::apply(ulen ctx_ind,PtrLen<const StrLen> roots,Func func)
+ {
+  Context *ctx=contexts[ctx_ind].getPtr();
+
+  mark++;
+
+  DynArray<FileNode *> stack;
+
+  for(StrLen file : roots )
+    if( FileNode *node=ctx->root.find(StrKey(file)) )
+      {
+       node->mark=mark;
+
+       stack.append_copy(node);
+      }
+
+  while( stack.notEmpty() )
+    {
+     FileNode *node=stack[stack.getLen()-1];
+
+     stack.shrink_one();
+
+     for(FileNode *inc : node->incs )
+       if( inc->mark!=mark )
+         {
+          inc->mark=mark;
+
+          func(StrLen(inc->link.key.str));
+
+          stack.append_copy(inc);
+         }
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
+#endif
+
@@ -15,6 +15,16 @@
 #define App_VMakeIntCmd_h
 
 #include <CCore/inc/ExpandWildcard.h>
+#include <CCore/inc/FileSystem.h>
+#include <CCore/inc/FileWatch.h>
+#include <CCore/inc/Array.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/StrKey.h>
+#include <CCore/inc/Tree.h>
+#include <CCore/inc/ElementPool.h>
+#include <CCore/inc/OwnPtr.h>
+#include <CCore/inc/OptMember.h>
+#include <CCore/inc/Task.h>
 
 #include <CCore/inc/ddl/DDLMapTypes.h>
 
@@ -36,29 +46,169 @@ class IntCmdProc : NoCopy
  {
    FileSystem fs;
 
+   class StatCache : NoCopy
+    {
+      FileSystem &fs;
+      String wdir;
+
+      Mutex mutex;
+
+      struct DirNode : NoCopy
+       {
+        RBTreeLink<DirNode,StrKey> link; // dir prefix of the file name
+
+        FileSystem::DirHandle *handle; // null, if the handle limit is reached
+       };
+
+      using TreeAlgo = RBTreeLink<DirNode,StrKey>::Algo<&DirNode::link,const StrKey &> ;
+
+      ElementPool pool;
+      TreeAlgo::Root root;
+      DynArray<OwnPtr<FileSystem::DirHandle> > handles;
+
+      static constexpr ulen MaxHandles = 512 ;
+
+     private:
+
+      FileSystem::DirHandle * openDir(StrLen dir);
+
+      FileSystem::DirHandle * find(StrLen prefix,StrLen dir);
+
+     public:
+
+      StatCache(FileSystem &fs,StrLen wdir);
+
+      ~StatCache();
+
+      bool getFileStatus(StrLen wdir,StrLen file,FileStatus &ret); // false, if the file is not served
+    };
+
+   OptMember<StatCache> cache;
+
+   class StatWatch : NoCopy
+    {
+      FileWatch watch;
+
+      Mutex mutex;
+
+      struct FileNode : NoCopy
+       {
+        RBTreeLink<FileNode,StrKey> link; // file name only
+
+        FileStatus status;
+
+        uint64 stamp; // 0 if not valid
+       };
+
+      using FileTreeAlgo = RBTreeLink<FileNode,StrKey>::Algo<&FileNode::link,const StrKey &> ;
+
+      struct DirNode : NoCopy
+       {
+        RBTreeLink<DirNode,StrKey> link; // dir path
+
+        FileTreeAlgo::Root files;
+
+        int wd; // -1 if the dir is not watched
+        uint64 fail; // the sync epoch of the failed watch
+
+        uint64 flush; // files with stamp <= flush are not valid
+
+        DirNode *next; // the same watch descriptor
+       };
+
+      using DirTreeAlgo = RBTreeLink<DirNode,StrKey>::Algo<&DirNode::link,const StrKey &> ;
+
+      ElementPool pool;
+      DirTreeAlgo::Root dir_root;
+      DynArray<DirNode *> wd_map;
+
+      uint64 clock = 0 ;
+      uint64 flush = 0 ; // all files
+      uint64 epoch = 1 ;
+
+     private:
+
+      static StrLen DirOf(StrLen path);
+
+      DirNode * getDir(StrLen dir);
+
+      void invalidate(DirNode *dir,StrLen name);
+
+      void invalidateSelf(DirNode *dir);
+
+      void event(const FileWatch::Event &event);
+
+     public:
+
+      StatWatch();
+
+      ~StatWatch();
+
+      void sync(); // applies change notifications
+
+      FileNode * find(StrLen path,FileStatus &ret,bool &valid); // null, if the dir is not watched
+
+      void set(FileNode *node,const FileStatus &status);
+    };
+
+   OptMember<StatWatch> watch;
+
+   bool watch_active = false ;
+
+  private:
+
+   FileStatus statFile(StrLen wdir,StrLen file);
+
+   template <class Func>
+   void forFiles(StrLen path,Func func); // wildcard expanded, a plain path is used as is
+
+   static StrLen TargetOf(MakeFileName &buf,StrLen dst,bool to_dir,StrLen src);
+
+   bool prepareTarget(StrLen dst,PtrLen<DDL::MapText> files); // true, if dst is a dir, it is created for several files
+
   public:
 
    IntCmdProc();
 
    ~IntCmdProc();
 
+   // stat cache, file status queries in wdir use directory handles, thread-safe
+
+   void openCache(StrLen wdir);
+
+   void closeCache();
+
+   // resident file statuses, invalidated by file change notifications, used in the stat cache scope
+
+   void openWatch();
+
    // check
 
    bool checkExist(StrLen wdir,StrLen dst);
 
    CmpFileTimeType getFileTime(StrLen wdir,StrLen file);
 
+   FileStatus getFileStatus(StrLen wdir,StrLen file);
+
    bool checkOlder(StrLen wdir,StrLen dst,StrLen src); // dst.noexist OR dst.time < src.time
 
    // commands
 
-   int echo(StrLen wdir,PtrLen<DDL::MapText> strs,StrLen outfile);
+   int echo(StrLen wdir,PtrLen<DDL::MapText> strs,StrLen outfile,PrintBase &con); // con is the console output
 
    int cat(StrLen wdir,PtrLen<DDL::MapText> files,StrLen outfile);
 
    int rm(StrLen wdir,PtrLen<DDL::MapText> files);
 
    int mkdir(StrLen wdir,PtrLen<DDL::MapText> paths);
+
+   int copy(StrLen wdir,PtrLen<DDL::MapText> files,StrLen dst);
+
+   int touch(StrLen wdir,PtrLen<DDL::MapText> files);
+
+   int link(StrLen wdir,PtrLen<DDL::MapText> files,StrLen dst,bool sym);
+
+   int stamp(StrLen wdir,StrLen file);
  };
 
 } // namespace VMake
@@ -16,6 +16,10 @@
 
 #include <inc/VMakeData.h>
 #include <inc/VMakeFileProc.h>
+#include <inc/VMakeHistory.h>
+#include <inc/VMakeState.h>
+#include <inc/VMakeHash.h>
+#include <inc/VMakeDepLog.h>
 
 #include <CCore/inc/Path.h>
 #include <CCore/inc/String.h>
@@ -24,6 +28,7 @@
 #include <CCore/inc/StrKey.h>
 #include <CCore/inc/Tree.h>
 #include <CCore/inc/ElementPool.h>
+#include <CCore/inc/OwnPtr.h>
 
 #include <CCore/inc/ddl/DDLMapTypes.h>
 
@@ -152,20 +157,44 @@ class DataProc : public Funchor_nocopy
  {
    FileProc &file_proc;
 
-   DataFile data;
+   OptMember<DataFile> own_data;
+
+   const DataFile &data;
+
+   TypeDef::Target *root_target;
 
    ElementPool pool;
    StrLen file_name;
    StrLen wdir;
 
-   struct TimeNode : NoCopy
+   struct DirNode : NoCopy
     {
-     RBTreeLink<TimeNode,StrKey> link;
+     RBTreeLink<DirNode,StrKey> link;
 
      CmpFileTimeType time;
+
+     const BuildState::DirRec *rec;
+
+     bool trusted; // the dir is not changed since the last run
+     bool dirty; // some target in the dir is rebuilt
+
+     uint32 index;
+    };
+
+   using DirTreeAlgo = RBTreeLink<DirNode,StrKey>::Algo<&DirNode::link,const StrKey &> ;
+
+   struct FileNode : NoCopy
+    {
+     RBTreeLink<FileNode,StrKey> link;
+
+     BuildState::FileData data;
+
+     DirNode *dir;
+
+     bool trusted; // status is taken from the build state
     };
 
-   using TreeAlgo = RBTreeLink<TimeNode,StrKey>::Algo<&TimeNode::link,const StrKey &> ;
+   using TreeAlgo = RBTreeLink<FileNode,StrKey>::Algo<&FileNode::link,const StrKey &> ;
 
    enum State
     {
@@ -175,6 +204,13 @@ class DataProc : public Funchor_nocopy
      StateRebuild
     };
 
+   enum PathState
+    {
+     PathInitial,
+     PathLocked,
+     PathDone
+    };
+
    struct TRec : NoCopy
     {
      TypeDef::Rule *rule = 0 ;
@@ -183,15 +219,78 @@ class DataProc : public Funchor_nocopy
 
      State state = StateInitial ;
 
-     TimeNode *time_node = 0 ;
+     FileNode *file_node = 0 ;
+
+     bool scan = false ;
+
+     bool merged = false ; // merge mode, the target is rebased
+
+     bool fetch = false ; // the file status is prefetched
+
+     bool dynamic = false ; // src from a depfile
+
+     // commit
+
+     List<TypeDef::Target *> users; // targets with this src, one entry per src entry
+
+     ulen wait = 0 ; // src entries which are not ready
+
+     bool watch = false ;
+
+     // critical path
+
+     PathState path_state = PathInitial ;
+
+     unsigned tail = 0 ; // longest path of rules after this target, msec
     };
 
    DynArray<TRec *> trecs;
 
    TreeAlgo::Root root;
+   DynArray<FileNode *> file_nodes;
+
+   DirTreeAlgo::Root dir_root;
+   DynArray<DirNode *> dir_nodes;
+
+   OptMember<BuildState> state;
+
+   struct SubFile : NoCopy
+    {
+     RBTreeLink<SubFile,StrKey> link; // file name and wdir
+
+     const DataFile *data;
+
+     StrLen file_name;
+     StrLen wdir; // wdir of the sub-file rules
+     StrLen base; // prefix of the sub-file target files
+
+     SubFile(const DataFile *data_,StrLen file_name_,StrLen wdir_,StrLen base_)
+      : data(data_),file_name(file_name_),wdir(wdir_),base(base_) {}
+    };
+
+   using SubTreeAlgo = RBTreeLink<SubFile,StrKey>::Algo<&SubFile::link,const StrKey &> ;
+
+   SubTreeAlgo::Root sub_root;
+   DynArray<OwnPtr<DataFile> > sub_files;
+   DynArray<TypeDef::Target *> merge_list;
+
+   struct DynTarget : NoCopy
+    {
+     RBTreeLink<DynTarget,StrKey> link; // file
+
+     TypeDef::Target *target;
+    };
+
+   using DynTreeAlgo = RBTreeLink<DynTarget,StrKey>::Algo<&DynTarget::link,const StrKey &> ;
+
+   DynTreeAlgo::Root dyn_root;
+   bool dyn_known = false ;
+   OptMember<DepLog> deplog;
 
   private:
 
+   static const DataFile & Load(OptMember<DataFile> &obj,StrLen file_name,StrLen target,bool named,bool image,Tracer *tracer);
+
    TRec * getRec(TypeDef::Target *obj);
 
    void add(TypeDef::Target *dst,TypeDef::Rule *rule);
@@ -200,8 +299,44 @@ class DataProc : public Funchor_nocopy
 
    void prepare(OneOfTypes<TypeDef::Rule,TypeDef::Dep> auto *obj);
 
+   void prepare(const DataFile &data);
+
    void prepare();
 
+  private:
+
+   DDL::MapRange<DDL::MapPtr<TypeDef::Target> > makeRange(TypeDef::Target *obj);
+
+   void addDep(TypeDef::Target *src,DDL::MapRange<DDL::MapPtr<TypeDef::Target> > dst);
+
+   SubFile * addSubFile(const DataFile *data,StrLen file_name,StrLen wdir,StrLen base);
+
+   SubFile * getSubFile(SubFile *parent,TypeDef::VMake *cmd,DynArray<SubFile *> &list);
+
+   void mergeTarget(SubFile *sub,TypeDef::Target *obj);
+
+   static bool IsDelegation(TypeDef::Rule *rule); // only VMake commands, they are skipped in the merged graph
+
+   void linkFiles();
+
+   void merge();
+
+   StrLen getBase(TypeDef::Rule *rule);
+
+   void addTarget(TypeDef::Target *obj);
+
+   TypeDef::Target * getDynTarget(StrLen file);
+
+   void addKnownTargets();
+
+   void addDynDep(TypeDef::Rule *rule,PtrLen<TypeDef::Target *const> src);
+
+   void loadDeps(); // src files from depfiles of the previous run
+
+   void scanIncludes(); // src files from #include lines
+
+   void readDeps(TypeDef::Rule *rule); // rule is completed
+
   private:
 
    TypeDef::Rule * getRule(TypeDef::Target *obj);
@@ -221,10 +356,50 @@ class DataProc : public Funchor_nocopy
 
    bool checkOlder(StrLen dst,StrLen src);
 
-   TimeNode * findNode(StrLen file);
+   CmpFileTimeType getDirTime(StrLen dir);
+
+   void setDir(DirNode *node,CmpFileTimeType time);
+
+   DirNode * findDir(StrLen dir,bool defer); // defer : the dir time is set by prefetch()
+
+   const BuildState::FileRec * findRec(FileNode *node,StrLen file);
+
+   bool trustNode(FileNode *node,StrLen file); // the status is taken from the build state
+
+   void setNode(FileNode *node,StrLen file,const FileStatus &status);
+
+   FileNode * findNode(StrLen file,bool defer); // defer : the status is set by prefetch()
+
+   FileNode * getNode(TypeDef::Target *obj);
 
    CmpFileTimeType getFileTime(TypeDef::Target *obj);
 
+   void markDirty(TypeDef::Target *obj);
+
+   void hashFiles(PtrLen<FileNode *> list);
+
+   bool useContent() const { return file_proc.useHash() || file_proc.getCache(); }
+
+   void scanHash();
+
+   uint64 getSrcHash(TypeDef::Target *obj); // 0 if not available
+
+   bool checkSrcHash(TypeDef::Target *obj);
+
+   uint64 getSig(TypeDef::Rule *rule);
+
+   bool checkSig(TypeDef::Target *obj);
+
+   void updateState(TypeDef::Target *obj);
+
+   static bool SameStatus(const FileStatus &a,const FileStatus &b);
+
+   static bool SameStatus(const BuildState::FileRec &rec,const FileStatus &status);
+
+   static bool SameData(const BuildState::FileRec &rec,const BuildState::FileData &data);
+
+   void saveState();
+
    bool checkOlderCache(TypeDef::Target *dst,TypeDef::Target *src);
 
    bool checkOlder(TypeDef::Target *dst,TypeDef::Target *src,bool nofile);
@@ -235,13 +410,38 @@ class DataProc : public Funchor_nocopy
 
    void finish(TypeDef::Target *obj);
 
+   static constexpr ulen StatThreads = 16 ; // stat is i/o bound
+
+   static constexpr ulen MaxBatchLen = 64 ;
+
+   void prefetch(); // parallel stat of all files of the build graph
+
    void buildWorkTree();
 
   private:
 
    struct RRec : NoCopy
     {
+     ulen wait = 0 ; // dst entries with src which are not ready
+
+     bool init = false ;
      bool done = false ;
+
+     // critical path
+
+     StrLen key;
+
+     SubFile *sub = 0 ; // merge mode, the vmake file of the rule
+
+     uint64 sig = 0 ; // command signature, 0 if not computed
+
+     uint64 cache_key = 0 ; // artifact cache key, 0 if the rule is not cacheable
+
+     unsigned est = 0 ; // expected duration, msec
+     unsigned path = 0 ; // est + the longest path after the rule, 0 if not computed
+
+     TypeDef::Rule *trigger = 0 ; // the rule, which completion makes this rule ready
+     MSecTimer::ValueType time = 0 ; // actual duration
     };
 
    DynArray<RRec *> rrecs;
@@ -250,6 +450,22 @@ class DataProc : public Funchor_nocopy
 
    bool exe_ok = true ;
 
+   Stack<TypeDef::Target *> ok_stack;
+
+   DynArray<TypeDef::Rule *> ready_list;
+
+   ExeList *exelist = 0 ;
+
+   OptMember<RuleHistory> history;
+
+   MSecTimer commit_timer;
+
+   TypeDef::Rule *current_rule = 0 ;
+   TypeDef::Rule *last_rule = 0 ;
+
+   unsigned predicted_path = 0 ;
+   bool predicted = false ; // history is not empty, predicted_path is an estimation only otherwise
+
   private:
 
    template <class T,class R>
@@ -257,42 +473,63 @@ class DataProc : public Funchor_nocopy
 
    RRec * getRec(TypeDef::Rule *obj);
 
+   StrLen getWDir(TypeDef::Rule *rule);
+
    void addWork(TypeDef::Target *obj);
 
    bool dstReady(TypeDef::Target *obj);
 
-   bool canRun(TypeDef::Rule *obj);
-
    bool checkSelf(StrLen file);
 
    bool checkRebuild(TypeDef::Target *obj);
 
-   bool checkRebuild(TypeDef::Target *obj,TRec *rec);
-
    int exeRule(TypeDef::Rule *rule);
 
+   void setOk(TypeDef::Target *obj);
+
    void completeRule(TypeDef::Target *obj);
 
    void completeRule(TypeDef::Rule *rule);
 
-   struct GetRuleResult
-    {
-     bool commit;
-     TypeDef::Rule *rule;
-    };
+   void watch(TypeDef::Target *obj);
+
+   void watch(TypeDef::Rule *rule);
 
-   GetRuleResult tryCommit(TypeDef::Target *obj);
+   StrLen getKey(TypeDef::Rule *rule);
 
-   bool commit(TypeDef::Target *obj);
+   unsigned getPath(TypeDef::Rule *rule);
+
+   template <class Func>
+   void applyToNext(TypeDef::Target *obj,Func func);
+
+   void buildPath(TypeDef::Target *obj);
+
+   void report();
+
+   uint64 getCacheKey(TypeDef::Rule *rule); // 0 if not cacheable
+
+   void getCacheFiles(TypeDef::Rule *rule,DynArray<String> &files);
+
+   bool restoreRule(TypeDef::Rule *rule);
+
+   void storeRule(TypeDef::Rule *rule);
+
+   void pushRule(TypeDef::Rule *rule);
+
+   void srcReady(TypeDef::Target *obj);
+
+   void propagate();
+
+   void startCommit();
+
+   int finishCommit();
 
    int commit();
 
-   void finishRule(TypeDef::Rule *rule,int status);
+   void finishRule(TypeDef::Rule *rule,int status,MSecTimer::ValueType time);
 
    CompleteFunction function_finishRule() { return FunctionOf(this,&DataProc::finishRule); }
 
-   void exeRuleList(PtrLen<ExeRule> rules,ExeRule * buf[]);
-
    int commitPExe();
 
   public:
@@ -301,6 +538,8 @@ class DataProc : public Funchor_nocopy
 
    DataProc(FileProc &file_proc,StrLen file_name,StrLen target,StrLen wdir);
 
+   DataProc(FileProc &file_proc,const DataFile &data,TypeDef::Target *target,StrLen file_name,StrLen wdir); // resident data, data.clearExt(target) is called
+
    ~DataProc();
 
    int make(); // one-time call
@@ -0,0 +1,70 @@
+/* VMakeServer.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeServer_h
+#define App_VMakeServer_h
+
+#include <inc/VMakeProc.h>
+
+#include <CCore/inc/LocalSocket.h>
+
+namespace App {
+namespace VMake {
+
+/* functions */
+
+int RunClient(StrLen socket,StrLen target); // empty target : the default one
+
+/* classes */
+
+class Server;
+
+/* class Server */
+
+ //
+ // Resident vmake : the vmake file and the file status are kept between builds.
+ //
+
+class Server : NoCopy
+ {
+   FileProc &file_proc;
+   StrLen file_name;
+   StrLen target;
+
+   OptMember<DataFile> data;
+   DynArray<FileStatus> data_status;
+
+  private:
+
+   bool changed();
+
+   void load();
+
+   int build(StrLen target);
+
+   int request(StrLen target) noexcept;
+
+  public:
+
+   Server(FileProc &file_proc,StrLen file_name,StrLen target); // target : the default one
+
+   ~Server();
+
+   void run(StrLen socket);
+ };
+
+} // namespace VMake
+} // namespace App
+
+#endif
+
@@ -0,0 +1,172 @@
+/* VMakeState.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeState_h
+#define App_VMakeState_h
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/StrKey.h>
+#include <CCore/inc/GenFile.h>
+#include <CCore/inc/FileToMem.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+class BuildState;
+
+/* class BuildState */
+
+ //
+ // <vm-file>.state
+ //
+ // Header , uint32 file_slot[slot_count] , uint32 dir_slot[slot_count] , FileRec[file_count] , DirRec[dir_count] , char text[text_len]
+ //
+ // slot is a record index + 1 , 0 for the empty slot , open addressing by the name hash
+ //
+ // Records are used in place, no parsing on load.
+ //
+
+class BuildState : NoCopy
+ {
+  public:
+
+   static constexpr uint32 Magic = 0x54534D56 ;
+   static constexpr uint32 Version = 2 ;
+
+   struct Header
+    {
+     uint32 magic;
+     uint32 version;
+     uint32 slot_count; // power of 2, even
+     uint32 file_count;
+     uint32 dir_count;
+     uint32 text_len;
+    };
+
+   struct FileRec
+    {
+     uint64 time;
+     uint64 len;
+     uint64 id;
+     uint64 sig; // rule signature of the target
+     uint64 content; // content hash, 0 if unknown
+     uint64 src_hash; // combined content hash of src at the last successful build, 0 if unknown
+     uint32 type;
+     uint32 dir; // dir index
+     uint32 hash;
+     uint32 name_off;
+     uint32 name_len;
+     uint32 pad;
+    };
+
+   struct DirRec
+    {
+     uint64 time;
+     uint32 hash;
+     uint32 name_off;
+     uint32 name_len;
+     uint32 pad;
+    };
+
+   struct FileData
+    {
+     FileStatus status;
+
+     uint64 sig = 0 ;
+     uint64 content = 0 ;
+     uint64 src_hash = 0 ;
+    };
+
+   static FileData GetData(const FileRec &rec);
+
+  private:
+
+   String file_name;
+
+   FileToMem image;
+
+   const Header *header = 0 ;
+   const uint32 *file_slot = 0 ;
+   const uint32 *dir_slot = 0 ;
+   const FileRec *file_list = 0 ;
+   const DirRec *dir_list = 0 ;
+   const char *text = 0 ;
+
+   struct FileEntry
+    {
+     StrKey key;
+     uint32 dir;
+     FileData data;
+    };
+
+   struct DirEntry
+    {
+     StrKey key;
+     CmpFileTimeType time;
+    };
+
+   DynArray<FileEntry> new_files;
+   DynArray<DirEntry> new_dirs;
+
+  private:
+
+   bool checkName(uint32 off,uint32 len) const { return off<=header->text_len && len<=header->text_len-off ; }
+
+   template <class Rec>
+   const Rec * find(const uint32 *slot,const Rec *list,uint32 count,StrLen name) const;
+
+   void load();
+
+  public:
+
+   explicit BuildState(StrLen file_name);
+
+   ~BuildState();
+
+   // old state
+
+   const FileRec * findFile(StrLen file) const;
+
+   const DirRec * findDir(StrLen dir) const;
+
+   PtrLen<const FileRec> getFileList() const;
+
+   bool checkFile(const FileRec &rec) const; // rec from getFileList()
+
+   StrLen getName(const FileRec &rec) const { return StrLen(text+rec.name_off,rec.name_len); }
+
+   StrLen getName(const DirRec &rec) const { return StrLen(text+rec.name_off,rec.name_len); }
+
+   const DirRec & getDir(const FileRec &rec) const { return dir_list[rec.dir]; }
+
+   // new state, names must live until save()
+
+   uint32 addDir(StrLen dir,CmpFileTimeType time);
+
+   void addFile(StrLen file,uint32 dir,const FileData &data);
+
+   void save();
+ };
+
+} // namespace VMake
+} // namespace App
+
+#endif
@@ -0,0 +1,119 @@
+/* VMakeTrace.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeTrace_h
+#define App_VMakeTrace_h
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/ElementPool.h>
+#include <CCore/inc/Timer.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+class Tracer;
+
+class TraceScope;
+
+/* class Tracer */
+
+ //
+ // Build timeline in the Chrome trace event format ( chrome://tracing , Perfetto ).
+ // Events are buffered in memory and written by save(). Must be used from the main thread only.
+ //
+ // tid 0 is vmake itself, tid N+1 is the process slot N.
+ //
+
+class Tracer : NoCopy
+ {
+   USecTimer timer;
+
+   ElementPool pool; // names
+
+   struct Event
+    {
+     StrLen cat;
+     StrLen name;
+     uint64 ts;
+     uint64 dur;
+     uint64 id; // async events
+     StrLen arg_name; // X events
+     uint64 arg;
+     ulen tid;
+     char ph;
+    };
+
+   DynArray<Event> events;
+
+   ulen slot_count = 0 ;
+
+  private:
+
+   void add(char ph,StrLen cat,StrLen name,uint64 ts,uint64 dur,ulen tid,uint64 id,StrLen arg_name,uint64 arg);
+
+  public:
+
+   Tracer();
+
+   ~Tracer();
+
+   uint64 now() const { return timer.get(); }
+
+   void setSlots(ulen slot_count_) { slot_count=slot_count_; }
+
+   void complete(StrLen cat,StrLen name,uint64 start,ulen tid=0,StrLen arg_name=Empty,uint64 arg=0); // [start,now)
+
+   void begin(StrLen cat,StrLen name,uint64 id); // async span
+
+   void end(StrLen cat,StrLen name,uint64 id);
+
+   void save(StrLen file_name); // events are cleared
+ };
+
+/* class TraceScope */
+
+class TraceScope : NoCopy
+ {
+   Tracer *tracer;
+   StrLen cat;
+   StrLen name;
+   uint64 start = 0 ;
+
+  public:
+
+   TraceScope(Tracer *tracer_,StrLen cat_,StrLen name_)
+    : tracer(tracer_),
+      cat(cat_),
+      name(name_)
+    {
+     if( tracer ) start=tracer->now();
+    }
+
+   ~TraceScope()
+    {
+     if( tracer ) tracer->complete(cat,name,start);
+    }
+ };
+
+} // namespace VMake
+} // namespace App
+
+#endif
+
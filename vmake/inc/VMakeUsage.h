@@ -0,0 +1,100 @@
+/* VMakeUsage.h */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#ifndef App_VMakeUsage_h
+#define App_VMakeUsage_h
+
+#include <CCore/inc/Array.h>
+#include <CCore/inc/ElementPool.h>
+#include <CCore/inc/SpawnProcess.h>
+
+namespace App {
+
+/* using */
+
+using namespace CCore;
+
+namespace VMake {
+
+/* classes */
+
+struct RuleUsage;
+
+class UsageLog;
+
+/* struct RuleUsage */
+
+struct RuleUsage
+ {
+  uint64 wall = 0 ; // usec , sum over processes
+  uint64 user_time = 0 ; // usec
+  uint64 sys_time = 0 ; // usec
+  uint64 max_rss = 0 ; // KByte , max over processes
+  uint64 read_bytes = 0 ;
+  uint64 write_bytes = 0 ;
+  ulen procs = 0 ;
+
+  void add(const SpawnUsage &usage,uint64 wall_)
+   {
+    wall+=wall_;
+    user_time+=usage.user_time;
+    sys_time+=usage.sys_time;
+    max_rss=Max(max_rss,usage.max_rss);
+    read_bytes+=usage.read_bytes;
+    write_bytes+=usage.write_bytes;
+    procs++;
+   }
+
+  uint64 getCPU() const { return user_time+sys_time; }
+ };
+
+/* class UsageLog */
+
+ //
+ // Resource usage of rule processes, collected when children are reaped.
+ // report() prints the heaviest rules by CPU time, save() writes all rules in CSV.
+ //
+
+class UsageLog : NoCopy
+ {
+   ElementPool pool;
+
+   struct Rec
+    {
+     StrLen name;
+     StrLen wdir;
+     RuleUsage usage;
+    };
+
+   DynArray<Rec> list;
+
+   static constexpr ulen TopCount = 20 ;
+
+  public:
+
+   UsageLog();
+
+   ~UsageLog();
+
+   void add(StrLen name,StrLen wdir,const RuleUsage &usage); // rules without processes are skipped
+
+   void report();
+
+   void save(StrLen file_name); // the list is cleared
+ };
+
+} // namespace VMake
+} // namespace App
+
+#endif
+
@@ -18,6 +18,12 @@ struct TypeDefCore
   struct S12; // #Cmd 
   struct S13; // #Exe 
   struct S14; // #Target 
+  struct S15; // #Includes 
+  struct S16; // #Pool 
+  struct S17; // #Copy 
+  struct S18; // #Touch 
+  struct S19; // #Link 
+  struct S20; // #Stamp 
 
 
 
@@ -56,6 +62,10 @@ struct TypeDefCore
     DDL::MapRange< DDL::MapPtr< S14 > > src;
     DDL::MapRange< DDL::MapPtr< S14 > > dst;
     DDL::MapRange< DDL::MapPolyPtr< S13 , S12 , S10 , S5 > > cmd;
+    DDL::MapText depfile;
+    DDL::MapPtr< S15 > inc;
+    DDL::MapPtr< S16 > pool;
+    DDL::uint_type weight;
 
     struct Ext;
 
@@ -65,7 +75,7 @@ struct TypeDefCore
   struct S5
    {
     DDL::MapText echo;
-    DDL::MapPolyPtr< S9 , S8 , S7 , S6 > cmd;
+    DDL::MapPolyPtr< S9 , S8 , S7 , S6 , S17 , S18 , S19 , S20 > cmd;
     DDL::MapText wdir;
 
     struct Ext;
@@ -150,6 +160,52 @@ struct TypeDefCore
     ulen ext;
    };
 
+  struct S15
+   {
+    DDL::MapRange< DDL::MapText > path;
+
+    struct Ext;
+   };
+
+  struct S16
+   {
+    DDL::MapText name;
+    DDL::uint_type capacity;
+
+    struct Ext;
+   };
+
+  struct S17
+   {
+    DDL::MapRange< DDL::MapText > files;
+    DDL::MapText dst;
+
+    struct Ext;
+   };
+
+  struct S18
+   {
+    DDL::MapRange< DDL::MapText > files;
+
+    struct Ext;
+   };
+
+  struct S19
+   {
+    DDL::MapRange< DDL::MapText > files;
+    DDL::MapText dst;
+    DDL::uint_type sym;
+
+    struct Ext;
+   };
+
+  struct S20
+   {
+    DDL::MapText file;
+
+    struct Ext;
+   };
+
   // extra
 
  };
@@ -172,6 +228,12 @@ namespace TypeDef {
     using VMake = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S10 ;
     using MenuItem = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S1 ;
     using Mkdir = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S6 ;
+    using Includes = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S15 ;
+    using Pool = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S16 ;
+    using Copy = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S17 ;
+    using Touch = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S18 ;
+    using Link = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S19 ;
+    using Stamp = XXX212CD757_09B3_4D89_BE20_65C1E4E5A819::S20 ;
 
 } // namespace TypeDef
 
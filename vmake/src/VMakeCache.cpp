@@ -0,0 +1,332 @@
+/* VMakeCache.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeCache.h>
+
+#include <CCore/inc/FileToMem.h>
+#include <CCore/inc/Path.h>
+#include <CCore/inc/CharProp.h>
+#include <CCore/inc/Sort.h>
+
+#include <CCore/inc/Print.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* class ArtifactCache */
+
+String ArtifactCache::entryDir(uint64 key) const
+ {
+  return Stringf("#;/#16.16i;",dir,key);
+ }
+
+String ArtifactCache::entryFile(StrLen entry_dir,ulen ind) const
+ {
+  return Stringf("#;/#;",entry_dir,ind);
+ }
+
+auto ArtifactCache::add(uint64 key,uint64 size,uint64 stamp) -> Node *
+ {
+  TreeAlgo::PrepareIns prepare(root,key);
+
+  if( Node *node=prepare.found )
+    {
+     total_size-=node->size;
+
+     node->size=size;
+     node->stamp=stamp;
+
+     total_size+=size;
+
+     return node;
+    }
+
+  Node *node=pool.create<Node>();
+
+  node->size=size;
+  node->stamp=stamp;
+
+  prepare.complete(node);
+
+  list.append_copy(node);
+
+  total_size+=size;
+
+  return node;
+ }
+
+void ArtifactCache::remove(Node *node)
+ {
+  root.del(node);
+
+  total_size-=node->size;
+
+  node->size=0;
+  node->stamp=0;
+
+  changed=true;
+
+  try
+    {
+     String entry_dir=entryDir(node->link.key);
+
+     if( fs.getFileType(Range(entry_dir))==FileType_dir ) fs.deleteDir(Range(entry_dir),true);
+    }
+  catch(CatchType)
+    {
+    }
+ }
+
+void ArtifactCache::restoreFile(StrLen src,StrLen dst)
+ {
+  SplitPath split1(dst);
+  SplitName split2(split1.path);
+
+  StrLen dst_dir=dst.prefix(split1.dev.len+split2.path.len);
+
+  WalkPath(dst_dir, [&] (StrLen dir)
+                        {
+                         if( fs.getFileType(dir)!=FileType_dir ) fs.createDir(dir);
+
+                        } );
+
+  if( fs.getFileType(dst)==FileType_file ) fs.deleteFile(dst);
+
+  try
+    {
+     SilentReportException report;
+
+     fs.linkFile(src,dst,false);
+
+     // the restored file must be newer than sources
+
+     fs.touchFile(dst);
+
+     return;
+    }
+  catch(CatchType)
+    {
+     // another file system, copy
+    }
+
+  fs.copyFile(src,dst);
+ }
+
+void ArtifactCache::load()
+ {
+  String index=Stringf("#;/index",dir);
+
+  if( fs.getFileType(Range(index))!=FileType_file ) return;
+
+  FileToMem map(Range(index));
+
+  StrLen text=Mutate<const char>(Range(map.getPtr(),map.getLen()));
+
+  auto parse = [&] (StrLen &line,uint64 &ret) -> bool
+                   {
+                    ret=0;
+
+                    while( +line && *line==' ' ) ++line;
+
+                    if( !line || charDecValue(*line)<0 ) return false;
+
+                    for(int dig; +line && (dig=charDecValue(*line))>=0 ;++line) ret=10*ret+unsigned(dig);
+
+                    return true;
+                   } ;
+
+  while( +text )
+    {
+     ulen len=0;
+
+     while( len<text.len && text[len]!='\n' ) len++;
+
+     StrLen line=text.prefix(len);
+
+     text+=Min(len+1,text.len);
+
+     uint64 key,size,stamp;
+
+     if( parse(line,key) && parse(line,size) && parse(line,stamp) )
+       {
+        add(key,size,stamp);
+
+        Replace_max(next_stamp,stamp+1);
+       }
+    }
+ }
+
+void ArtifactCache::evict()
+ {
+  if( total_size<=max_size ) return;
+
+  DynArray<Node *> temp(DoReserve,list.getLen());
+
+  for(Node *node : list ) if( node->stamp ) temp.append_copy(node);
+
+  IncrSort(Range(temp), [] (Node *a,Node *b) { return a->stamp<b->stamp; } );
+
+  for(Node *node : temp )
+    {
+     if( total_size<=max_size ) break;
+
+     remove(node);
+
+     evict_count++;
+    }
+ }
+
+void ArtifactCache::save()
+ {
+  if( !changed ) return;
+
+  try
+    {
+     PrintFile out(Range(Stringf("#;/index",dir)),Open_ToWrite|Open_AutoDelete);
+
+     for(Node *node : list ) if( node->stamp ) Printf(out,"#; #; #;\n",node->link.key,node->size,node->stamp);
+
+     out.preserveFile();
+
+     changed=false;
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save cache index #.q;\n",dir);
+    }
+ }
+
+ArtifactCache::ArtifactCache(StrLen dir_,uint64 max_size_)
+ : dir(dir_),
+   max_size(max_size_)
+ {
+  if( fs.getFileType(dir_)!=FileType_dir ) fs.createDir(dir_);
+
+  load();
+ }
+
+ArtifactCache::~ArtifactCache()
+ {
+ }
+
+bool ArtifactCache::restore(uint64 key,PtrLen<const String> files)
+ {
+  Node *node=root.find(key);
+
+  if( !node )
+    {
+     miss_count++;
+
+     return false;
+    }
+
+  String entry_dir;
+  DynArray<String> entry_files;
+
+  try
+    {
+     entry_dir=entryDir(key);
+
+     entry_files.extend_default(files.len);
+
+     for(ulen ind=0; ind<files.len ;ind++)
+       {
+        entry_files[ind]=entryFile(Range(entry_dir),ind);
+
+        if( fs.getFileType(Range(entry_files[ind]))!=FileType_file )
+          {
+           Printf(Exception,"vmake : broken cache entry #.q;",entry_dir);
+          }
+       }
+    }
+  catch(CatchType)
+    {
+     remove(node);
+
+     miss_count++;
+
+     return false;
+    }
+
+  try
+    {
+     for(ulen ind=0; ind<files.len ;ind++) restoreFile(Range(entry_files[ind]),Range(files[ind]));
+    }
+  catch(CatchType)
+    {
+     // the entry is valid, the failure is on the destination side
+
+     miss_count++;
+
+     return false;
+    }
+
+  node->stamp=next_stamp++;
+
+  changed=true;
+
+  hit_count++;
+
+  return true;
+ }
+
+void ArtifactCache::store(uint64 key,PtrLen<const String> files)
+ {
+  String entry_dir=entryDir(key);
+  String temp_dir=Stringf("#;.temp",entry_dir);
+
+  try
+    {
+     if( Node *node=root.find(key) ) remove(node);
+
+     if( fs.getFileType(Range(temp_dir))==FileType_dir ) fs.deleteDir(Range(temp_dir),true);
+
+     fs.createDir(Range(temp_dir));
+
+     uint64 size=0;
+
+     for(ulen ind=0; ind<files.len ;ind++)
+       {
+        fs.copyFile(Range(files[ind]),Range(entryFile(Range(temp_dir),ind)));
+
+        size+=fs.getFileStatus(Range(files[ind])).len;
+       }
+
+     fs.rename(Range(temp_dir),Range(entry_dir),false);
+
+     add(key,size,next_stamp++);
+
+     changed=true;
+
+     store_count++;
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot store cache entry #.q;\n",entry_dir);
+    }
+ }
+
+void ArtifactCache::finish()
+ {
+  evict();
+
+  save();
+
+  Printf(Con,"vmake : cache hit #; , miss #; , stored #; , evicted #; , size #; / #; KByte\n",
+             hit_count,miss_count,store_count,evict_count,total_size/1024,max_size/1024);
+ }
+
+} // namespace VMake
+} // namespace App
+
@@ -12,9 +12,14 @@
 //----------------------------------------------------------------------------------------
 
 #include <inc/VMakeData.h>
+#include <inc/VMakeHash.h>
 
 #include <CCore/inc/FileName.h>
 #include <CCore/inc/FileToMem.h>
+#include <CCore/inc/RawFileToRead.h>
+#include <CCore/inc/FileSystem.h>
+#include <CCore/inc/String.h>
+#include <CCore/inc/Sort.h>
 
 #include <CCore/inc/Print.h>
 #include <CCore/inc/Exception.h>
@@ -27,6 +32,233 @@ namespace VMake {
 
 #include "vmake.TypeSet.gen.h"
 
+/* struct LoadFileText */
+
+struct LoadFileText : FileToMem
+ {
+  LoadFileText(StrLen file_name,ulen max_len,DynArray<String> *files)
+   : FileToMem(file_name,max_len)
+   {
+    files->append_fill(file_name);
+   }
+ };
+
+/* class DataFile::RelocList */
+
+class DataFile::RelocList : NoCopy
+ {
+   const uint8 *base;
+   ulen len;
+
+   DynArray<uint64> list;
+   bool ok = true ;
+
+  private:
+
+   bool inBlock(const void *ptr_,ulen size) const
+    {
+     const uint8 *ptr=static_cast<const uint8 *>(ptr_);
+
+     return ptr>=base && ptr<=base+len && size<=ulen(base+len-ptr) ;
+    }
+
+   template <class T>
+   void site(T *const *pos)
+    {
+     if( !*pos ) return;
+
+     if( inBlock(pos,sizeof (void *)) && inBlock(*pos,0) )
+       list.append_copy(uint64( reinterpret_cast<const uint8 *>(pos)-base ));
+     else
+       ok=false;
+    }
+
+   void add(const DDL::MapText &obj) { site(&obj.ptr); }
+
+   template <class T>
+   void add(const DDL::MapRange<T> &obj)
+    {
+     site(&obj.ptr);
+
+     if( !obj.ptr ) return;
+
+     if( !inBlock(obj.ptr,LenOf(obj.len,sizeof (T))) )
+       {
+        ok=false;
+
+        return;
+       }
+
+     for(const T &elem : obj.getRange() ) add(elem);
+    }
+
+   template <class T>
+   void add(const DDL::MapPtr<T> &obj)
+    {
+     site(&obj.ptr);
+
+     if( obj.ptr ) add(*obj.getPtr());
+    }
+
+   template <class ... TT>
+   void add(const DDL::MapPolyPtr<TT...> &obj)
+    {
+     site(&obj.ptr);
+
+     obj.getPtr().apply( [&] (auto *ptr) { if( ptr ) add(*ptr); } );
+    }
+
+   void add(const TypeDef::Env &obj)
+    {
+     add(obj.name);
+     add(obj.value);
+    }
+
+   void add(const TypeDef::Echo &obj)
+    {
+     add(obj.strs);
+     add(obj.outfile);
+    }
+
+   void add(const TypeDef::Cat &obj)
+    {
+     add(obj.files);
+     add(obj.outfile);
+    }
+
+   void add(const TypeDef::Rm &obj)
+    {
+     add(obj.files);
+    }
+
+   void add(const TypeDef::Mkdir &obj)
+    {
+     add(obj.paths);
+    }
+
+   void add(const TypeDef::Copy &obj)
+    {
+     add(obj.files);
+     add(obj.dst);
+    }
+
+   void add(const TypeDef::Touch &obj)
+    {
+     add(obj.files);
+    }
+
+   void add(const TypeDef::Link &obj)
+    {
+     add(obj.files);
+     add(obj.dst);
+    }
+
+   void add(const TypeDef::Stamp &obj)
+    {
+     add(obj.file);
+    }
+
+   void add(const TypeDef::Exe &obj)
+    {
+     add(obj.echo);
+     add(obj.exe);
+     add(obj.args);
+     add(obj.wdir);
+     add(obj.env);
+    }
+
+   void add(const TypeDef::Cmd &obj)
+    {
+     add(obj.echo);
+     add(obj.cmdline);
+     add(obj.wdir);
+     add(obj.env);
+    }
+
+   void add(const TypeDef::VMake &obj)
+    {
+     add(obj.echo);
+     add(obj.file);
+     add(obj.target);
+     add(obj.wdir);
+    }
+
+   void add(const TypeDef::IntCmd &obj)
+    {
+     add(obj.echo);
+     add(obj.cmd);
+     add(obj.wdir);
+    }
+
+  public:
+
+   RelocList(const void *base_,ulen len_) : base(static_cast<const uint8 *>(base_)),len(len_) {}
+
+   bool isOk() const { return ok; }
+
+   uint64 offset(const void *ptr)
+    {
+     if( !inBlock(ptr,1) )
+       {
+        ok=false;
+
+        return 0;
+       }
+
+     return uint64( static_cast<const uint8 *>(ptr)-base );
+    }
+
+   void add(const TypeDef::Target &obj)
+    {
+     add(obj.desc);
+     add(obj.file);
+    }
+
+   void add(const TypeDef::Includes &obj)
+    {
+     add(obj.path);
+    }
+
+   void add(const TypeDef::Pool &obj)
+    {
+     add(obj.name);
+    }
+
+   void add(const TypeDef::Rule &obj)
+    {
+     add(obj.src);
+     add(obj.dst);
+     add(obj.cmd);
+     add(obj.depfile);
+     add(obj.inc);
+     add(obj.pool);
+    }
+
+   void add(const TypeDef::Dep &obj)
+    {
+     add(obj.src);
+     add(obj.dst);
+    }
+
+   PtrLen<const uint64> complete() // sorted, no duplicates
+    {
+     Sort(Range(list));
+
+     ulen count=0;
+
+     for(uint64 off : list )
+       {
+        if( count && list[count-1]==off ) continue;
+
+        list[count++]=off;
+       }
+
+     list.shrink(list.getLen()-count);
+
+     return Range(list);
+    }
+ };
+
 /* class DataFile */
 
 StrLen DataFile::Pretext()
@@ -38,18 +270,45 @@ StrLen DataFile::Pretext()
   ""_c;
  }
 
-DataFile::DataFile(StrLen file_name,StrLen target_name)
+uint64 DataFile::PretextSig()
+ {
+  ContentHash hash;
+
+  hash.add(Pretext());
+  hash.add(uint64(sizeof (TypeDef::Rule)));
+  hash.add(uint64(sizeof (TypeDef::Exe)));
+
+  return hash.finish();
+ }
+
+template <class Func>
+void DataFile::load(StrLen file_name,Func func)
  {
   // process
 
   PrintCon eout;
 
-  DDL::FileEngine<FileName,FileToMem> engine(eout);
+  DynArray<String> *files_=&files;
+
+  DDL::FileEngine<FileName,LoadFileText,DynArray<String> *> engine(files_,eout);
+
+  uint64 start=( tracer ? tracer->now() : 0 );
+
+  auto result=engine.process(file_name,Pretext(), [&] ()
+                                                      {
+                                                       if( tracer )
+                                                         {
+                                                          tracer->complete("ddl"_c,"parse"_c,start);
 
-  auto result=engine.process(Range(file_name),Pretext());
+                                                          start=tracer->now();
+                                                         }
+
+                                                      } );
 
   eout.flush();
 
+  if( tracer ) tracer->complete("ddl"_c,"eval"_c,start);
+
   if( !result )
     {
      Printf(Exception,"vmake file #.q; : load failed",file_name);
@@ -57,21 +316,20 @@ DataFile::DataFile(StrLen file_name,StrLen target_name)
 
   // map
 
+  if( tracer ) start=tracer->now();
+
   DDL::TypedMap<TypeSet> map(result);
   MemAllocGuard guard(map.getLen());
 
   map(guard);
 
-  // extract
+  if( tracer ) tracer->complete("ddl"_c,"map"_c,start);
 
-  target=map.findConst<TypeDef::Target>(target_name);
+  // extract
 
-  if( !target )
-    {
-     Printf(Exception,"vmake file #.q; : no target variable #.q;",file_name,target_name);
-    }
+  func(result,map);
 
-  struct Func
+  struct ListFunc
    {
     Collector<TypeDef::Rule *> rule_list;
     Collector<TypeDef::Dep *> dep_list;
@@ -81,16 +339,336 @@ DataFile::DataFile(StrLen file_name,StrLen target_name)
     void operator () (TypeDef::Dep *ptr) { dep_list.append_copy(ptr); }
    };
 
-  Func func;
+  ListFunc list_func;
+
+  map.applyFor(map.getFilter<TypeDef::Rule,TypeDef::Dep>(),FunctorRef(list_func));
+
+  // build tables
+
+  list_func.rule_list.extractTo(rules);
+  list_func.dep_list.extractTo(deps);
+
+  mem=guard.disarm();
+  mem_len=map.getLen();
+ }
+
+void DataFile::loadText(StrLen file_name,StrLen target_name,bool named)
+ {
+  load(file_name, [&] (DDL::EngineResult result,const DDL::TypedMap<TypeSet> &map)
+                      {
+                       target=map.findConst<TypeDef::Target>(target_name);
+
+                       if( !target )
+                         {
+                          Printf(Exception,"vmake file #.q; : no target variable #.q;",file_name,target_name);
+                         }
+
+                       if( !named ) return;
+
+                       for(auto &rec : result.eval->const_table )
+                         {
+                          String name=Stringf("#;",DDL::PrintName(rec.node));
+
+                          StrLen str=Range(name);
+
+                          if( +str && str[0]=='#' ) ++str; // skip the root scope mark
+
+                          if( TypeDef::Target *ptr=map.findConst<TypeDef::Target>(str) ) addName(str,ptr);
+                         }
+
+                      } );
+ }
+
+void DataFile::addName(StrLen name,TypeDef::Target *ptr)
+ {
+  StrKey key(name);
+
+  TreeAlgo::PrepareIns prepare(root,key);
+
+  if( prepare.found ) return;
+
+  StrLen str=pool.dup(name);
+
+  TargetNode *node=pool.create<TargetNode>();
+
+  node->target=ptr;
+
+  prepare.complete(node);
+
+  node->link.key.str=str;
+
+  names.append_copy(node);
+ }
+
+bool DataFile::loadImage(StrLen image_name,StrLen file_name)
+ {
+  FileSystem fs;
+
+  if( fs.getFileType(image_name)!=FileType_file ) return false;
+
+  RawFileToRead file(image_name,Open_Read|Open_Pos);
+
+  FilePosType file_len=file.getLen();
+
+  ImageHeader h;
+
+  if( file_len<sizeof h ) return false;
+
+  file.read_all(reinterpret_cast<uint8 *>(&h),sizeof h);
+
+  if( h.magic!=ImageMagic || h.version!=ImageVersion || h.ptr_len!=sizeof (void *) || h.sig!=PretextSig() ) return false;
+
+  // sizes
+
+  const uint64 MaxCount = MaxULen/64 ;
+
+  if( h.block_len>MaxULen || h.reloc_count>MaxCount || h.rule_count>MaxCount || h.dep_count>MaxCount ||
+      h.name_count>MaxCount || h.file_count>MaxCount || h.text_len>MaxULen ) return false;
+
+  uint64 meta_len=h.file_count*sizeof (ImageFileRec)+h.name_count*sizeof (ImageNameRec)+(h.rule_count+h.dep_count+h.reloc_count)*sizeof (uint64);
+
+  if( meta_len+h.text_len>MaxULen || file_len!=sizeof h+meta_len+h.text_len+h.block_len ) return false;
+
+  SimpleArray<uint8> meta(ulen(meta_len+h.text_len));
+
+  file.read_all(meta.getPtr(),meta.getLen());
+
+  const ImageFileRec *file_list=reinterpret_cast<const ImageFileRec *>(meta.getPtr());
+  const ImageNameRec *name_list=reinterpret_cast<const ImageNameRec *>(file_list+h.file_count);
+  const uint64 *table=reinterpret_cast<const uint64 *>(name_list+h.name_count);
+  const uint64 *reloc=table+h.rule_count+h.dep_count;
+  const char *text=reinterpret_cast<const char *>(reloc+h.reloc_count);
+
+  auto getName = [&] (uint64 off,uint64 len) -> StrLen
+                     {
+                      if( off>h.text_len || len>h.text_len-off ) return Empty;
+
+                      return StrLen(text+off,ulen(len));
+                     } ;
+
+  // check files
+
+  if( !h.file_count || !getName(file_list[0].name_off,file_list[0].name_len).equal(file_name) ) return false;
+
+  for(const ImageFileRec &rec : Range(file_list,ulen(h.file_count)) )
+    {
+     StrLen name=getName(rec.name_off,rec.name_len);
+
+     if( !name ) return false;
 
-  map.applyFor(map.getFilter<TypeDef::Rule,TypeDef::Dep>(),FunctorRef(func));
+     FileStatus status=fs.getFileStatus(name);
+
+     if( status.type!=FileType_file || status.time!=rec.time || status.len!=rec.len || status.id!=rec.id ) return false;
+    }
+
+  // check offsets
+
+  ulen block_len=ulen(h.block_len);
+
+  auto checkObj = [&] (uint64 off,ulen size) { return off<block_len && size<=block_len-off && off%alignof (void *)==0 ; } ;
+
+  if( !checkObj(h.target,sizeof (TypeDef::Target)) ) return false;
+
+  for(uint64 off : Range(table,ulen(h.rule_count)) ) if( !checkObj(off,sizeof (TypeDef::Rule)) ) return false;
+
+  for(uint64 off : Range(table+h.rule_count,ulen(h.dep_count)) ) if( !checkObj(off,sizeof (TypeDef::Dep)) ) return false;
+
+  for(uint64 off : Range(reloc,ulen(h.reloc_count)) ) if( !checkObj(off,sizeof (void *)) ) return false;
+
+  for(const ImageNameRec &rec : Range(name_list,ulen(h.name_count)) )
+    {
+     if( !checkObj(rec.target,sizeof (TypeDef::Target)) || !getName(rec.name_off,rec.name_len) ) return false;
+    }
+
+  // load block
+
+  MemAllocGuard guard(block_len);
+
+  uint8 *base=static_cast<uint8 *>((void *)guard);
+
+  file.read_all(base,block_len);
+
+  for(uint64 off : Range(reloc,ulen(h.reloc_count)) )
+    {
+     ulen val=*reinterpret_cast<const ulen *>(base+off);
+
+     if( val>block_len ) return false;
+
+     *reinterpret_cast<void **>(base+off)=base+val;
+    }
 
   // build tables
 
-  func.rule_list.extractTo(rules);
-  func.dep_list.extractTo(deps);
+  for(uint64 off : Range(table,ulen(h.rule_count)) ) rules.append_copy(reinterpret_cast<TypeDef::Rule *>(base+off));
+
+  for(uint64 off : Range(table+h.rule_count,ulen(h.dep_count)) ) deps.append_copy(reinterpret_cast<TypeDef::Dep *>(base+off));
+
+  for(const ImageFileRec &rec : Range(file_list,ulen(h.file_count)) ) files.append_fill(getName(rec.name_off,rec.name_len));
+
+  for(const ImageNameRec &rec : Range(name_list,ulen(h.name_count)) ) addName(getName(rec.name_off,rec.name_len),reinterpret_cast<TypeDef::Target *>(base+rec.target));
+
+  target=reinterpret_cast<TypeDef::Target *>(base+h.target);
 
   mem=guard.disarm();
+  mem_len=block_len;
+
+  return true;
+ }
+
+void DataFile::saveImage(StrLen image_name) const
+ {
+  try
+    {
+     FileSystem fs;
+
+     RelocList list(mem,mem_len);
+
+     ImageHeader h{ImageMagic,ImageVersion,sizeof (void *),0,PretextSig(),0,mem_len,0,rules.getLen(),deps.getLen(),names.getLen(),files.getLen(),0};
+
+     h.target=list.offset(target);
+
+     list.add(*target);
+
+     DynArray<uint64> table;
+
+     for(TypeDef::Rule *rule : rules )
+       {
+        table.append_copy(list.offset(rule));
+
+        list.add(*rule);
+       }
+
+     for(TypeDef::Dep *dep : deps )
+       {
+        table.append_copy(list.offset(dep));
+
+        list.add(*dep);
+       }
+
+     DynArray<ImageNameRec> name_list;
+
+     for(TargetNode *node : names )
+       {
+        StrLen name=node->link.key.str;
+
+        name_list.append_fill(ImageNameRec{list.offset(node->target),h.text_len,name.len});
+
+        h.text_len+=name.len;
+
+        list.add(*node->target);
+       }
+
+     DynArray<ImageFileRec> file_list;
+
+     for(const String &file : files )
+       {
+        FileStatus status=fs.getFileStatus(Range(file));
+
+        file_list.append_fill(ImageFileRec{uint64(status.time),uint64(status.len),status.id,h.text_len,file.getLen()});
+
+        h.text_len+=file.getLen();
+       }
+
+     PtrLen<const uint64> reloc=list.complete();
+
+     h.reloc_count=reloc.len;
+
+     if( !list.isOk() )
+       {
+        Printf(Con,"vmake : cannot build graph image #.q;\n",image_name);
+
+        return;
+       }
+
+     // relocatable block
+
+     SimpleArray<uint8> block(mem_len);
+
+     Range(block).copy(static_cast<const uint8 *>(mem));
+
+     for(uint64 off : reloc )
+       {
+        uint8 *pos=block.getPtr()+off;
+
+        *reinterpret_cast<ulen *>(pos)=ulen( *reinterpret_cast<uint8 **>(pos)-static_cast<uint8 *>(mem) );
+       }
+
+     // write
+
+     PrintFile out(image_name,Open_ToWrite|Open_AutoDelete);
+
+     auto put = [&] (const auto &obj) { out.put(reinterpret_cast<const char *>(&obj),sizeof obj); } ;
+
+     auto putRange = [&] (auto r) { out.put(reinterpret_cast<const char *>(r.ptr),r.len*sizeof (*r.ptr)); } ;
+
+     put(h);
+
+     putRange(Range(file_list));
+     putRange(Range(name_list));
+     putRange(Range(table));
+     putRange(reloc);
+
+     for(TargetNode *node : names ) Putobj(out,node->link.key.str);
+
+     for(const String &file : files ) Putobj(out,file);
+
+     putRange(Range(block));
+
+     out.preserveFile();
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save graph image #.q;\n",image_name);
+    }
+ }
+
+DataFile::DataFile(StrLen file_name,StrLen target_name,bool named,bool image,Tracer *tracer_)
+ : tracer(tracer_)
+ {
+  if( image )
+    {
+     String image_name=StringCat(file_name,".image"_c);
+
+     bool ok=false;
+
+     try
+       {
+        SilentReportException report;
+
+        TraceScope scope(tracer,"ddl"_c,"load image"_c);
+
+        ok=loadImage(Range(image_name),file_name);
+       }
+     catch(CatchType)
+       {
+       }
+
+     if( ok )
+       {
+        if( TypeDef::Target *ptr=findTarget(target_name) )
+          {
+           target=ptr;
+          }
+        else
+          {
+           MemFree(Replace_null(mem)); // the destructor is not called
+
+           Printf(Exception,"vmake file #.q; : no target variable #.q;",file_name,target_name);
+          }
+
+        return;
+       }
+
+     loadText(file_name,target_name,true);
+
+     TraceScope scope(tracer,"ddl"_c,"save image"_c);
+
+     saveImage(Range(image_name));
+    }
+  else
+    {
+     loadText(file_name,target_name,named);
+    }
  }
 
 DataFile::~DataFile()
@@ -98,6 +676,37 @@ DataFile::~DataFile()
   MemFree(Replace_null(mem));
  }
 
+void DataFile::clearExt(TypeDef::Target *root) const
+ {
+  auto clear = [] (TypeDef::Target *ptr) { if( ptr ) ptr->ext=0; } ;
+
+  auto clearRange = [&] (auto *obj)
+                        {
+                         for(TypeDef::Target *ptr : obj->src.getRange() ) clear(ptr);
+
+                         for(TypeDef::Target *ptr : obj->dst.getRange() ) clear(ptr);
+                        } ;
+
+  clear(root);
+  clear(target);
+
+  for(TypeDef::Rule *rule : rules )
+    {
+     rule->ext=0;
+
+     clearRange(rule);
+    }
+
+  for(TypeDef::Dep *dep : deps ) clearRange(dep);
+ }
+
+TypeDef::Target * DataFile::findTarget(StrLen target_name) const
+ {
+  if( TargetNode *node=root.find(StrKey(target_name)) ) return node->target;
+
+  return 0;
+ }
+
 } // namespace VMake
 } // namespace App
 
@@ -0,0 +1,394 @@
+/* VMakeDepLog.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeDepLog.h>
+
+#include <CCore/inc/FileSystem.h>
+#include <CCore/inc/Print.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* class DepFile */
+
+bool DepFile::IsSep(PtrLen<const char> cur)
+ {
+  return *cur==':' && ( cur.len==1 || IsSpace(cur[1]) || IsEOL(cur[1]) || cur[1]=='\\' ) ;
+ }
+
+StrLen DepFile::name(PtrLen<const char> &cur)
+ {
+  const char *start=cur.ptr;
+
+  // plain name, no copy
+
+  for(; +cur ;++cur)
+    {
+     char ch=*cur;
+
+     if( IsSpace(ch) || IsEOL(ch) || IsSep(cur) ) return StrLen(start,ulen(cur.ptr-start));
+
+     if( ch=='\\' || ch=='$' ) break;
+    }
+
+  if( !cur ) return StrLen(start,ulen(cur.ptr-start));
+
+  // escaped name
+
+  temp.erase();
+
+  temp.extend_copy(ulen(cur.ptr-start),start);
+
+  for(; +cur ;++cur)
+    {
+     char ch=*cur;
+
+     if( IsSpace(ch) || IsEOL(ch) || IsSep(cur) ) break;
+
+     if( ch=='\\' && cur.len>1 )
+       {
+        char next=cur[1];
+
+        if( IsEOL(next) ) break;
+
+        if( IsSpace(next) || next=='#' || next=='\\' )
+          {
+           ++cur;
+
+           ch=next;
+          }
+       }
+     else if( ch=='$' && cur.len>1 && cur[1]=='$' )
+       {
+        ++cur;
+       }
+
+     temp.append_copy(ch);
+    }
+
+  return Range(temp);
+ }
+
+DepFile::DepFile(StrLen file_name)
+ : text(file_name)
+ {
+ }
+
+DepFile::~DepFile()
+ {
+ }
+
+/* class DepLog */
+
+bool DepLog::checkKey(const KeyRec &rec) const
+ {
+  return checkName(rec.name_off,rec.name_len) && rec.ref_off<=header->ref_count && rec.ref_count<=header->ref_count-rec.ref_off ;
+ }
+
+auto DepLog::find(StrLen name) const -> const KeyRec *
+ {
+  if( !header ) return 0;
+
+  StrKey key(name);
+
+  uint32 mask=header->slot_count-1;
+
+  for(uint32 ind=key.hash&mask,cnt=header->slot_count; cnt ;cnt--,ind=(ind+1)&mask)
+    {
+     uint32 s=slot[ind];
+
+     if( !s ) return 0;
+
+     if( s<=header->key_count )
+       {
+        const KeyRec &rec=key_list[s-1];
+
+        if( rec.hash==key.hash && checkKey(rec) && name.equal(getName(rec.name_off,rec.name_len)) ) return &rec;
+       }
+    }
+
+  return 0;
+ }
+
+void DepLog::load()
+ {
+  FileSystem fs;
+
+  if( fs.getFileType(Range(file_name))!=FileType_file ) return;
+
+  image=FileToMem(Range(file_name));
+
+  const uint8 *base=image.getPtr();
+  ulen len=image.getLen();
+
+  if( len<sizeof (Header) ) return;
+
+  const Header *h=reinterpret_cast<const Header *>(base);
+
+  if( h->magic!=Magic || h->version!=Version ) return;
+
+  uint32 slot_count=h->slot_count;
+
+  if( !slot_count || (slot_count&(slot_count-1)) ) return;
+
+  uint64 total=sizeof (Header)+uint64(slot_count)*sizeof (uint32)+uint64(h->key_count)*sizeof (KeyRec)+uint64(h->name_count)*sizeof (NameRec)+
+               uint64(h->ref_count)*sizeof (uint32)+h->text_len;
+
+  if( total!=len ) return;
+
+  const uint8 *ptr=base+sizeof (Header);
+
+  slot=reinterpret_cast<const uint32 *>(ptr);
+
+  ptr+=slot_count*sizeof (uint32);
+
+  key_list=reinterpret_cast<const KeyRec *>(ptr);
+
+  ptr+=h->key_count*sizeof (KeyRec);
+
+  name_list=reinterpret_cast<const NameRec *>(ptr);
+
+  ptr+=h->name_count*sizeof (NameRec);
+
+  ref_list=reinterpret_cast<const uint32 *>(ptr);
+
+  ptr+=h->ref_count*sizeof (uint32);
+
+  text=reinterpret_cast<const char *>(ptr);
+
+  header=h;
+ }
+
+DepLog::DepLog(StrLen file_name_)
+ : file_name(file_name_)
+ {
+  try
+    {
+     load();
+    }
+  catch(CatchType)
+    {
+     header=0;
+    }
+ }
+
+DepLog::~DepLog()
+ {
+ }
+
+ // new log
+
+void DepLog::add(StrLen name,PtrLen<const String> names,const FileStatus &status)
+ {
+  StrKey key(name);
+
+  TreeAlgo::PrepareIns prepare(root,key);
+
+  Entry *entry=prepare.found;
+
+  if( !entry )
+    {
+     StrLen str=pool.dup(name);
+
+     entry=pool.create<Entry>();
+
+     prepare.complete(entry);
+
+     entry->link.key.str=str;
+
+     entries.append_copy(entry);
+    }
+
+  entry->names=pool.createArray<StrLen>(names.len);
+
+  for(ulen i=0; i<names.len ;i++) entry->names[i]=pool.dup(Range(names[i]));
+
+  entry->status=status;
+
+  // compare with the old record
+
+  if( !changed )
+    {
+     const KeyRec *rec=find(name);
+
+     if( !rec || rec->ref_count!=names.len || rec->time!=uint64(status.time) || rec->len!=uint64(status.len) )
+       {
+        changed=true;
+       }
+     else
+       {
+        ulen i=0;
+
+        apply(name, [&] (StrLen str) { if( i>=names.len || !str.equal(Range(names[i])) ) changed=true; i++; } );
+       }
+    }
+ }
+
+void DepLog::save()
+ {
+  if( !changed ) return;
+
+  struct NameNode : NoCopy
+   {
+    RBTreeLink<NameNode,StrKey> link;
+
+    uint32 index;
+   };
+
+  using NameAlgo = RBTreeLink<NameNode,StrKey>::Algo<&NameNode::link,const StrKey &> ;
+
+  ElementPool name_pool;
+  NameAlgo::Root name_root;
+
+  DynArray<StrLen> names;
+  DynArray<uint32> refs;
+  DynArray<KeyRec> keys;
+  DynArray<StrLen> key_names;
+
+  ulen text_len=0;
+
+  auto addText = [&] (StrLen str) -> uint32
+                     {
+                      uint32 ret=uint32(text_len);
+
+                      text_len+=str.len;
+
+                      return ret;
+                     } ;
+
+  auto addName = [&] (StrLen str)
+                     {
+                      StrKey key(str);
+
+                      NameAlgo::PrepareIns prepare(name_root,key);
+
+                      uint32 index;
+
+                      if( NameNode *node=prepare.found )
+                        {
+                         index=node->index;
+                        }
+                      else
+                        {
+                         node=name_pool.create<NameNode>();
+
+                         index=uint32(names.getLen());
+
+                         node->index=index;
+
+                         prepare.complete(node);
+
+                         names.append_copy(str);
+                        }
+
+                      refs.append_copy(index);
+                     } ;
+
+  auto addKey = [&] (StrLen name,uint64 time,uint64 len,auto apply_names)
+                    {
+                     uint32 ref_off=uint32(refs.getLen());
+
+                     apply_names(addName);
+
+                     StrKey key(name);
+
+                     keys.append_fill(KeyRec{time,len,key.hash,0,uint32(name.len),ref_off,uint32(refs.getLen()-ref_off),0});
+                     key_names.append_copy(name);
+                    } ;
+
+  for(Entry *entry : entries )
+    {
+     addKey(entry->link.key.str,uint64(entry->status.time),uint64(entry->status.len), [entry] (auto func) { for(StrLen str : entry->names ) func(str); } );
+    }
+
+  // records from the previous run, which are not replaced
+
+  if( header )
+    {
+     for(const KeyRec &rec : Range(key_list,header->key_count) )
+       {
+        if( !checkKey(rec) ) continue;
+
+        StrLen name=getName(rec.name_off,rec.name_len);
+
+        if( root.find(StrKey(name)) ) continue;
+
+        addKey(name,rec.time,rec.len, [&] (auto func) { apply(name,func); } );
+       }
+    }
+
+  // text offsets
+
+  for(ulen i=0; i<keys.getLen() ;i++) keys[i].name_off=addText(key_names[i]);
+
+  DynArray<NameRec> name_recs;
+
+  for(StrLen str : names ) name_recs.append_fill(NameRec{addText(str),uint32(str.len)});
+
+  // slots
+
+  ulen key_count=keys.getLen();
+  ulen slot_count=2;
+
+  while( slot_count<2*key_count ) slot_count*=2;
+
+  SimpleArray<uint32> slots(slot_count);
+
+  Range(slots).set_null();
+
+  {
+   uint32 mask=uint32(slot_count-1);
+
+   for(ulen i=0; i<key_count ;i++)
+     {
+      uint32 ind=keys[i].hash&mask;
+
+      while( slots[ind] ) ind=(ind+1)&mask;
+
+      slots[ind]=uint32(i+1);
+     }
+  }
+
+  try
+    {
+     PrintFile out(Range(file_name),Open_ToWrite|Open_AutoDelete);
+
+     auto put = [&] (const auto &obj) { out.put(reinterpret_cast<const char *>(&obj),sizeof obj); } ;
+
+     auto putRange = [&] (auto r) { out.put(reinterpret_cast<const char *>(r.ptr),r.len*sizeof (*r.ptr)); } ;
+
+     Header h{Magic,Version,uint32(slot_count),uint32(key_count),uint32(names.getLen()),uint32(refs.getLen()),uint32(text_len),0};
+
+     put(h);
+
+     putRange(Range(slots));
+     putRange(Range(keys));
+     putRange(Range(name_recs));
+     putRange(Range(refs));
+
+     for(StrLen str : key_names ) Putobj(out,str);
+
+     for(StrLen str : names ) Putobj(out,str);
+
+     out.preserveFile();
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save #.q;\n",file_name);
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
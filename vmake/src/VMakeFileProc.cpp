@@ -16,6 +16,8 @@
 #include <CCore/inc/ForLoop.h>
 #include <CCore/inc/Path.h>
 #include <CCore/inc/MakeFileName.h>
+#include <CCore/inc/sys/SysEnv.h>
+#include <CCore/inc/sys/SysProp.h>
 
 #include <CCore/inc/Print.h>
 #include <CCore/inc/Exception.h>
@@ -25,13 +27,11 @@ namespace VMake {
 
 /* SpawnCommand() */
 
-void SpawnCommand(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,SpawnSlot &slot)
+void SpawnCommand(const SpawnBase &base,SpawnArena &arena,StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,StrLen makeflags,SpawnSlot &slot)
  {
-  ShellPath shell;
+  StrLen exe_name=base.shell.get();
 
-  StrLen exe_name=shell.get();
-
-  SpawnProcess spawn(wdir,exe_name);
+  SpawnProcess spawn(wdir,exe_name,base.env,arena);
 
   SplitPath split1(exe_name);
   SplitName split2(split1.path);
@@ -42,14 +42,16 @@ void SpawnCommand(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,SpawnSlot
 
   for(TypeDef::Env obj : env ) spawn.addEnv(obj.name,obj.value);
 
+  if( +makeflags ) spawn.addEnv("MAKEFLAGS"_c,makeflags);
+
   spawn.spawn(slot);
  }
 
 /* SpawnExecute() */
 
-void SpawnExecute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,SpawnSlot &slot)
+void SpawnExecute(const SpawnBase &base,SpawnArena &arena,StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,StrLen makeflags,SpawnSlot &slot)
  {
-  SpawnProcess spawn(wdir,exe_file);
+  SpawnProcess spawn(wdir,exe_file,base.env,arena);
 
   spawn.addArg(exe_file);
 
@@ -57,6 +59,8 @@ void SpawnExecute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<T
 
   for(TypeDef::Env obj : env ) spawn.addEnv(obj.name,obj.value);
 
+  if( +makeflags ) spawn.addEnv("MAKEFLAGS"_c,makeflags);
+
   spawn.spawn(slot);
  }
 
@@ -118,7 +122,7 @@ void StopFlag::guard()
 /* struct ExeRule */
 
 template <class Func>
-bool ExeRule::start(Func func)
+bool ExeRule::start(bool merged,Func func)
  {
   if( status ) return false;
 
@@ -128,6 +132,8 @@ bool ExeRule::start(Func func)
 
      ++list;
 
+     if( merged && aptr.castPtr<TypeDef::VMake>() ) continue;
+
      bool ret=false;
 
      aptr.apply( [&] (auto *cmd) { if( cmd ) { func(cmd); ret=true; } } );
@@ -138,6 +144,31 @@ bool ExeRule::start(Func func)
   return false;
  }
 
+bool ExeRule::nextCmd(bool merged) const
+ {
+  if( status ) return false;
+
+  for(auto cur=list; +cur ;++cur)
+    {
+     auto aptr=cur->getPtr();
+
+     if( aptr.castPtr<TypeDef::VMake>() )
+       {
+        if( merged ) continue;
+
+        return false;
+       }
+
+     bool ret=false;
+
+     aptr.apply( [&] (auto *cmd) { if( cmd ) ret=true; } );
+
+     if( ret ) return true;
+    }
+
+  return false;
+ }
+
 TypeDef::VMake * ExeRule::getVMake()
  {
   if( status || !list ) return 0;
@@ -156,6 +187,102 @@ TypeDef::VMake * ExeRule::getVMake()
 
 /* class ExeList */
 
+ulen ExeList::findPool(TypeDef::Pool *pool)
+ {
+  for(ulen i=0,len=pools.getLen(); i<len ;i++) if( pools[i].pool==pool ) return i+1;
+
+  pools.append_fill(pool);
+
+  return pools.getLen();
+ }
+
+void ExeList::push(ExeRule *obj)
+ {
+  ulen ind=pending++;
+
+  heap[ind]=obj;
+
+  heapUp(ind);
+ }
+
+bool ExeList::acquire(ExeRule *obj)
+ {
+  if( !obj->pool ) return true;
+
+  Pool &pool=pools[obj->pool-1];
+
+  if( !pool.fit(obj->weight) )
+    {
+     pool.block(obj);
+
+     blocked++;
+
+     return false;
+    }
+
+  pool.used+=obj->weight;
+
+  return true;
+ }
+
+void ExeList::release(ExeRule *obj)
+ {
+  if( !obj->pool ) return;
+
+  Pool &pool=pools[obj->pool-1];
+
+  pool.used-=obj->weight;
+
+  // return blocked rules, which fit the released capacity
+
+  ulen avail=pool.capacity-pool.used;
+
+  while( pool.first && pool.first->weight<=avail )
+    {
+     ExeRule *next=pool.unblock();
+
+     blocked--;
+
+     avail-=next->weight;
+
+     push(next);
+    }
+ }
+
+void ExeList::heapUp(ulen ind)
+ {
+  while( ind )
+    {
+     ulen parent=(ind-1)/2;
+
+     if( !Less(heap[parent],heap[ind]) ) break;
+
+     Swap(heap[parent],heap[ind]);
+
+     ind=parent;
+    }
+ }
+
+void ExeList::heapDown(ulen ind)
+ {
+  for(;;)
+    {
+     ulen top=ind;
+     ulen left=2*ind+1;
+     ulen right=left+1;
+
+     if( left<pending && Less(heap[top],heap[left]) ) top=left;
+
+     if( right<pending && Less(heap[top],heap[right]) ) top=right;
+
+     if( top==ind ) break;
+
+     Swap(heap[top],heap[ind]);
+
+     ind=top;
+    }
+ }
+
 void ExeList::swap(ulen a,ulen b)
  {
   if( a!=b )
@@ -210,37 +337,120 @@ void ExeList::step(ulen ind,Func func)
  {
   ExeRule *exeobj=buf[ind];
 
-  if( !exeobj->start( [&] (auto *cmd) { step(ind,exeobj,cmd,func); } ) )
+  if( !exeobj->start(merged, [&] (auto *cmd) { step(ind,exeobj,cmd,func); } ) )
     {
      TypeDef::Rule *rule=exeobj->rule;
 
      moveOut(ind);
 
-     complete(rule,exeobj->status);
+     release(exeobj);
+
+     if( tracer ) tracer->end("rule"_c,TraceName(rule),uint64( uptr(exeobj) ));
+
+     if( usage_log ) usage_log->add(TraceName(rule),exeobj->wdir,exeobj->usage);
+
+     complete(rule,exeobj->status,MSecTimer::Get()-exeobj->start_time);
     }
  }
 
-ExeList::ExeList(PtrLen<ExeRule> list,ExeRule * buf_[],CompleteFunction complete_)
- : buf(buf_),
+ExeList::ExeList(PtrLen<ExeRule> rule_buf_,ExeRule * buf_[],ExeRule * heap_[],CompleteFunction complete_,bool merged_,Tracer *tracer_,UsageLog *usage_log_)
+ : rule_buf(rule_buf_),
+   buf(buf_),
    running(0),
-   ready(list.len),
-   count(list.len),
-   complete(complete_)
+   ready(0),
+   count(0),
+   heap(heap_),
+   pending(0),
+   complete(complete_),
+   merged(merged_),
+   tracer(tracer_),
+   usage_log(usage_log_),
+   blocked(0)
  {
-  for(ulen ind : IndLim(count) )
+ }
+
+void ExeList::add(TypeDef::Rule *rule,unsigned prio,StrLen wdir)
+ {
+  if( !rule_buf )
     {
-     ExeRule &obj=list[ind];
+     Printf(Exception,"vmake internal : exe list overflow");
+    }
+
+  ExeRule &obj=*rule_buf;
 
-     buf[ind]=&obj;
+  ++rule_buf;
 
-     obj.ind=ind;
+  obj.set(rule,prio,wdir);
+
+  if( TypeDef::Pool *pool=rule->pool.getPtr() )
+    {
+     obj.pool=findPool(pool);
+     obj.weight=Min<ulen>(rule->weight,pools[obj.pool-1].capacity);
     }
+
+  push(&obj);
+ }
+
+bool ExeList::feed()
+ {
+  ExeRule *obj;
+
+  do
+    {
+     if( !pending ) return false;
+
+     obj=heap[0];
+
+     heap[0]=heap[--pending];
+
+     heapDown(0);
+    }
+  while( !acquire(obj) );
+
+  obj->start_time=MSecTimer::Get();
+
+  if( tracer ) tracer->begin("rule"_c,TraceName(obj->rule),uint64( uptr(obj) ));
+
+  ulen ind=count++;
+
+  buf[ind]=obj;
+
+  obj->ind=ind;
+
+  swap(ready++,ind);
+
+  return true;
  }
 
 template <class Func>
-void ExeList::loop(Func func)
+bool ExeList::loop(ulen lim,Func func)
  {
-  while( running<ready ) step(running,func);
+  bool ret=false;
+
+  // completed rules are moved out without a slot, the rest waits for a free slot
+
+  for(ulen ind=running; ind<ready ;)
+    {
+     if( buf[ind]->nextCmd(merged) )
+       {
+        if( !lim )
+          {
+           ind++;
+
+           continue;
+          }
+
+        lim--;
+       }
+
+     step(ind,func);
+
+     ret=true;
+
+     Replace_max(ind,running); // the started rule is moved to running
+    }
+
+  return ret;
  }
 
 template <class Func>
@@ -248,9 +458,11 @@ void ExeList::vmake(Func func)
  {
   if( ready<count )
     {
-     TypeDef::VMake *cmd=buf[ready]->getVMake();
+     ExeRule *exeobj=buf[ready];
+
+     TypeDef::VMake *cmd=exeobj->getVMake();
 
-     int status=func(cmd);
+     int status=func(exeobj,cmd);
 
      buf[ready]->status=status;
 
@@ -267,8 +479,209 @@ void ExeList::completeObj(ExeRule *exeobj,int status)
   moveToReady(ind);
  }
 
+/* class Admission */
+
+void Admission::sample(ulen running)
+ {
+  sampled=true;
+
+  timer.reset();
+
+  Sys::SysLoad load=Sys::GetSysLoad();
+
+  if( !load.ok ) return;
+
+  if( ( max_load && load.load>max_load ) || ( min_mem && load.avail_mem<min_mem ) )
+    {
+     cap=Max<ulen>(Min(cap,running),1);
+    }
+  else
+    {
+     cap=Min(cap+Max<ulen>(cap/2,1),max_cap);
+    }
+ }
+
+Admission::Admission(unsigned max_load_,unsigned min_mem_,ulen max_cap_)
+ : max_load(max_load_*100),
+   min_mem(uint64(min_mem_)<<20),
+   max_cap(max_cap_),
+   cap(max_cap_)
+ {
+ }
+
+ulen Admission::limit(ulen running)
+ {
+  if( !sampled || timer.get()>=SamplePeriod ) sample(running);
+
+  if( cap<=running ) return 0;
+
+  return cap-running;
+ }
+
+void Admission::report()
+ {
+  if( throttle_count )
+    {
+     Printf(Con,"vmake : new processes were delayed by the load/memory limit #; times, #; msec\n",throttle_count,throttle_time/1000);
+    }
+
+  throttle_time=0;
+  throttle_count=0;
+ }
+
+/* class PExeProc::Workers */
+
+auto PExeProc::Workers::get() -> Slot *
+ {
+  sem.take();
+
+  Mutex::Lock lock(mutex);
+
+  Slot *ret=first;
+
+  if( ret )
+    {
+     first=ret->next;
+
+     if( !first ) last=0;
+    }
+
+  return ret;
+ }
+
+void PExeProc::Workers::run()
+ {
+  ReportException report;
+
+  while( Slot *slot=get() )
+    {
+     int status=1000;
+
+     try
+       {
+        PrintString out; // the console output, printed with the completion
+
+        {
+         ReportExceptionTo<PrintString> report_out(out);
+
+         try
+           {
+            status=func(slot->intcmd_wdir,slot->intcmd,out);
+           }
+         catch(CatchType)
+           {
+            status=1000;
+           }
+        }
+
+        slot->intcmd_output=out.close();
+       }
+     catch(CatchType)
+       {
+        report.clear();
+       }
+
+     waitset.post(slot,status);
+    }
+ }
+
+PExeProc::Workers::Workers(SpawnSet &waitset_,IntCmdFunction func_,ulen max_count_)
+ : waitset(waitset_),
+   func(func_),
+   max_count(max_count_)
+ {
+ }
+
+PExeProc::Workers::~Workers()
+ {
+  sem.give_many(count); // empty queue, wakes up to stop
+
+  asem.wait();
+ }
+
+void PExeProc::Workers::addWorker()
+ {
+  if( count<max_count )
+    {
+     // the exit function decrements asem, RunFuncTask() calls it on a start failure as well
+
+     asem.inc();
+
+     try
+       {
+        RunFuncTask( [this] () { run(); } ,asem.function_dec());
+
+        count++;
+       }
+     catch(CatchType)
+       {
+        // asem is already decremented
+
+        if( !count ) throw;
+
+        ReportException::Clear();
+       }
+    }
+ }
+
+void PExeProc::Workers::start(Slot *slot)
+ {
+  {
+   Mutex::Lock lock(mutex);
+
+   slot->next=0;
+
+   if( last )
+     last->next=slot;
+   else
+     first=slot;
+
+   last=slot;
+  }
+
+  sem.give();
+ }
+
 /* class PExeProc */
 
+void PExeProc::openJobServer(ulen pcap)
+ {
+  char buf[4096];
+
+  Sys::TryGetEnv<32,4096> env(Range(buf),"MAKEFLAGS");
+
+  StrLen flags;
+
+  if( env.ok ) flags=env.str;
+
+  StrLen auth=JobServer::FindAuth(flags);
+
+  try
+    {
+     if( +auth )
+       {
+        jobs.create(auth);
+
+        Printf(Con,"vmake : jobserver client #.q;\n\n",auth);
+       }
+     else
+       {
+        jobs.create(pcap-1);
+
+        if( +flags )
+          makeflags=Stringf("#; -j#; --jobserver-auth=#;",flags,pcap,jobs->getAuth());
+        else
+          makeflags=Stringf("-j#; --jobserver-auth=#;",pcap,jobs->getAuth());
+       }
+    }
+  catch(CatchType)
+    {
+     ReportException::Clear();
+
+     Printf(Con,"vmake : jobserver is not available\n\n");
+    }
+ }
+
 void PExeProc::movetoFree(ulen ind)
  {
   if( free<ind )
@@ -282,13 +695,30 @@ void PExeProc::movetoFree(ulen ind)
   free++;
  }
 
-auto PExeProc::waitOneFinish(Slot *slot,int status) -> WaitOneResult
+void PExeProc::print(StrLen echo,PtrLen<const char> output)
+ {
+  print(echo);
+  print("\n"_c);
+
+  if( +output )
+    {
+     out_buf.extend_copy(output);
+
+     if( output.back(1)!='\n' ) print("\n"_c);
+    }
+
+  PrintCon::Print(Range(out_buf));
+
+  out_buf.shrink_all();
+ }
+
+auto PExeProc::waitOneFinish(Slot *slot,int status,const SpawnUsage &usage) -> WaitOneResult
  {
   ulen ind=slot->ind;
 
   movetoFree(ind);
 
-  return {slot,status};
+  return {slot,status,usage};
  }
 
 auto PExeProc::waitOne() -> WaitOneResult
@@ -297,7 +727,23 @@ auto PExeProc::waitOne() -> WaitOneResult
     {
      auto result=waitset.wait();
 
-     if( result.slot ) return waitOneFinish(static_cast<Slot *>(result.slot),result.status);
+     if( Slot *slot=static_cast<Slot *>(result.slot) )
+       {
+        PtrLen<const char> output=result.output;
+
+        if( Replace_null(slot->intcmd) ) output=Range(slot->intcmd_output);
+
+        if( capture )
+          {
+           print(slot->echo,output);
+          }
+        else
+          {
+           if( +output ) PrintCon::Print(output);
+          }
+
+        return waitOneFinish(slot,result.status,result.usage);
+       }
     }
  }
 
@@ -306,10 +752,66 @@ void PExeProc::waitFree(CompleteCtx ctx)
   if( !free ) waitOne(ctx);
  }
 
+void PExeProc::setAdmission(unsigned max_load,unsigned min_mem)
+ {
+  if( max_load || min_mem ) admission.create(max_load,min_mem,slots.getLen());
+ }
+
+void PExeProc::setCapture(bool on)
+ {
+  capture=on;
+
+  for(Slot &slot : slotbuf ) slot.setCapture(on);
+ }
+
+ulen PExeProc::getFree()
+ {
+  ulen running=slots.getLen()-free;
+  ulen avail=free;
+
+  throttled=false;
+
+  if( +admission )
+    {
+     ulen lim=admission->limit(running);
+
+     if( lim<avail )
+       {
+        avail=lim;
+        throttled=true;
+       }
+    }
+
+  if( !jobs ) return avail;
+
+  // the first running process uses the implicit token of vmake
+
+  while( jobs->getCount()+1<running+avail && jobs->take() );
+
+  ulen cap=jobs->getCount()+1;
+
+  if( cap<=running ) return 0;
+
+  return Min(cap-running,avail);
+ }
+
+void PExeProc::trimTokens()
+ {
+  if( !jobs ) return;
+
+  ulen running=slots.getLen()-free;
+
+  while( jobs->getCount() && jobs->getCount()>=running ) jobs->give();
+ }
+
 void PExeProc::waitOne(CompleteCtx ctx)
  {
   auto result=waitOne();
 
+  result.slot->arg->usage.add(result.usage,USecTimer::Get()-result.slot->wall_start);
+
+  if( tracer ) tracer->complete("cmd"_c,TraceName(result.slot->arg->rule),result.slot->start,result.slot->num+1,"status"_c,uint64(result.status));
+
   CompleteExe temp(Replace_null(result.slot->arg),ctx);
 
   temp(result.status);
@@ -332,12 +834,14 @@ void PExeProc::setRunning(Slot *slot,CompleteExe complete)
  {
   slot->arg=complete.arg;
 
-  waitset.add(slot);
+  if( tracer ) slot->start=tracer->now();
+
+  slot->wall_start=USecTimer::Get();
 
   free--;
  }
 
-void PExeProc::command(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,CompleteExe complete)
+void PExeProc::command(StrLen echo,StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,CompleteExe complete)
  {
   if( !free )
     {
@@ -348,19 +852,54 @@ void PExeProc::command(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env,Compl
 
   slot->clean();
 
+  slot->echo=echo;
+
   try
     {
-     SpawnCommand(wdir,cmdline,env,*slot);
+     SpawnCommand(base,slot->arena,wdir,cmdline,env,Range(makeflags),*slot);
+
+     waitset.add(slot);
 
      setRunning(slot,complete);
     }
   catch(CatchType)
     {
+     if( capture ) print(echo,Empty);
+
      complete(1000);
     }
  }
 
-void PExeProc::execute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,CompleteExe complete)
+void PExeProc::execute(StrLen echo,StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrLen<TypeDef::Env> env,CompleteExe complete)
+ {
+  if( !free )
+    {
+     Printf(Exception,"vmake internal : no free slot");
+    }
+
+  Slot *slot=slots[free-1];
+
+  slot->clean();
+
+  slot->echo=echo;
+
+  try
+    {
+     SpawnExecute(base,slot->arena,exe_file,wdir,args,env,Range(makeflags),*slot);
+
+     waitset.add(slot);
+
+     setRunning(slot,complete);
+    }
+  catch(CatchType)
+    {
+     if( capture ) print(echo,Empty);
+
+     return complete(1000);
+    }
+ }
+
+void PExeProc::intcmd(StrLen echo,StrLen wdir,TypeDef::IntCmd *cmd,CompleteExe complete)
  {
   if( !free )
     {
@@ -371,32 +910,52 @@ void PExeProc::execute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,Ptr
 
   slot->clean();
 
+  slot->echo=echo;
+  slot->intcmd=cmd;
+  slot->intcmd_wdir=wdir;
+  slot->intcmd_output=Null;
+
   try
     {
-     SpawnExecute(exe_file,wdir,args,env,*slot);
+     if( !workers ) workers.create(waitset,intcmd_func,Min(MaxWorkers,slots.getLen()));
+
+     workers->addWorker();
+
+     waitset.addJob(slot);
 
      setRunning(slot,complete);
     }
   catch(CatchType)
     {
+     slot->intcmd=0;
+
+     if( capture ) print(echo,Empty);
+
      return complete(1000);
     }
+
+  workers->start(slot);
  }
 
-PExeProc::PExeProc(ulen pcap)
+PExeProc::PExeProc(ulen pcap,const SpawnBase &base_,Tracer *tracer_)
  : slotbuf(pcap),
    slots(pcap),
    free(pcap),
-   waitset(pcap)
+   waitset(pcap),
+   base(base_),
+   tracer(tracer_)
  {
   for(ulen ind : IndLim(pcap) )
     {
      Slot &slot=slotbuf[ind];
 
      slot.ind=ind;
+     slot.num=ind;
 
      slots[ind]=&slot;
     }
+
+  openJobServer(pcap);
  }
 
 PExeProc::~PExeProc()
@@ -411,9 +970,15 @@ int FileProc::Command(StrLen wdir,StrLen cmdline,PtrLen<TypeDef::Env> env)
     {
      SpawnSlot slot;
 
-     SpawnCommand(wdir,cmdline,env,slot);
+     uint64 start=USecTimer::Get();
+
+     SpawnCommand(*spawn_base,spawn_arena,wdir,cmdline,env,Empty,slot);
+
+     int ret=slot.wait();
 
-     return slot.wait();
+     if( cur_usage ) cur_usage->add(slot.getUsage(),USecTimer::Get()-start);
+
+     return ret;
     }
   catch(CatchType)
     {
@@ -427,9 +992,15 @@ int FileProc::Execute(StrLen exe_file,StrLen wdir,PtrLen<DDL::MapText> args,PtrL
     {
      SpawnSlot slot;
 
-     SpawnExecute(exe_file,wdir,args,env,slot);
+     uint64 start=USecTimer::Get();
+
+     SpawnExecute(*spawn_base,spawn_arena,exe_file,wdir,args,env,Empty,slot);
 
-     return slot.wait();
+     int ret=slot.wait();
+
+     if( cur_usage ) cur_usage->add(slot.getUsage(),USecTimer::Get()-start);
+
+     return ret;
     }
   catch(CatchType)
     {
@@ -455,33 +1026,77 @@ FileProc::~FileProc()
  {
  }
 
-void FileProc::prepare(unsigned pcap)
+void FileProc::prepare(const Options &opt_)
  {
-  if( pcap>1 ) pexe.create( Cap<unsigned>(0,pcap,100) );
+  opt=opt_;
+
+  if( +opt.trace )
+    {
+     tracer.create();
+
+     tracer->setSlots( opt.pcap>1 ? Min(opt.pcap,MaxPCap) : 1 );
+    }
+
+  if( +opt.usage ) usage_log.create();
+
+  spawn_base.create();
+
+  if( opt.pcap>1 )
+    {
+     pexe.create( Min(opt.pcap,MaxPCap) ,*spawn_base,+tracer);
+
+     pexe->setAdmission(opt.max_load,opt.min_mem);
+
+     pexe->setCapture(opt.capture);
+
+     pexe->setIntCmd(function_runIntCmd());
+    }
+
+  if( +opt.cache_dir ) cache.create(opt.cache_dir,uint64(opt.cache_size)<<20);
  }
 
  // int
 
-int FileProc::exeCmd(StrLen wdir,TypeDef::Echo *cmd)
+int FileProc::exeCmd(StrLen wdir,TypeDef::Echo *cmd,PrintBase &out)
  {
-  return intproc.echo(wdir,cmd->strs,cmd->outfile);
+  return intproc.echo(wdir,cmd->strs,cmd->outfile,out);
  }
 
-int FileProc::exeCmd(StrLen wdir,TypeDef::Cat *cmd)
+int FileProc::exeCmd(StrLen wdir,TypeDef::Cat *cmd,PrintBase &)
  {
   return intproc.cat(wdir,cmd->files,cmd->outfile);
  }
 
-int FileProc::exeCmd(StrLen wdir,TypeDef::Rm *cmd)
+int FileProc::exeCmd(StrLen wdir,TypeDef::Rm *cmd,PrintBase &)
  {
   return intproc.rm(wdir,cmd->files);
  }
 
-int FileProc::exeCmd(StrLen wdir,TypeDef::Mkdir *cmd)
+int FileProc::exeCmd(StrLen wdir,TypeDef::Mkdir *cmd,PrintBase &)
  {
   return intproc.mkdir(wdir,cmd->paths);
  }
 
+int FileProc::exeCmd(StrLen wdir,TypeDef::Copy *cmd,PrintBase &)
+ {
+  return intproc.copy(wdir,cmd->files,cmd->dst);
+ }
+
+int FileProc::exeCmd(StrLen wdir,TypeDef::Touch *cmd,PrintBase &)
+ {
+  return intproc.touch(wdir,cmd->files);
+ }
+
+int FileProc::exeCmd(StrLen wdir,TypeDef::Link *cmd,PrintBase &)
+ {
+  return intproc.link(wdir,cmd->files,cmd->dst,cmd->sym!=0);
+ }
+
+int FileProc::exeCmd(StrLen wdir,TypeDef::Stamp *cmd,PrintBase &)
+ {
+  return intproc.stamp(wdir,cmd->file);
+ }
+
  // exe
 
 int FileProc::exeCmd(StrLen wdir,TypeDef::Exe *cmd)
@@ -545,6 +1160,8 @@ int FileProc::exeCmd(StrLen wdir,TypeDef::Cmd *cmd)
 
 int FileProc::exeCmd(StrLen wdir,TypeDef::VMake *cmd)
  {
+  if( opt.merge ) return 0; // the sub-build is a part of the build graph
+
   StrLen echo=cmd->echo;
 
   Printf(Con,"#;\n",echo);
@@ -587,6 +1204,13 @@ int FileProc::exeCmd(StrLen wdir,TypeDef::IntCmd *cmd)
  {
   Printf(Con,"#;\n",StrLen(cmd->echo));
 
+  PrintCon out(Con);
+
+  return runIntCmd(wdir,cmd,out);
+ }
+
+int FileProc::runIntCmd(StrLen wdir,TypeDef::IntCmd *cmd,PrintBase &out)
+ {
   StrLen new_wdir=cmd->wdir;
 
   int status=0;
@@ -595,28 +1219,233 @@ int FileProc::exeCmd(StrLen wdir,TypeDef::IntCmd *cmd)
     {
      WDirFileName wdir1(wdir,new_wdir);
 
-     cmd->cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) status=exeCmd(wdir1.get(),cmd); } );
+     cmd->cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) status=exeCmd(wdir1.get(),cmd,out); } );
     }
   else
     {
-     cmd->cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) status=exeCmd(wdir,cmd); } );
+     cmd->cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) status=exeCmd(wdir,cmd,out); } );
     }
 
   return status;
  }
 
-int FileProc::exeRule(StrLen wdir,TypeDef::Rule *rule)
+void FileProc::AddText(ContentHash &hash,StrLen str)
+ {
+  hash.add(uint64(str.len));
+  hash.add(str);
+ }
+
+void FileProc::AddWDir(ContentHash &hash,StrLen wdir,StrLen new_wdir)
+ {
+  if( +new_wdir )
+    {
+     WDirFileName wdir1(wdir,new_wdir);
+
+     AddText(hash,wdir1.get());
+    }
+  else
+    {
+     AddText(hash,wdir);
+    }
+ }
+
+void FileProc::AddEnv(ContentHash &hash,PtrLen<TypeDef::Env> env)
+ {
+  hash.add(uint64(env.len));
+
+  for(auto &obj : env )
+    {
+     AddText(hash,obj.name);
+     AddText(hash,obj.value);
+    }
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Echo *cmd)
+ {
+  hash.add(uint64(1));
+
+  PtrLen<DDL::MapText> strs=cmd->strs;
+
+  hash.add(uint64(strs.len));
+
+  for(StrLen str : strs ) AddText(hash,str);
+
+  AddText(hash,cmd->outfile);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Cat *cmd)
  {
+  hash.add(uint64(2));
+
+  PtrLen<DDL::MapText> files=cmd->files;
+
+  hash.add(uint64(files.len));
+
+  for(StrLen file : files ) AddText(hash,file);
+
+  AddText(hash,cmd->outfile);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Rm *cmd)
+ {
+  hash.add(uint64(3));
+
+  PtrLen<DDL::MapText> files=cmd->files;
+
+  hash.add(uint64(files.len));
+
+  for(StrLen file : files ) AddText(hash,file);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Mkdir *cmd)
+ {
+  hash.add(uint64(4));
+
+  PtrLen<DDL::MapText> paths=cmd->paths;
+
+  hash.add(uint64(paths.len));
+
+  for(StrLen path : paths ) AddText(hash,path);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Copy *cmd)
+ {
+  hash.add(uint64(9));
+
+  PtrLen<DDL::MapText> files=cmd->files;
+
+  hash.add(uint64(files.len));
+
+  for(StrLen file : files ) AddText(hash,file);
+
+  AddText(hash,cmd->dst);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Touch *cmd)
+ {
+  hash.add(uint64(10));
+
+  PtrLen<DDL::MapText> files=cmd->files;
+
+  hash.add(uint64(files.len));
+
+  for(StrLen file : files ) AddText(hash,file);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Link *cmd)
+ {
+  hash.add(uint64(11));
+
+  PtrLen<DDL::MapText> files=cmd->files;
+
+  hash.add(uint64(files.len));
+
+  for(StrLen file : files ) AddText(hash,file);
+
+  AddText(hash,cmd->dst);
+
+  hash.add(uint64(cmd->sym));
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen,TypeDef::Stamp *cmd)
+ {
+  hash.add(uint64(12));
+
+  AddText(hash,cmd->file);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen wdir,TypeDef::Exe *cmd)
+ {
+  hash.add(uint64(5));
+
+  AddText(hash,cmd->exe);
+
+  PtrLen<DDL::MapText> args=cmd->args;
+
+  hash.add(uint64(args.len));
+
+  for(StrLen arg : args ) AddText(hash,arg);
+
+  AddWDir(hash,wdir,cmd->wdir);
+  AddEnv(hash,cmd->env);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen wdir,TypeDef::Cmd *cmd)
+ {
+  hash.add(uint64(6));
+
+  AddText(hash,cmd->cmdline);
+  AddWDir(hash,wdir,cmd->wdir);
+  AddEnv(hash,cmd->env);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen wdir,TypeDef::VMake *cmd)
+ {
+  hash.add(uint64(7));
+
+  AddText(hash,cmd->file);
+  AddText(hash,cmd->target);
+  AddWDir(hash,wdir,cmd->wdir);
+ }
+
+void FileProc::AddSig(ContentHash &hash,StrLen wdir,TypeDef::IntCmd *cmd)
+ {
+  hash.add(uint64(8));
+
+  StrLen new_wdir=cmd->wdir;
+
+  if( +new_wdir )
+    {
+     WDirFileName wdir1(wdir,new_wdir);
+
+     AddText(hash,wdir1.get());
+
+     cmd->cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) AddSig(hash,wdir1.get(),cmd); } );
+    }
+  else
+    {
+     AddText(hash,wdir);
+
+     cmd->cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) AddSig(hash,wdir,cmd); } );
+    }
+ }
+
+uint64 FileProc::GetSignature(StrLen wdir,TypeDef::Rule *rule)
+ {
+  ContentHash hash;
+
   for(auto cmd : rule->cmd.getRange() )
     {
-     int ret=0;
+     cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) AddSig(hash,wdir,cmd); } );
+    }
+
+  uint64 ret=hash.finish();
+
+  if( !ret ) ret=1;
 
+  return ret;
+ }
+
+int FileProc::exeRule(StrLen wdir,TypeDef::Rule *rule)
+ {
+  RuleUsage usage;
+
+  RuleUsage *prev=Replace(cur_usage,&usage); // nested vmake runs its own rules
+
+  int ret=0;
+
+  for(auto cmd : rule->cmd.getRange() )
+    {
      cmd.getPtr().apply( [&] (auto *cmd) { if( cmd ) ret=exeCmd(wdir,cmd); } );
 
-     if( ret ) return ret;
+     if( ret ) break;
     }
 
-  return 0;
+  cur_usage=prev;
+
+  if( +usage_log ) usage_log->add(TraceName(rule),wdir,usage);
+
+  return ret;
  }
 
  // pexe
@@ -627,7 +1456,7 @@ void FileProc::startCmd(StrLen wdir,TypeDef::Exe *cmd,PExeProc::CompleteExe comp
 
   StrLen echo=cmd->echo;
 
-  Printf(Con,"#;\n",echo);
+  if( !opt.capture ) Printf(Con,"#;\n",echo);
 
   StrLen exe_file=cmd->exe;
   PtrLen<DDL::MapText> args=cmd->args;
@@ -640,7 +1469,7 @@ void FileProc::startCmd(StrLen wdir,TypeDef::Exe *cmd,PExeProc::CompleteExe comp
        {
         WDirFileName wdir1(wdir,new_wdir);
 
-        pexe->execute(exe_file,wdir1.get(),args,env,complete);
+        pexe->execute(echo,exe_file,wdir1.get(),args,env,complete);
        }
      catch(CatchType)
        {
@@ -649,7 +1478,7 @@ void FileProc::startCmd(StrLen wdir,TypeDef::Exe *cmd,PExeProc::CompleteExe comp
     }
   else
     {
-     pexe->execute(exe_file,wdir,args,env,complete);
+     pexe->execute(echo,exe_file,wdir,args,env,complete);
     }
  }
 
@@ -659,7 +1488,7 @@ void FileProc::startCmd(StrLen wdir,TypeDef::Cmd *cmd,PExeProc::CompleteExe comp
 
   StrLen echo=cmd->echo;
 
-  Printf(Con,"#;\n",echo);
+  if( !opt.capture ) Printf(Con,"#;\n",echo);
 
   StrLen cmdline=cmd->cmdline;
   StrLen new_wdir=cmd->wdir;
@@ -671,7 +1500,7 @@ void FileProc::startCmd(StrLen wdir,TypeDef::Cmd *cmd,PExeProc::CompleteExe comp
        {
         WDirFileName wdir1(wdir,new_wdir);
 
-        return pexe->command(wdir1.get(),cmdline,env,complete);
+        return pexe->command(echo,wdir1.get(),cmdline,env,complete);
        }
      catch(CatchType)
        {
@@ -680,46 +1509,80 @@ void FileProc::startCmd(StrLen wdir,TypeDef::Cmd *cmd,PExeProc::CompleteExe comp
     }
   else
     {
-     pexe->command(wdir,cmdline,env,complete);
+     pexe->command(echo,wdir,cmdline,env,complete);
     }
  }
 
 void FileProc::startCmd(StrLen wdir,TypeDef::IntCmd *cmd,PExeProc::CompleteExe complete)
  {
-  int status=exeCmd(wdir,cmd);
-
-  complete(status);
- }
+  pexe->waitFree(complete.ctx);
 
-void FileProc::exeRuleList(StrLen wdir,PtrLen<ExeRule> list,ExeRule * buf[],CompleteFunction complete)
- {
-  if( !list ) return;
+  StrLen echo=cmd->echo;
 
-  Printf(Con,"vmake : start #; rules\n",list.len);
+  if( !opt.capture ) Printf(Con,"#;\n",echo);
 
-#if 1
+  pexe->intcmd(echo,wdir,cmd,complete);
+ }
 
+void FileProc::exeRuleList(ExeList &exelist)
+ {
   try
     {
-     ExeList exelist(list,buf,complete);
-
      while( exelist.notEmpty() )
        {
-        while( exelist.hasReady() )
+        for(;;)
           {
-           exelist.loop( [&] (ExeRule *obj,auto *cmd)
-                             {
-                              guard();
+           // rules are fed in the priority order, as slots become free
+
+           ulen lim=pexe->getFree();
+
+           while( exelist.hasWaiting()<lim && exelist.feed() );
+
+           // continuation commands of running rules are started within the same limit
 
-                              startCmd(wdir,cmd,{obj,&exelist});
+           bool done=exelist.loop(lim, [&] (ExeRule *obj,auto *cmd)
+                                           {
+                                            guard();
 
-                             } );
+                                            startCmd(obj->wdir,cmd,{obj,&exelist});
 
-           if( exelist.hasRunning() ) pexe->waitOne(&exelist);
+                                           } );
+
+           if( done ) continue;
+
+           if( exelist.hasRunning() )
+             {
+              pexe->trimTokens();
+
+              bool throttled=( pexe->isThrottled() && ( exelist.hasPending() || exelist.hasWaiting() ) );
+
+              uint64 start=USecTimer::Get();
+              uint64 trace_start=( +tracer ? tracer->now() : 0 );
+
+              pexe->waitOne(&exelist);
+
+              if( throttled ) pexe->addThrottle(USecTimer::Get()-start);
+
+              if( +tracer )
+                {
+                 if( lim )
+                   tracer->complete("sched"_c,"idle"_c,trace_start,0,"free"_c,lim); // free slots, but no ready rules
+                 else if( throttled )
+                   tracer->complete("sched"_c,"throttle"_c,trace_start,0);
+                }
+             }
+           else
+             {
+              pexe->trimTokens();
+
+              break;
+             }
           }
 
-        exelist.vmake( [&] (TypeDef::VMake *cmd) { return exeCmd(wdir,cmd); } );
+        exelist.vmake( [&] (ExeRule *obj,TypeDef::VMake *cmd) { return exeCmd(obj->wdir,cmd); } );
        }
+
+     pexe->reportThrottle();
     }
   catch(...)
     {
@@ -727,17 +1590,6 @@ void FileProc::exeRuleList(StrLen wdir,PtrLen<ExeRule> list,ExeRule * buf[],Comp
 
      throw;
     }
-
-#else
-
-  for(auto &obj : list )
-    {
-     int status=exeRule(wdir,obj.rule);
-
-     complete(obj.rule,status);
-    }
-
-#endif
  }
 
 } // namespace VMake
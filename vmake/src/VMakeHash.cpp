@@ -0,0 +1,175 @@
+/* VMakeHash.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeHash.h>
+
+#include <CCore/inc/RawFileToRead.h>
+#include <CCore/inc/Array.h>
+
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* class ContentHash */
+
+uint64 ContentHash::Load64(const uint8 *ptr)
+ {
+  uint64 ret=0;
+
+  for(unsigned i=0; i<8 ;i++) ret|=uint64(ptr[i])<<(8*i);
+
+  return ret;
+ }
+
+uint32 ContentHash::Load32(const uint8 *ptr)
+ {
+  uint32 ret=0;
+
+  for(unsigned i=0; i<4 ;i++) ret|=uint32(ptr[i])<<(8*i);
+
+  return ret;
+ }
+
+void ContentHash::stripe(const uint8 *ptr)
+ {
+  v1=Round(v1,Load64(ptr));
+  v2=Round(v2,Load64(ptr+8));
+  v3=Round(v3,Load64(ptr+16));
+  v4=Round(v4,Load64(ptr+24));
+ }
+
+ContentHash::ContentHash(uint64 seed)
+ {
+  v1=seed+P1+P2;
+  v2=seed+P2;
+  v3=seed;
+  v4=seed-P1;
+ }
+
+void ContentHash::add(PtrLen<const uint8> data)
+ {
+  total+=data.len;
+
+  if( buf_len )
+    {
+     ulen delta=Min(StripeLen-buf_len,data.len);
+
+     data.prefix(delta).copyTo(buf+buf_len);
+
+     buf_len+=delta;
+     data+=delta;
+
+     if( buf_len<StripeLen ) return;
+
+     stripe(buf);
+
+     buf_len=0;
+    }
+
+  for(; data.len>=StripeLen ;data+=StripeLen) stripe(data.ptr);
+
+  data.copyTo(buf);
+
+  buf_len=data.len;
+ }
+
+void ContentHash::add(uint64 value)
+ {
+  uint8 temp[8];
+
+  for(unsigned i=0; i<8 ;i++) temp[i]=uint8(value>>(8*i));
+
+  add(Range_const(temp));
+ }
+
+uint64 ContentHash::finish() const
+ {
+  uint64 ret;
+
+  if( total>=StripeLen )
+    {
+     ret=Rotl(v1,1)+Rotl(v2,7)+Rotl(v3,12)+Rotl(v4,18);
+
+     ret=Merge(ret,v1);
+     ret=Merge(ret,v2);
+     ret=Merge(ret,v3);
+     ret=Merge(ret,v4);
+    }
+  else
+    {
+     ret=v3+P5;
+    }
+
+  ret+=total;
+
+  const uint8 *ptr=buf;
+  ulen len=buf_len;
+
+  for(; len>=8 ;ptr+=8,len-=8) ret=Rotl(ret^Round(0,Load64(ptr)),27)*P1+P4;
+
+  if( len>=4 )
+    {
+     ret=Rotl(ret^(uint64(Load32(ptr))*P1),23)*P2+P3;
+
+     ptr+=4;
+     len-=4;
+    }
+
+  for(; len ;ptr++,len--) ret=Rotl(ret^(uint64(*ptr)*P5),11)*P1;
+
+  ret^=ret>>33;
+  ret*=P2;
+  ret^=ret>>29;
+  ret*=P3;
+  ret^=ret>>32;
+
+  return ret;
+ }
+
+/* HashFile() */
+
+uint64 HashFile(StrLen file_name)
+ {
+  try
+    {
+     RawFileToRead file(file_name);
+
+     SimpleArray<uint8> buf(64_KByte);
+
+     ContentHash hash;
+
+     for(;;)
+       {
+        ulen len=file.read(buf.getPtr(),buf.getLen());
+
+        if( !len ) break;
+
+        hash.add(Range_const(buf.getPtr(),len));
+       }
+
+     uint64 ret=hash.finish();
+
+     if( !ret ) ret=1;
+
+     return ret;
+    }
+  catch(CatchType)
+    {
+     return 0;
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
@@ -0,0 +1,146 @@
+/* VMakeHistory.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeHistory.h>
+
+#include <CCore/inc/FileSystem.h>
+#include <CCore/inc/FileToMem.h>
+#include <CCore/inc/CharProp.h>
+
+#include <CCore/inc/Print.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* class RuleHistory */
+
+auto RuleHistory::find(StrLen key) -> Node *
+ {
+  return root.find(StrKey(key));
+ }
+
+void RuleHistory::add(StrLen key,unsigned time)
+ {
+  if( Node *node=find(key) )
+    {
+     node->time=time;
+
+     return;
+    }
+
+  StrKey skey(pool.dup(key));
+
+  TreeAlgo::PrepareIns prepare(root,skey);
+
+  Node *node=pool.create<Node>();
+
+  node->time=time;
+
+  prepare.complete(node);
+
+  list.append_copy(node);
+ }
+
+void RuleHistory::load()
+ {
+  FileSystem fs;
+
+  if( fs.getFileType(file_name)!=FileType_file ) return;
+
+  FileToMem map(file_name);
+
+  StrLen text=Mutate<const char>(Range(map.getPtr(),map.getLen()));
+
+  uint64 total=0;
+
+  while( +text )
+    {
+     ulen len=0;
+
+     while( len<text.len && text[len]!='\n' ) len++;
+
+     StrLen line=text.prefix(len);
+
+     text+=Min(len+1,text.len);
+
+     unsigned time=0;
+
+     for(int dig; +line && (dig=charDecValue(*line))>=0 ;++line) time=10*time+unsigned(dig);
+
+     if( !line || *line!=' ' ) continue;
+
+     ++line;
+
+     if( !line ) continue;
+
+     add(line,time);
+
+     total+=time;
+    }
+
+  if( ulen count=list.getLen() ) average=unsigned( total/count )+1;
+ }
+
+RuleHistory::RuleHistory(StrLen file_name_)
+ {
+  file_name=pool.dup(file_name_);
+
+  load();
+ }
+
+RuleHistory::~RuleHistory()
+ {
+ }
+
+unsigned RuleHistory::get(StrLen key)
+ {
+  if( Node *node=find(key) ) return node->time;
+
+  return 0;
+ }
+
+void RuleHistory::set(StrLen key,unsigned time)
+ {
+  if( !key ) return;
+
+  if( Node *node=find(key) ) time=(node->time+time)/2+1;
+
+  add(key,time);
+
+  changed=true;
+ }
+
+void RuleHistory::save()
+ {
+  if( !changed ) return;
+
+  try
+    {
+     PrintFile out(file_name,Open_ToWrite|Open_AutoDelete);
+
+     for(Node *node : list ) Printf(out,"#; #;\n",node->time,node->link.key.str);
+
+     out.preserveFile();
+
+     changed=false;
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save history #.q;\n",file_name);
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
@@ -0,0 +1,288 @@
+/* VMakeIncScan.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeIncScan.h>
+
+#include <CCore/inc/Path.h>
+#include <CCore/inc/MakeFileName.h>
+#include <CCore/inc/FileToMem.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* class IncludeScanner */
+
+uint64 IncludeScanner::Load64(const char *ptr)
+ {
+  uint64 ret=0;
+
+  for(unsigned i=0; i<8 ;i++) ret|=uint64(uint8(ptr[i]))<<(8*i);
+
+  return ret;
+ }
+
+const char * IncludeScanner::FindHash(const char *ptr,const char *lim)
+ {
+  const uint64 Ones = 0x0101010101010101u ;
+  const uint64 High = 0x8080808080808080u ;
+  const uint64 Pattern = Ones*uint8('#') ;
+
+  while( lim-ptr>=8 )
+    {
+     uint64 x=Load64(ptr)^Pattern;
+
+     if( (x-Ones)&~x&High ) break; // some byte is zero
+
+     ptr+=8;
+    }
+
+  for(; ptr<lim && *ptr!='#' ;ptr++);
+
+  return ptr;
+ }
+
+StrLen IncludeScanner::Include(const char *ptr,const char *lim)
+ {
+  auto skip = [&] () { while( ptr<lim && ( *ptr==' ' || *ptr=='\t' ) ) ptr++; } ;
+
+  skip();
+
+  StrLen word="include"_c;
+
+  if( ulen(lim-ptr)<word.len || !word.equal(StrLen(ptr,word.len)) ) return Empty;
+
+  ptr+=word.len;
+
+  skip();
+
+  if( ptr>=lim ) return Empty;
+
+  char end;
+
+  switch( *ptr )
+    {
+     case '"' : end='"'; break;
+     case '<' : end='>'; break;
+
+     default: return Empty;
+    }
+
+  const char *start=ptr++;
+
+  for(; ptr<lim ;ptr++)
+    {
+     char ch=*ptr;
+
+     if( ch==end ) return StrLen(start,ulen(ptr-start));
+
+     if( ch=='\n' || ch=='\r' ) break;
+    }
+
+  return Empty;
+ }
+
+void IncludeScanner::Scan(PtrLen<const char> text,DynArray<String> &raw)
+ {
+  const char *base=text.ptr;
+  const char *lim=text.ptr+text.len;
+
+  for(const char *ptr=base; (ptr=FindHash(ptr,lim))<lim ;ptr++)
+    {
+     // '#' is the first non-blank char of the line
+
+     const char *p=ptr;
+
+     while( p>base && ( p[-1]==' ' || p[-1]=='\t' ) ) p--;
+
+     if( p>base && p[-1]!='\n' && p[-1]!='\r' ) continue;
+
+     StrLen str=Include(ptr+1,lim);
+
+     if( str.len>1 ) raw.append_fill(str);
+    }
+ }
+
+auto IncludeScanner::getNode(Context *ctx,StrLen file) -> FileNode *
+ {
+  StrKey key(file);
+
+  TreeAlgo::PrepareIns prepare(ctx->root,key);
+
+  if( prepare.found ) return prepare.found;
+
+  StrLen str=pool.dup(file);
+
+  FileNode *node=pool.create<FileNode>();
+
+  prepare.complete(node);
+
+  node->link.key.str=str;
+
+  ctx->pending.append_copy(node);
+
+  return node;
+ }
+
+bool IncludeScanner::exist(StrLen file)
+ {
+  return file_proc.checkExist(wdir,file);
+ }
+
+void IncludeScanner::resolve(Context *ctx,StrLen includer,StrLen raw,DynArray<String> &found)
+ {
+  StrLen name=raw.part(1);
+
+  if( raw[0]=='"' )
+    {
+     WDirFileName file(PrefixPath(includer),name);
+
+     if( exist(file.get()) )
+       {
+        found.append_fill(file.get());
+
+        return;
+       }
+    }
+
+  for(StrLen dir : ctx->path )
+    {
+     WDirFileName file(dir,name);
+
+     if( exist(file.get()) )
+       {
+        found.append_fill(file.get());
+
+        return;
+       }
+    }
+ }
+
+void IncludeScanner::work(Item &item)
+ {
+  StrLen file=item.node->link.key.str;
+
+  item.status=file_proc.getFileStatus(wdir,file);
+
+  if( item.status.type!=FileType_file ) return;
+
+  item.hit=cache.apply(file, [&] (StrLen str) { if( str.len>1 ) item.raw.append_fill(str); } ,&item.status);
+
+  if( !item.hit )
+    {
+     WDirFileName path(wdir,file);
+
+     FileToMem text(path.get());
+
+     Scan(Mutate<const char>(Range(text.getPtr(),text.getLen())),item.raw);
+    }
+
+  for(const String &str : item.raw ) resolve(item.ctx,file,Range(str),item.found);
+
+  item.ok=true;
+ }
+
+IncludeScanner::IncludeScanner(FileProc &file_proc_,StrLen wdir_,StrLen cache_file)
+ : file_proc(file_proc_),
+   wdir(wdir_),
+   cache(cache_file)
+ {
+ }
+
+IncludeScanner::~IncludeScanner()
+ {
+ }
+
+ulen IncludeScanner::addContext(PtrLen<const StrLen> path)
+ {
+  OwnPtr<Context> ctx(new Context);
+
+  ctx->path=pool.createArray<StrLen>(path.len);
+
+  for(ulen i=0; i<path.len ;i++) ctx->path[i]=pool.dup(path[i]);
+
+  ulen ret=contexts.getLen();
+
+  contexts.append_fill(std::move(ctx));
+
+  return ret;
+ }
+
+void IncludeScanner::addRoot(ulen ctx,StrLen file)
+ {
+  getNode(contexts[ctx].getPtr(),file);
+ }
+
+void IncludeScanner::run()
+ {
+  for(;;)
+    {
+     ulen count=0;
+
+     for(auto &ctx : contexts ) count+=ctx->pending.getLen();
+
+     if( !count ) break;
+
+     SimpleArray<Item> items(count);
+
+     {
+      ulen ind=0;
+
+      for(auto &ctx : contexts )
+        {
+         for(FileNode *node : ctx->pending )
+           {
+            items[ind].ctx=ctx.getPtr();
+            items[ind].node=node;
+
+            ind++;
+           }
+
+         ctx->pending.erase();
+        }
+     }
+
+     RunParallel(count,ScanThreads, [&] (ulen ind)
+                                        {
+                                         SilentReportException report;
+
+                                         try
+                                           {
+                                            work(items[ind]);
+                                           }
+                                         catch(CatchType)
+                                           {
+                                           }
+
+                                        } );
+
+     // next level
+
+     for(Item &item : items )
+       {
+        if( !item.ok ) continue;
+
+        if( !item.hit ) cache.add(item.node->link.key.str,Range(item.raw),item.status);
+
+        auto incs=pool.createArray<FileNode *>(item.found.getLen());
+
+        for(ulen i=0; i<incs.len ;i++) incs[i]=getNode(item.ctx,Range(item.found[i]));
+
+        item.node->incs=incs;
+       }
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
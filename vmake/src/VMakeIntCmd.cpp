@@ -17,11 +17,299 @@
 #include <CCore/inc/Path.h>
 
 #include <CCore/inc/Print.h>
-#include <CCore/inc/GetBinaryFile.h>
+#include <CCore/inc/RawFileToRead.h>
+#include <CCore/inc/Timer.h>
+#include <CCore/inc/Exception.h>
 
 namespace App {
 namespace VMake {
 
+/* class IntCmdProc::StatCache */
+
+FileSystem::DirHandle * IntCmdProc::StatCache::openDir(StrLen dir)
+ {
+  if( handles.getLen()>=MaxHandles ) return 0;
+
+  SilentReportException report;
+
+  try
+    {
+     FileSystem::DirHandle *ret;
+
+     if( !dir )
+       {
+        ret=new FileSystem::DirHandle(fs,wdir.notEmpty()?Range(wdir):"."_c);
+       }
+     else
+       {
+        WDirFileName dir1(Range(wdir),dir);
+
+        ret=new FileSystem::DirHandle(fs,dir1.get());
+       }
+
+     handles.append_fill(ret);
+
+     return ret;
+    }
+  catch(CatchType)
+    {
+     return 0;
+    }
+ }
+
+FileSystem::DirHandle * IntCmdProc::StatCache::find(StrLen prefix,StrLen dir)
+ {
+  Mutex::Lock lock(mutex);
+
+  StrKey key(prefix);
+
+  TreeAlgo::PrepareIns prepare(root,key);
+
+  if( prepare.found ) return prepare.found->handle;
+
+  DirNode *node=pool.create<DirNode>();
+
+  StrLen str=pool.dup(prefix);
+
+  node->handle=openDir(dir); // null on error, the plain stat reports it
+
+  prepare.complete(node);
+
+  node->link.key.str=str;
+
+  return node->handle;
+ }
+
+IntCmdProc::StatCache::StatCache(FileSystem &fs_,StrLen wdir_)
+ : fs(fs_),
+   wdir(wdir_)
+ {
+ }
+
+IntCmdProc::StatCache::~StatCache()
+ {
+ }
+
+bool IntCmdProc::StatCache::getFileStatus(StrLen wdir_,StrLen file,FileStatus &ret)
+ {
+  if( !wdir_.equal(Range(wdir)) ) return false;
+
+  SplitPath split1(file);
+  SplitName split2(split1.path);
+
+  StrLen name=split2.name;
+
+  if( !name || PathBase::IsSpecial(name) ) return false;
+
+  FileSystem::DirHandle *handle=find(file.prefix(file.len-name.len),PrefixPath(file));
+
+  if( !handle ) return false;
+
+  ret=handle->getFileStatus(name);
+
+  return true;
+ }
+
+/* class IntCmdProc::StatWatch */
+
+StrLen IntCmdProc::StatWatch::DirOf(StrLen path)
+ {
+  StrLen dir=PrefixPath(path);
+
+  if( !dir ) return "."_c;
+
+  return dir;
+ }
+
+auto IntCmdProc::StatWatch::getDir(StrLen dir) -> DirNode *
+ {
+  StrKey key(dir);
+
+  DirTreeAlgo::PrepareIns prepare(dir_root,key);
+
+  if( prepare.found ) return prepare.found;
+
+  DirNode *node=pool.create<DirNode>();
+
+  StrLen str=pool.dup(dir);
+
+  node->wd=-1;
+  node->fail=0;
+  node->flush=0;
+  node->next=0;
+
+  prepare.complete(node);
+
+  node->link.key.str=str;
+
+  return node;
+ }
+
+void IntCmdProc::StatWatch::invalidate(DirNode *dir,StrLen name)
+ {
+  if( FileNode *node=dir->files.find(StrKey(name)) ) node->stamp=0;
+ }
+
+void IntCmdProc::StatWatch::invalidateSelf(DirNode *dir) // the dir time is changed
+ {
+  StrLen path=dir->link.key.str;
+
+  SplitPath split1(path);
+  SplitName split2(split1.path);
+
+  StrLen name=split2.name;
+
+  if( !name || PathBase::IsSpecial(name) ) return;
+
+  if( DirNode *parent=dir_root.find(StrKey(DirOf(path))) ) invalidate(parent,name);
+ }
+
+void IntCmdProc::StatWatch::event(const FileWatch::Event &event)
+ {
+  if( event.type==Sys::FileWatch::Event_Overflow )
+    {
+     flush=clock;
+
+     return;
+    }
+
+  if( event.wd<0 || ulen(event.wd)>=wd_map.getLen() ) return;
+
+  DirNode *dir=wd_map[ulen(event.wd)];
+
+  if( event.type==Sys::FileWatch::Event_Lost )
+    {
+     wd_map[ulen(event.wd)]=0;
+
+     while( dir )
+       {
+        dir->wd=-1;
+        dir->flush=clock;
+
+        invalidateSelf(dir);
+
+        dir=Replace_null(dir->next);
+       }
+    }
+  else
+    {
+     for(; dir ;dir=dir->next)
+       {
+        invalidate(dir,event.name);
+
+        invalidateSelf(dir);
+       }
+    }
+ }
+
+IntCmdProc::StatWatch::StatWatch()
+ {
+ }
+
+IntCmdProc::StatWatch::~StatWatch()
+ {
+ }
+
+void IntCmdProc::StatWatch::sync()
+ {
+  Mutex::Lock lock(mutex);
+
+  epoch++;
+
+  SilentReportException report;
+
+  try
+    {
+     watch.read( [&] (const FileWatch::Event &e) { event(e); } );
+    }
+  catch(CatchType)
+    {
+     flush=clock;
+    }
+ }
+
+auto IntCmdProc::StatWatch::find(StrLen path,FileStatus &ret,bool &valid) -> FileNode *
+ {
+  valid=false;
+
+  SplitPath split1(path);
+  SplitName split2(split1.path);
+
+  StrLen name=split2.name;
+
+  if( !name || PathBase::IsSpecial(name) ) return 0;
+
+  Mutex::Lock lock(mutex);
+
+  DirNode *dir=getDir(DirOf(path));
+
+  if( dir->wd<0 )
+    {
+     if( dir->fail==epoch ) return 0;
+
+     // the watch is added before the file status is taken
+
+     SilentReportException report;
+
+     try
+       {
+        int wd=watch.add(dir->link.key.str);
+
+        if( wd<0 ) return 0;
+
+        ulen ind=ulen(wd);
+
+        if( ind>=wd_map.getLen() ) wd_map.extend_default(ind+1-wd_map.getLen());
+
+        dir->wd=wd;
+        dir->flush=clock;
+        dir->next=wd_map[ind]; // the same dir by another path
+
+        wd_map[ind]=dir;
+       }
+     catch(CatchType)
+       {
+        dir->fail=epoch;
+
+        return 0;
+       }
+    }
+
+  StrKey key(name);
+
+  FileTreeAlgo::PrepareIns prepare(dir->files,key);
+
+  FileNode *node=prepare.found;
+
+  if( !node )
+    {
+     node=pool.create<FileNode>();
+
+     StrLen str=pool.dup(name);
+
+     node->stamp=0;
+
+     prepare.complete(node);
+
+     node->link.key.str=str;
+    }
+  else if( node->stamp>dir->flush && node->stamp>flush )
+    {
+     ret=node->status;
+     valid=true;
+    }
+
+  return node;
+ }
+
+void IntCmdProc::StatWatch::set(FileNode *node,const FileStatus &status)
+ {
+  Mutex::Lock lock(mutex);
+
+  node->status=status;
+  node->stamp=++clock;
+ }
+
 /* class IntCmdProc */
 
 IntCmdProc::IntCmdProc()
@@ -32,20 +320,121 @@ IntCmdProc::~IntCmdProc()
  {
  }
 
+ // stat cache
+
+void IntCmdProc::openCache(StrLen wdir)
+ {
+  cache.create(fs,wdir);
+
+  if( +watch )
+    {
+     watch->sync();
+
+     watch_active=true;
+    }
+ }
+
+void IntCmdProc::closeCache()
+ {
+  cache.destroy();
+
+  watch_active=false;
+ }
+
+void IntCmdProc::openWatch()
+ {
+  watch.create();
+ }
+
  // check
 
 bool IntCmdProc::checkExist(StrLen wdir,StrLen dst)
  {
-  WDirFileName dst1(wdir,dst);
-
-  return fs.getFileType(dst1.get())==FileType_file;
+  return getFileStatus(wdir,dst).type==FileType_file;
  }
 
 CmpFileTimeType IntCmdProc::getFileTime(StrLen wdir,StrLen file)
  {
+  return getFileStatus(wdir,file).time;
+ }
+
+FileStatus IntCmdProc::statFile(StrLen wdir,StrLen file)
+ {
+  FileStatus ret;
+
+  if( +cache && cache->getFileStatus(wdir,file,ret) ) return ret;
+
   WDirFileName file1(wdir,file);
 
-  return fs.getFileUpdateTime(file1.get());
+  return fs.getFileStatus(file1.get());
+ }
+
+template <class Func>
+void IntCmdProc::forFiles(StrLen path,Func func)
+ {
+  CheckWildcard check(path);
+
+  if( check.ok )
+    {
+     ExpandWildcard(fs,path, [&] (StrLen file) { func(file); } );
+    }
+  else
+    {
+     func(path);
+    }
+ }
+
+StrLen IntCmdProc::TargetOf(MakeFileName &buf,StrLen dst,bool to_dir,StrLen src)
+ {
+  if( !to_dir ) return dst;
+
+  SplitPath split1(src);
+  SplitName split2(split1.path);
+
+  return buf(dst,split2.name);
+ }
+
+bool IntCmdProc::prepareTarget(StrLen dst,PtrLen<DDL::MapText> files)
+ {
+  if( fs.getFileType(dst)==FileType_dir ) return true;
+
+  bool to_dir=( files.len>1 );
+
+  for(StrLen file : files ) if( CheckWildcard(file).ok ) to_dir=true;
+
+  if( to_dir )
+    {
+     WalkPath(dst, [&] (StrLen dir)
+                       {
+                        if( fs.getFileType(dir)!=FileType_dir ) fs.createDir(dir);
+
+                       } );
+    }
+
+  return to_dir;
+ }
+
+FileStatus IntCmdProc::getFileStatus(StrLen wdir,StrLen file)
+ {
+  if( watch_active )
+    {
+     WDirFileName file1(wdir,file);
+
+     FileStatus ret;
+     bool valid;
+
+     auto *node=watch->find(file1.get(),ret,valid);
+
+     if( valid ) return ret;
+
+     ret=statFile(wdir,file);
+
+     if( node ) watch->set(node,ret);
+
+     return ret;
+    }
+
+  return statFile(wdir,file);
  }
 
 bool IntCmdProc::checkOlder(StrLen wdir,StrLen dst,StrLen src)
@@ -55,13 +444,15 @@ bool IntCmdProc::checkOlder(StrLen wdir,StrLen dst,StrLen src)
 
  // commands
 
-int IntCmdProc::echo(StrLen wdir,PtrLen<DDL::MapText> strs,StrLen outfile)
+int IntCmdProc::echo(StrLen wdir,PtrLen<DDL::MapText> strs,StrLen outfile,PrintBase &con)
  {
   try
     {
      if( !outfile )
        {
-        for(StrLen str : strs ) Printf(Con,"#;\n",str);
+        for(StrLen str : strs ) Printf(con,"#;\n",str);
+
+        con.flush();
        }
      else
        {
@@ -90,18 +481,26 @@ int IntCmdProc::cat(StrLen wdir,PtrLen<DDL::MapText> files,StrLen outfile)
 
      PrintFile out(outfile1.get(),Open_ToWrite|Open_AutoDelete);
 
+     // the output is preallocated, the content is copied kernel-side, if possible
+
+     FilePosType total=0;
+
      for(StrLen file : files )
        {
         WDirFileName file1(wdir,file);
 
-        GetBinaryFile inp(file1.get());
+        total+=fs.getFileStatus(file1.get()).len;
+       }
 
-        while( inp.more() )
-          {
-           auto r=Mutate<const char>(inp.pump());
+     out.reserve(total);
 
-           out.put(r.ptr,r.len);
-          }
+     for(StrLen file : files )
+       {
+        WDirFileName file1(wdir,file);
+
+        RawFileToRead inp(file1.get());
+
+        out.copyFrom(inp);
        }
 
      out.preserveFile();
@@ -161,5 +560,135 @@ int IntCmdProc::mkdir(StrLen wdir,PtrLen<DDL::MapText> paths)
     }
  }
 
+int IntCmdProc::copy(StrLen wdir,PtrLen<DDL::MapText> files,StrLen dst)
+ {
+  try
+    {
+     WDirFileName dst1(wdir,dst);
+
+     bool to_dir=prepareTarget(dst1.get(),files);
+
+     MakeFileName buf;
+
+     for(StrLen file : files )
+       {
+        WDirFileName file1(wdir,file);
+
+        forFiles(file1.get(), [&] (StrLen src)
+                                  {
+                                   fs.copyFile(src,TargetOf(buf,dst1.get(),to_dir,src));
+
+                                  } );
+       }
+
+     return 0;
+    }
+  catch(CatchType)
+    {
+     return 1;
+    }
+ }
+
+int IntCmdProc::touch(StrLen wdir,PtrLen<DDL::MapText> files)
+ {
+  try
+    {
+     for(StrLen file : files )
+       {
+        WDirFileName file1(wdir,file);
+
+        forFiles(file1.get(), [&] (StrLen f) { fs.touchFile(f); } );
+       }
+
+     return 0;
+    }
+  catch(CatchType)
+    {
+     return 1;
+    }
+ }
+
+int IntCmdProc::link(StrLen wdir,PtrLen<DDL::MapText> files,StrLen dst,bool sym)
+ {
+  try
+    {
+     WDirFileName dst1(wdir,dst);
+
+     bool to_dir=prepareTarget(dst1.get(),files);
+
+     MakeFileName buf;
+
+     for(StrLen file : files )
+       {
+        if( sym )
+          {
+           // the link content is the file text, it is resolved from the link dir
+
+           CheckWildcard check(file);
+
+           if( check.ok )
+             {
+              // to_dir is set, the pattern is expanded from dst, the link content keeps the pattern dir
+
+              WDirFileName file1(dst1.get(),file);
+
+              MakeFileName text;
+
+              ExpandWildcard(fs,file1.get(), [&] (StrLen src)
+                                                 {
+                                                  SplitPath split1(src);
+                                                  SplitName split2(split1.path);
+
+                                                  fs.linkFile(text(check.dir,split2.name),TargetOf(buf,dst1.get(),true,src),true);
+
+                                                 } );
+             }
+           else
+             {
+              fs.linkFile(file,TargetOf(buf,dst1.get(),to_dir,file),true);
+             }
+          }
+        else
+          {
+           WDirFileName file1(wdir,file);
+
+           forFiles(file1.get(), [&] (StrLen src)
+                                     {
+                                      fs.linkFile(src,TargetOf(buf,dst1.get(),to_dir,src),false);
+
+                                     } );
+          }
+       }
+
+     return 0;
+    }
+  catch(CatchType)
+    {
+     return 1;
+    }
+ }
+
+int IntCmdProc::stamp(StrLen wdir,StrLen file)
+ {
+  try
+    {
+     WDirFileName file1(wdir,file);
+
+     PrintFile out(file1.get(),Open_ToWrite|Open_AutoDelete);
+
+     // the content is unique, so the content hash of the stamp is changed
+
+     Printf(out,"#; #;\n",SecTimer::Get(),USecTimer::Get());
+
+     out.preserveFile();
+
+     return 0;
+    }
+  catch(CatchType)
+    {
+     return 1;
+    }
+ }
+
 } // namespace VMake
 } // namespace App
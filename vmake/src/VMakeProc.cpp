@@ -12,8 +12,13 @@
 //----------------------------------------------------------------------------------------
 
 #include <inc/VMakeProc.h>
+#include <inc/VMakeIncScan.h>
 
 #include <CCore/inc/Path.h>
+#include <CCore/inc/MakeFileName.h>
+#include <CCore/inc/Sort.h>
+#include <CCore/inc/Task.h>
+#include <CCore/inc/sys/SysProp.h>
 #include <CCore/inc/Print.h>
 #include <CCore/inc/Exception.h>
 
@@ -32,6 +37,14 @@ void GuardStackEmpty()
 
 int FileProc::VMake(FileProc &file_proc,StrLen file_name,StrLen target,StrLen wdir)
  {
+  Tracer *tracer=file_proc.getTracer();
+
+  String name;
+
+  if( tracer ) name=Stringf("#; @ #;",file_name,target);
+
+  TraceScope scope(tracer,"vmake"_c,Range(name));
+
   DataProc proc(file_proc,file_name,target,wdir);
 
   return proc.make();
@@ -39,6 +52,13 @@ int FileProc::VMake(FileProc &file_proc,StrLen file_name,StrLen target,StrLen wd
 
 /* class DataProc */
 
+const DataFile & DataProc::Load(OptMember<DataFile> &obj,StrLen file_name,StrLen target,bool named,bool image,Tracer *tracer)
+ {
+  obj.create(file_name,target,named,image,tracer);
+
+  return *obj;
+ }
+
 template <class T,class R>
 R * DataProc::getRec(T *obj,DynArray<R *> &list)
  {
@@ -82,13 +102,24 @@ void DataProc::prepare(OneOfTypes<TypeDef::Rule,TypeDef::Dep> auto *obj)
   for(TypeDef::Target *ptr : obj->dst.getRange() ) if( ptr ) add(ptr,obj);
  }
 
+void DataProc::prepare(const DataFile &data)
+ {
+  for(auto ptr : data.getRules() ) prepare(ptr);
+
+  for(auto ptr : data.getDeps() ) prepare(ptr);
+ }
+
 void DataProc::prepare()
  {
+  TraceScope scope(file_proc.getTracer(),"vmake"_c,"prepare"_c);
+
   trecs.reserve(1000);
 
-  for(auto ptr : data.getRules() ) prepare(ptr);
+  prepare(data);
 
-  for(auto ptr : data.getDeps() ) prepare(ptr);
+  if( file_proc.useMerge() ) merge();
+
+  loadDeps();
 
   trecs.shrink_extra();
 
@@ -97,413 +128,1742 @@ void DataProc::prepare()
   works.reserve(trecs.getLen());
  }
 
-TypeDef::Rule * DataProc::getRule(TypeDef::Target *obj)
+auto DataProc::makeRange(TypeDef::Target *obj) -> DDL::MapRange<DDL::MapPtr<TypeDef::Target> >
  {
-  return getRec(obj)->rule;
+  auto list=pool.createArray<DDL::MapPtr<TypeDef::Target> >(1);
+
+  list[0].ptr=obj;
+
+  return {list.ptr,list.len};
  }
 
-template <class Func>
-void DataProc::applyToDeps(TypeDef::Target *obj,Func func)
+void DataProc::addDep(TypeDef::Target *src,DDL::MapRange<DDL::MapPtr<TypeDef::Target> > dst)
  {
-  getRec(obj)->deps.apply(func);
+  TypeDef::Dep *dep=pool.create<TypeDef::Dep>();
+
+  dep->src=makeRange(src);
+  dep->dst=dst;
+
+  prepare(dep);
  }
 
-template <class Func>
-bool DataProc::ApplyToSrc(OneOfTypes<TypeDef::Rule,TypeDef::Dep> auto *obj,Func func)
+auto DataProc::addSubFile(const DataFile *data,StrLen file_name,StrLen wdir,StrLen base) -> SubFile *
  {
-  for(TypeDef::Target *ptr : obj->src.getRange() ) if( ptr ) if( !func(ptr) ) return false;
+  StrKey key(pool.dup(Range(Stringf("#;|#;",file_name,wdir))));
 
-  return true;
+  SubTreeAlgo::PrepareIns prepare(sub_root,key);
+
+  if( prepare.found ) return prepare.found;
+
+  SubFile *sub=pool.create<SubFile>(data,pool.dup(file_name),pool.dup(wdir),pool.dup(base));
+
+  prepare.complete(sub);
+
+  return sub;
  }
 
-template <class Func>
-bool DataProc::applyToSrc(TypeDef::Target *obj,Func func)
+auto DataProc::getSubFile(SubFile *parent,TypeDef::VMake *cmd,DynArray<SubFile *> &list) -> SubFile *
  {
-  TRec *rec=getRec(obj);
+  StrLen sub_file_name=cmd->file;
+  StrLen target=cmd->target;
+  StrLen new_wdir=cmd->wdir;
 
-  if( rec->rule )
+  String sub_wdir;
+  String sub_base;
+
+  if( +new_wdir )
     {
-     if( !ApplyToSrc(rec->rule,func) ) return false;
+     WDirFileName wdir1(parent->wdir,new_wdir);
+     WDirFileName base1(parent->base,new_wdir);
+
+     sub_wdir=String(wdir1.get());
+     sub_base=String(base1.get());
+    }
+  else
+    {
+     sub_wdir=String(parent->wdir);
+     sub_base=String(parent->base);
     }
 
-  return rec->deps.applyWhile( [&] (TypeDef::Dep *obj) { return ApplyToSrc(obj,func); } );
+  StrKey key(Range(Stringf("#;|#;",sub_file_name,sub_wdir)));
+
+  if( SubFile *sub=sub_root.find(key) ) return sub;
+
+  // each sub-file is loaded once per wdir
+
+  DataFile *sub_data=new DataFile(sub_file_name,target,true,file_proc.useImage(),file_proc.getTracer());
+
+  sub_files.append_fill(sub_data);
+
+  SubFile *sub=addSubFile(sub_data,sub_file_name,Range(sub_wdir),Range(sub_base));
+
+  list.append_copy(sub);
+
+  prepare(*sub_data);
+
+  return sub;
  }
 
-bool DataProc::checkExist(StrLen dst)
+void DataProc::mergeTarget(SubFile *sub,TypeDef::Target *obj)
  {
-  return file_proc.checkExist(Range(wdir),dst);
+  TRec *rec=getRec(obj);
+
+  if( rec->merged ) return;
+
+  rec->merged=true;
+
+  StrLen file=obj->file;
+
+  if( !file ) return;
+
+  if( +sub->base )
+    {
+     WDirFileName file1(sub->base,file);
+
+     StrLen str=pool.dup(file1.get());
+
+     obj->file.ptr=const_cast<char *>(str.ptr);
+     obj->file.len=str.len;
+    }
+
+  merge_list.append_copy(obj);
  }
 
-bool DataProc::checkOlder(StrLen dst,StrLen src)
+bool DataProc::IsDelegation(TypeDef::Rule *rule)
  {
-  return file_proc.checkOlder(Range(wdir),dst,src);
+  bool ret=false;
+
+  for(auto &cmd : rule->cmd.getRange() )
+    {
+     if( !cmd.getPtr().castPtr<TypeDef::VMake>() ) return false;
+
+     ret=true;
+    }
+
+  return ret;
  }
 
-auto DataProc::findNode(StrLen file) -> TimeNode *
+void DataProc::linkFiles()
  {
-  StrKey key(file);
+  auto list=Range(merge_list);
 
-  TreeAlgo::PrepareIns prepare(root,key);
+  IncrSort(list, [] (TypeDef::Target *a,TypeDef::Target *b) { return StrLess(a->file,b->file); } );
 
-  if( prepare.found ) return prepare.found;
+  while( +list )
+    {
+     StrLen file=list[0]->file;
+     ulen len=1;
 
-  TimeNode *node=pool.create<TimeNode>();
+     while( len<list.len && file.equal(list[len]->file.getStr()) ) len++;
 
-  node->time=file_proc.getFileTime(Range(wdir),file);
+     auto group=list.prefix(len);
 
-  prepare.complete(node);
+     list+=len;
 
-  return node;
- }
+     if( len==1 ) continue;
 
-CmpFileTimeType DataProc::getFileTime(TypeDef::Target *obj)
- {
-  auto *rec=getRec(obj);
+     // the target with a rule builds the file for all others
+     // a delegation rule is not an owner, the merged sub target builds the file
 
-  if( auto *node=rec->time_node ) return node->time;
+     TypeDef::Target *owner=0;
 
-  auto *node=findNode(obj->file);
+     for(TypeDef::Target *obj : group )
+       if( TypeDef::Rule *rule=getRule(obj); rule && !IsDelegation(rule) )
+         {
+          if( owner )
+            {
+             Printf(Exception,"vmake file #.q; : multiple rules for file #.q;",file_name,file);
+            }
 
-  rec->time_node=node;
+          owner=obj;
+         }
 
-  return node->time;
- }
+     if( !owner ) continue;
 
-bool DataProc::checkOlderCache(TypeDef::Target *dst,TypeDef::Target *src)
- {
-  return getFileTime(dst) < getFileTime(src) ;
+     for(TypeDef::Target *obj : group ) if( obj!=owner ) addDep(owner,makeRange(obj));
+    }
  }
 
-bool DataProc::checkOlder(TypeDef::Target *dst,TypeDef::Target *src,bool nofile)
+void DataProc::merge()
  {
-  StrLen dst_file=dst->file;
-  StrLen src_file=src->file;
+  DynArray<SubFile *> list;
 
-  if( !dst_file )
-    {
-     return false;
-    }
-  else
+  list.append_copy(addSubFile(&data,file_name,wdir,""_c));
+
+  for(ulen ind=0; ind<list.getLen() ;ind++)
     {
-     if( !src_file )
+     SubFile *sub=list[ind];
+
+     for(TypeDef::Rule *rule : sub->data->getRules() )
        {
-        if( nofile )
-          {
-           Printf(Con,"--> nofile target #.q;\n",GetDesc(src));
-          }
+        getRec(rule)->sub=sub;
 
-        return nofile;
+        for(TypeDef::Target *ptr : rule->src.getRange() ) if( ptr ) mergeTarget(sub,ptr);
+
+        for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) mergeTarget(sub,ptr);
+
+        for(auto &cmd : rule->cmd.getRange() )
+          if( TypeDef::VMake *vmake=cmd.getPtr().castPtr<TypeDef::VMake>() )
+            {
+             SubFile *next=getSubFile(sub,vmake,list);
+
+             StrLen target_name=vmake->target;
+
+             TypeDef::Target *target=next->data->findTarget(target_name);
+
+             if( !target )
+               {
+                Printf(Exception,"vmake file #.q; : no target variable #.q;",next->file_name,target_name);
+               }
+
+             mergeTarget(next,target);
+
+             addDep(target,rule->dst);
+            }
        }
-     else
-       {
-        if( nofile? checkOlderCache(dst,src) : checkOlder(dst_file,src_file) )
-          {
-           Printf(Con,"--> #.q; < #.q;\n",dst_file,src_file);
 
-           return true;
-          }
+     for(TypeDef::Dep *dep : sub->data->getDeps() )
+       {
+        for(TypeDef::Target *ptr : dep->src.getRange() ) if( ptr ) mergeTarget(sub,ptr);
 
-        return false;
+        for(TypeDef::Target *ptr : dep->dst.getRange() ) if( ptr ) mergeTarget(sub,ptr);
        }
     }
+
+  linkFiles();
+
+  merge_list.erase();
+
+  if( list.getLen()>1 ) Printf(Con,"vmake : #; vmake files are merged\n\n",list.getLen());
  }
 
-bool DataProc::checkSelf(TypeDef::Target *dst)
+StrLen DataProc::getBase(TypeDef::Rule *rule)
  {
-  StrLen dst_file=dst->file;
+  if( SubFile *sub=getRec(rule)->sub ) return sub->base;
 
-  if( !dst_file )
-    {
-     if( getRec(dst)->rule )
-       {
-        Putobj(Con,"--> has a rule\n"_c);
+  return Empty;
+ }
 
-        return false;
-       }
+void DataProc::addTarget(TypeDef::Target *obj)
+ {
+  if( !obj ) return;
 
-     return true;
-    }
-  else
-    {
-     if( checkExist(dst_file) ) return true;
+  StrLen file=obj->file;
 
-     Printf(Con,"--> no file #.q;\n",dst_file);
+  if( !file ) return;
 
-     return false;
-    }
+  DynTreeAlgo::PrepareIns prepare(dyn_root,StrKey(file));
+
+  if( prepare.found ) return;
+
+  DynTarget *node=pool.create<DynTarget>();
+
+  node->target=obj;
+
+  prepare.complete(node);
  }
 
-bool DataProc::checkOlderSrc(TypeDef::Target *dst,bool nofile)
+TypeDef::Target * DataProc::getDynTarget(StrLen file_)
  {
-  return
+  StrKey key(file_);
 
-  applyToSrc(dst, [&] (TypeDef::Target *src)
-                      {
-                       switch( getRec(src)->state )
-                         {
-                          case StateOk : return !checkOlder(dst,src,nofile);
+  DynTreeAlgo::PrepareIns prepare(dyn_root,key);
 
-                          case StateRebuild :
-                           {
-                            Printf(Con,"--> rebuild #.q;\n",GetDesc(src));
+  if( prepare.found ) return prepare.found->target;
 
-                            return false;
-                           }
+  StrLen file=pool.dup(file_);
 
-                          default:
-                           {
-                            Printf(Exception,"vmake internal : unexpected src state");
+  TypeDef::Target *obj=pool.create<TypeDef::Target>();
 
-                            return false;
-                           }
-                         }
+  obj->desc.ptr=const_cast<char *>(file.ptr);
+  obj->desc.len=file.len;
+  obj->file=obj->desc;
+  obj->ext=0;
 
-                      } ) ;
+  DynTarget *node=pool.create<DynTarget>();
+
+  node->target=obj;
+
+  prepare.complete(node);
+
+  node->link.key.str=file;
+
+  getRec(obj)->dynamic=true;
+
+  return obj;
  }
 
-void DataProc::finish(TypeDef::Target *obj)
+void DataProc::addKnownTargets()
  {
-  if( checkSelf(obj) && checkOlderSrc(obj,true) )
-    {
-     getRec(obj)->state=StateOk;
-    }
-  else
+  if( dyn_known ) return;
+
+  dyn_known=true;
+
+  // known targets by file, a discovered src file may be built by a rule
+
+  auto add = [&] (const DataFile &data)
+                 {
+                  for(TypeDef::Rule *rule : data.getRules() )
+                    {
+                     for(TypeDef::Target *ptr : rule->src.getRange() ) addTarget(ptr);
+
+                     for(TypeDef::Target *ptr : rule->dst.getRange() ) addTarget(ptr);
+                    }
+
+                  for(TypeDef::Dep *dep : data.getDeps() )
+                    {
+                     for(TypeDef::Target *ptr : dep->src.getRange() ) addTarget(ptr);
+
+                     for(TypeDef::Target *ptr : dep->dst.getRange() ) addTarget(ptr);
+                    }
+                 } ;
+
+  add(data);
+
+  for(auto &obj : sub_files ) add(*obj);
+ }
+
+void DataProc::addDynDep(TypeDef::Rule *rule,PtrLen<TypeDef::Target *const> src)
+ {
+  if( !src.len ) return;
+
+  auto range=pool.createArray<DDL::MapPtr<TypeDef::Target> >(src.len);
+
+  for(ulen i=0; i<range.len ;i++) range[i].ptr=src[i];
+
+  TypeDef::Dep *dep=pool.create<TypeDef::Dep>();
+
+  dep->src={range.ptr,range.len};
+  dep->dst=rule->dst;
+
+  prepare(dep);
+ }
+
+void DataProc::loadDeps()
+ {
+  DynArray<TypeDef::Rule *> list;
+
+  auto scan = [&] (const DataFile &data)
+                  {
+                   for(TypeDef::Rule *rule : data.getRules() ) if( +rule->depfile.getStr() ) list.append_copy(rule);
+                  } ;
+
+  scan(data);
+
+  for(auto &obj : sub_files ) scan(*obj);
+
+  if( list.isEmpty() ) return;
+
+  deplog.create(StrLen(Range(StringCat(file_name,".deps"_c))));
+
+  addKnownTargets();
+
+  // one Dep per rule
+
+  DynArray<TypeDef::Target *> src;
+
+  for(TypeDef::Rule *rule : list )
     {
-     getRec(obj)->state=StateRebuild;
+     WDirFileName depfile(getBase(rule),rule->depfile);
 
-     addWork(obj);
+     src.erase();
+
+     deplog->apply(depfile.get(), [&] (StrLen file) { src.append_copy(getDynTarget(file)); } );
+
+     addDynDep(rule,Range(src));
     }
  }
 
-void DataProc::buildWorkTree()
+void DataProc::scanIncludes()
  {
-  Stack<TypeDef::Target *> stack;
+  DynArray<TypeDef::Rule *> list;
 
-  stack.push(data.getTarget());
+  auto scan = [&] (const DataFile &data)
+                  {
+                   for(TypeDef::Rule *rule : data.getRules() ) if( rule->inc ) list.append_copy(rule);
+                  } ;
 
-  while( stack.notEmpty() )
+  scan(data);
+
+  for(auto &obj : sub_files ) scan(*obj);
+
+  if( list.isEmpty() ) return;
+
+  addKnownTargets();
+
+  IncludeScanner scanner(file_proc,Range(wdir),Range(StringCat(file_name,".includes"_c)));
+
+  // one context per include path
+
+  struct CtxRec
+   {
+    TypeDef::Includes *inc;
+    StrLen base;
+    ulen ind;
+   };
+
+  DynArray<CtxRec> ctx_list;
+  DynArray<ulen> rule_ctx(DoReserve,list.getLen());
+
+  for(TypeDef::Rule *rule : list )
     {
-     file_proc.guard();
+     TypeDef::Includes *inc=rule->inc;
+     StrLen base=getBase(rule);
 
-     TypeDef::Target *obj=stack.top();
-     TRec *rec=getRec(obj);
+     ulen ind=MaxULen;
 
-     switch( rec->state )
+     for(const CtxRec &rec : ctx_list ) if( rec.inc==inc && rec.base.equal(base) ) { ind=rec.ind; break; }
+
+     if( ind==MaxULen )
        {
-        case StateInitial :
-         {
-          rec->state=StateLocked;
+        DynArray<String> path;
 
-          applyToSrc(obj, [&] (TypeDef::Target *src)
-                              {
-                               switch( getRec(src)->state )
-                                 {
-                                  case StateInitial :
+        for(StrLen dir : inc->path.getRange() )
+          {
+           WDirFileName dir1(base,dir);
+
+           path.append_fill(dir1.get());
+          }
+
+        DynArray<StrLen> path_list(DoReserve,path.getLen());
+
+        for(const String &str : path ) path_list.append_copy(Range(str));
+
+        ind=scanner.addContext(Range(path_list));
+
+        ctx_list.append_copy({inc,base,ind});
+       }
+
+     rule_ctx.append_copy(ind);
+
+     for(TypeDef::Target *ptr : rule->src.getRange() ) if( ptr && +ptr->file.getStr() ) scanner.addRoot(ind,ptr->file);
+    }
+
+  scanner.run();
+
+  // one Dep per rule
+
+  DynArray<StrLen> roots;
+  DynArray<TypeDef::Target *> src;
+
+  for(ulen i=0; i<list.getLen() ;i++)
+    {
+     TypeDef::Rule *rule=list[i];
+
+     roots.erase();
+     src.erase();
+
+     for(TypeDef::Target *ptr : rule->src.getRange() ) if( ptr && +ptr->file.getStr() ) roots.append_copy(ptr->file);
+
+     scanner.apply(rule_ctx[i],Range_const(roots), [&] (StrLen file) { src.append_copy(getDynTarget(file)); } );
+
+     addDynDep(rule,Range(src));
+    }
+
+  scanner.save();
+ }
+
+void DataProc::readDeps(TypeDef::Rule *rule)
+ {
+  if( !deplog ) return;
+
+  StrLen depfile=rule->depfile;
+
+  if( !depfile ) return;
+
+  StrLen base=getBase(rule);
+
+  WDirFileName depfile1(base,depfile);
+  WDirFileName depfile2(Range(wdir),depfile1.get());
+
+  if( !checkExist(depfile1.get()) )
+    {
+     Printf(Con,"vmake : no depfile #.q;\n",depfile1.get());
+
+     return;
+    }
+
+  DynArray<String> list;
+
+  try
+    {
+     DepFile file(depfile2.get());
+
+     file.apply( [&] (StrLen name)
+                     {
+                      WDirFileName name1(base,name);
+
+                      list.append_fill(name1.get());
+
+                     } );
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot read depfile #.q;\n",depfile1.get());
+
+     return;
+    }
+
+  deplog->add(depfile1.get(),Range(list));
+ }
+
+TypeDef::Rule * DataProc::getRule(TypeDef::Target *obj)
+ {
+  return getRec(obj)->rule;
+ }
+
+template <class Func>
+void DataProc::applyToDeps(TypeDef::Target *obj,Func func)
+ {
+  getRec(obj)->deps.apply(func);
+ }
+
+template <class Func>
+bool DataProc::ApplyToSrc(OneOfTypes<TypeDef::Rule,TypeDef::Dep> auto *obj,Func func)
+ {
+  for(TypeDef::Target *ptr : obj->src.getRange() ) if( ptr ) if( !func(ptr) ) return false;
+
+  return true;
+ }
+
+template <class Func>
+bool DataProc::applyToSrc(TypeDef::Target *obj,Func func)
+ {
+  TRec *rec=getRec(obj);
+
+  if( rec->rule )
+    {
+     if( !ApplyToSrc(rec->rule,func) ) return false;
+    }
+
+  return rec->deps.applyWhile( [&] (TypeDef::Dep *obj) { return ApplyToSrc(obj,func); } );
+ }
+
+bool DataProc::checkExist(StrLen dst)
+ {
+  return file_proc.checkExist(Range(wdir),dst);
+ }
+
+bool DataProc::checkOlder(StrLen dst,StrLen src)
+ {
+  return file_proc.checkOlder(Range(wdir),dst,src);
+ }
+
+CmpFileTimeType DataProc::getDirTime(StrLen dir)
+ {
+  return file_proc.getFileStatus(Range(wdir),+dir?dir:"."_c).time;
+ }
+
+void DataProc::setDir(DirNode *node,CmpFileTimeType time)
+ {
+  node->time=time;
+  node->trusted=( node->rec && node->time && node->rec->time==node->time );
+ }
+
+auto DataProc::findDir(StrLen dir,bool defer) -> DirNode *
+ {
+  StrKey key(dir);
+
+  DirTreeAlgo::PrepareIns prepare(dir_root,key);
+
+  if( prepare.found ) return prepare.found;
+
+  DirNode *node=pool.create<DirNode>();
+
+  node->rec=state->findDir(dir);
+  node->dirty=false;
+  node->index=0;
+
+  if( defer )
+    {
+     node->time=0;
+     node->trusted=false;
+    }
+  else
+    {
+     setDir(node,getDirTime(dir));
+    }
+
+  prepare.complete(node);
+
+  dir_nodes.append_copy(node);
+
+  return node;
+ }
+
+auto DataProc::findRec(FileNode *node,StrLen file) -> const BuildState::FileRec *
+ {
+  const BuildState::FileRec *rec=state->findFile(file);
+
+  if( rec && &state->getDir(*rec)!=node->dir->rec ) rec=0;
+
+  return rec;
+ }
+
+bool DataProc::trustNode(FileNode *node,StrLen file)
+ {
+  if( !file_proc.useTrust() || !node->dir->trusted ) return false;
+
+  const BuildState::FileRec *rec=findRec(node,file);
+
+  if( !rec ) return false;
+
+  node->data=BuildState::GetData(*rec);
+
+  node->trusted=true;
+
+  return true;
+ }
+
+void DataProc::setNode(FileNode *node,StrLen file,const FileStatus &status)
+ {
+  if( const BuildState::FileRec *rec=findRec(node,file) )
+    {
+     node->data=BuildState::GetData(*rec);
+
+     if( !SameStatus(*rec,status) ) node->data.content=0;
+    }
+
+  node->data.status=status;
+ }
+
+auto DataProc::findNode(StrLen file,bool defer) -> FileNode *
+ {
+  StrKey key(file);
+
+  TreeAlgo::PrepareIns prepare(root,key);
+
+  if( prepare.found ) return prepare.found;
+
+  FileNode *node=pool.create<FileNode>();
+
+  node->dir=findDir(PrefixPath(file),defer);
+  node->trusted=false;
+
+  if( !defer && !trustNode(node,file) ) setNode(node,file,file_proc.getFileStatus(Range(wdir),file));
+
+  prepare.complete(node);
+
+  file_nodes.append_copy(node);
+
+  return node;
+ }
+
+auto DataProc::getNode(TypeDef::Target *obj) -> FileNode *
+ {
+  auto *rec=getRec(obj);
+
+  if( auto *node=rec->file_node ) return node;
+
+  auto *node=findNode(obj->file,false);
+
+  rec->file_node=node;
+
+  return node;
+ }
+
+CmpFileTimeType DataProc::getFileTime(TypeDef::Target *obj)
+ {
+  return getNode(obj)->data.status.time;
+ }
+
+void DataProc::markDirty(TypeDef::Target *obj)
+ {
+  StrLen file=obj->file;
+
+  if( +file )
+    {
+     FileNode *node=getNode(obj);
+
+     node->dir->dirty=true;
+     node->data.src_hash=0;
+    }
+ }
+
+void DataProc::hashFiles(PtrLen<FileNode *> list)
+ {
+  RunParallel(list.len,Sys::GetCpuCount(), [&] (ulen ind)
+                                                 {
+                                                  FileNode *node=list[ind];
+
+                                                  WDirFileName file(Range(wdir),node->link.key.str);
+
+                                                  node->data.content=HashFile(file.get());
+
+                                                 } );
+ }
+
+void DataProc::scanHash()
+ {
+  Stack<TypeDef::Target *> stack;
+  DynArray<FileNode *> list;
+
+  stack.push(root_target);
+
+  while( stack.notEmpty() )
+    {
+     TypeDef::Target *obj=stack.top();
+
+     stack.pop();
+
+     TRec *rec=getRec(obj);
+
+     if( rec->scan ) continue;
+
+     rec->scan=true;
+
+     StrLen file=obj->file;
+
+     if( +file )
+       {
+        FileNode *node=getNode(obj);
+
+        if( node->data.status.type==FileType_file && !node->data.content ) list.append_copy(node);
+       }
+
+     applyToSrc(obj, [&] (TypeDef::Target *src)
+                         {
+                          if( !getRec(src)->scan ) stack.push(src);
+
+                          return true;
+
+                         } );
+    }
+
+  hashFiles(Range(list));
+ }
+
+uint64 DataProc::getSrcHash(TypeDef::Target *obj)
+ {
+  ContentHash hash;
+
+  bool ok=applyToSrc(obj, [&] (TypeDef::Target *src)
+                              {
+                               StrLen file=src->file;
+
+                               if( !file || getRec(src)->state!=StateOk ) return false;
+
+                               uint64 content=getNode(src)->data.content;
+
+                               if( !content ) return false;
+
+                               hash.add(file);
+                               hash.add(content);
+
+                               return true;
+
+                              } );
+
+  if( !ok ) return 0;
+
+  uint64 ret=hash.finish();
+
+  if( !ret ) ret=1;
+
+  return ret;
+ }
+
+bool DataProc::checkSrcHash(TypeDef::Target *obj)
+ {
+  if( !file_proc.useHash() ) return false;
+
+  StrLen file=obj->file;
+
+  if( !file ) return false;
+
+  uint64 src_hash=getNode(obj)->data.src_hash;
+
+  return src_hash && getSrcHash(obj)==src_hash ;
+ }
+
+uint64 DataProc::getSig(TypeDef::Rule *rule)
+ {
+  RRec *rule_rec=getRec(rule);
+
+  if( !rule_rec->sig ) rule_rec->sig=FileProc::GetSignature(getWDir(rule),rule);
+
+  return rule_rec->sig;
+ }
+
+bool DataProc::checkSig(TypeDef::Target *obj)
+ {
+  StrLen file=obj->file;
+  TypeDef::Rule *rule=getRule(obj);
+
+  if( !file || !rule ) return true;
+
+  uint64 sig=getNode(obj)->data.sig;
+
+  if( !sig || sig==getSig(rule) ) return true;
+
+  Printf(Con,"--> command changed #.q;\n",file);
+
+  return false;
+ }
+
+void DataProc::updateState(TypeDef::Target *obj) // obj is built
+ {
+  StrLen file=obj->file;
+
+  if( !file ) return;
+
+  FileNode *node=getNode(obj);
+
+  if( TypeDef::Rule *rule=getRule(obj) ) node->data.sig=getSig(rule);
+
+  if( !useContent() ) return;
+
+  WDirFileName file1(Range(wdir),file);
+
+  node->data.status=file_proc.getFileStatus(Range(wdir),file);
+  node->data.content=HashFile(file1.get());
+  node->data.src_hash=getSrcHash(obj);
+ }
+
+bool DataProc::SameStatus(const FileStatus &a,const FileStatus &b)
+ {
+  return a.type==b.type && a.time==b.time && a.len==b.len && a.id==b.id ;
+ }
+
+bool DataProc::SameStatus(const BuildState::FileRec &rec,const FileStatus &status)
+ {
+  return rec.type==status.type && rec.time==status.time && rec.len==status.len && rec.id==status.id ;
+ }
+
+bool DataProc::SameData(const BuildState::FileRec &rec,const BuildState::FileData &data)
+ {
+  return SameStatus(rec,data.status) && rec.sig==data.sig && rec.content==data.content && rec.src_hash==data.src_hash ;
+ }
+
+void DataProc::saveState()
+ {
+  bool changed=false;
+
+  // dirs
+
+  for(DirNode *dir : dir_nodes )
+    {
+     if( dir->dirty ) dir->time=getDirTime(dir->link.key.str);
+
+     if( !dir->rec || dir->rec->time!=dir->time ) changed=true;
+
+     dir->index=state->addDir(dir->link.key.str,dir->time);
+    }
+
+  // files
+
+  for(FileNode *node : file_nodes )
+    {
+     StrLen name=node->link.key.str;
+
+     BuildState::FileData &data=node->data;
+
+     if( node->dir->dirty )
+       {
+        FileStatus status=file_proc.getFileStatus(Range(wdir),name);
+
+        if( !SameStatus(data.status,status) ) data.content=0;
+
+        data.status=status;
+       }
+
+     const BuildState::FileRec *rec=state->findFile(name);
+
+     if( !rec || &state->getDir(*rec)!=node->dir->rec || !SameData(*rec,data) ) changed=true;
+
+     state->addFile(name,node->dir->index,data);
+    }
+
+  if( !changed ) return;
+
+  // files from the previous run, which are not visited
+
+  auto list=state->getFileList();
+
+  DynArray<uint32> dir_map;
+
+  for(const BuildState::FileRec &rec : list )
+    {
+     if( !state->checkFile(rec) ) continue;
+
+     StrLen name=state->getName(rec);
+
+     if( root.find(StrKey(name)) ) continue;
+
+     const BuildState::DirRec &dir_rec=state->getDir(rec);
+
+     StrLen dir_name=state->getName(dir_rec);
+
+     uint32 index;
+
+     if( DirNode *dir=dir_root.find(StrKey(dir_name)) )
+       {
+        if( dir->dirty || dir->time!=dir_rec.time ) continue;
+
+        index=dir->index;
+       }
+     else
+       {
+        if( dir_map.getLen()<=rec.dir ) dir_map.extend_fill(rec.dir+1-dir_map.getLen(),MaxUInt<uint32>);
+
+        if( dir_map[rec.dir]==MaxUInt<uint32> ) dir_map[rec.dir]=state->addDir(dir_name,dir_rec.time);
+
+        index=dir_map[rec.dir];
+       }
+
+     state->addFile(name,index,BuildState::GetData(rec));
+    }
+
+  state->save();
+ }
+
+bool DataProc::checkOlderCache(TypeDef::Target *dst,TypeDef::Target *src)
+ {
+  return getFileTime(dst) < getFileTime(src) ;
+ }
+
+bool DataProc::checkOlder(TypeDef::Target *dst,TypeDef::Target *src,bool nofile)
+ {
+  StrLen dst_file=dst->file;
+  StrLen src_file=src->file;
+
+  if( !dst_file )
+    {
+     return false;
+    }
+  else
+    {
+     if( !src_file )
+       {
+        if( nofile )
+          {
+           Printf(Con,"--> nofile target #.q;\n",GetDesc(src));
+          }
+
+        return nofile;
+       }
+     else
+       {
+        if( nofile && getRec(src)->dynamic && getNode(src)->data.status.type!=FileType_file )
+          {
+           Printf(Con,"--> no file #.q;\n",src_file);
+
+           return true;
+          }
+
+        if( nofile? checkOlderCache(dst,src) : checkOlder(dst_file,src_file) )
+          {
+           Printf(Con,"--> #.q; < #.q;\n",dst_file,src_file);
+
+           return true;
+          }
+
+        return false;
+       }
+    }
+ }
+
+bool DataProc::checkSelf(TypeDef::Target *dst)
+ {
+  StrLen dst_file=dst->file;
+
+  if( !dst_file )
+    {
+     if( getRec(dst)->rule )
+       {
+        Putobj(Con,"--> has a rule\n"_c);
+
+        return false;
+       }
+
+     return true;
+    }
+  else
+    {
+     if( getNode(dst)->data.status.type==FileType_file ) return true;
+
+     Printf(Con,"--> no file #.q;\n",dst_file);
+
+     return false;
+    }
+ }
+
+bool DataProc::checkOlderSrc(TypeDef::Target *dst,bool nofile)
+ {
+  return
+
+  applyToSrc(dst, [&] (TypeDef::Target *src)
+                      {
+                       switch( getRec(src)->state )
+                         {
+                          case StateOk : return !checkOlder(dst,src,nofile);
+
+                          case StateRebuild :
+                           {
+                            Printf(Con,"--> rebuild #.q;\n",GetDesc(src));
+
+                            return false;
+                           }
+
+                          default:
+                           {
+                            Printf(Exception,"vmake internal : unexpected src state");
+
+                            return false;
+                           }
+                         }
+
+                      } ) ;
+ }
+
+void DataProc::finish(TypeDef::Target *obj)
+ {
+  if( getRec(obj)->dynamic ) // a missing file rebuilds users, see checkOlder()
+    {
+     getRec(obj)->state=StateOk;
+
+     return;
+    }
+
+  if( checkSelf(obj) && checkSig(obj) && ( checkSrcHash(obj) || checkOlderSrc(obj,true) ) )
+    {
+     StrLen file=obj->file;
+
+     if( +file )
+       {
+        FileNode *node=getNode(obj);
+
+        if( TypeDef::Rule *rule=getRule(obj) ) node->data.sig=getSig(rule);
+
+        if( file_proc.useHash() ) node->data.src_hash=getSrcHash(obj);
+       }
+
+     getRec(obj)->state=StateOk;
+    }
+  else
+    {
+     getRec(obj)->state=StateRebuild;
+
+     addWork(obj);
+    }
+ }
+
+void DataProc::prefetch()
+ {
+  ulen dir_start=dir_nodes.getLen();
+  ulen file_start=file_nodes.getLen();
+
+  // collect
+
+  Stack<TypeDef::Target *> stack;
+
+  stack.push(root_target);
+
+  while( stack.notEmpty() )
+    {
+     TypeDef::Target *obj=stack.top();
+
+     stack.pop();
+
+     TRec *rec=getRec(obj);
+
+     if( rec->fetch ) continue;
+
+     rec->fetch=true;
+
+     StrLen file=obj->file;
+
+     if( +file && !rec->file_node ) rec->file_node=findNode(file,true);
+
+     applyToSrc(obj, [&] (TypeDef::Target *src)
+                         {
+                          if( !getRec(src)->fetch ) stack.push(src);
+
+                          return true;
+
+                         } );
+    }
+
+  struct StatRec
+   {
+    FileStatus status;
+    bool ok = false ;
+   };
+
+  auto stat = [&] (StrLen file,StatRec &ret)
+                  {
+                   SilentReportException report;
+
+                   try
+                     {
+                      ret.status=file_proc.getFileStatus(Range(wdir),file);
+                      ret.ok=true;
+                     }
+                   catch(CatchType)
+                     {
+                     }
+                  } ;
+
+  // dirs
+
+  {
+   PtrLen<DirNode *> list=Range(dir_nodes).part(dir_start);
+
+   DynArray<StatRec> stats(list.len);
+
+   RunParallel(list.len,StatThreads, [&] (ulen ind)
+                                         {
+                                          StrLen dir=list[ind]->link.key.str;
+
+                                          stat(+dir?dir:"."_c,stats[ind]);
+
+                                         } );
+
+   for(ulen ind=0; ind<list.len ;ind++)
+     {
+      DirNode *node=list[ind];
+
+      if( stats[ind].ok )
+        setDir(node,stats[ind].status.time);
+      else
+        setDir(node,getDirTime(node->link.key.str)); // reports the error
+     }
+  }
+
+  // files
+
+  {
+   DynArray<FileNode *> list;
+
+   for(FileNode *node : Range(file_nodes).part(file_start) )
+     {
+      if( !trustNode(node,node->link.key.str) ) list.append_copy(node);
+     }
+
+   IncrSort(Range(list), [] (FileNode *a,FileNode *b) { return StrLess(a->dir->link.key.str,b->dir->link.key.str); } );
+
+   // batches of files from the same dir
+
+   struct Batch
+    {
+     ulen off;
+     ulen len;
+    };
+
+   DynArray<Batch> batches;
+
+   for(ulen off=0; off<list.getLen() ;)
+     {
+      DirNode *dir=list[off]->dir;
+      ulen len=1;
+
+      while( off+len<list.getLen() && len<MaxBatchLen && list[off+len]->dir==dir ) len++;
+
+      batches.append_copy({off,len});
+
+      off+=len;
+     }
+
+   DynArray<StatRec> stats(list.getLen());
+
+   RunParallel(batches.getLen(),StatThreads, [&] (ulen ind)
+                                                 {
+                                                  Batch batch=batches[ind];
+
+                                                  for(ulen i=batch.off,lim=i+batch.len; i<lim ;i++) stat(list[i]->link.key.str,stats[i]);
+
+                                                 } );
+
+   for(ulen ind=0,len=list.getLen(); ind<len ;ind++)
+     {
+      FileNode *node=list[ind];
+      StrLen file=node->link.key.str;
+
+      if( stats[ind].ok )
+        setNode(node,file,stats[ind].status);
+      else
+        setNode(node,file,file_proc.getFileStatus(Range(wdir),file)); // reports the error
+     }
+  }
+ }
+
+void DataProc::buildWorkTree()
+ {
+  Stack<TypeDef::Target *> stack;
+
+  stack.push(root_target);
+
+  while( stack.notEmpty() )
+    {
+     file_proc.guard();
+
+     TypeDef::Target *obj=stack.top();
+     TRec *rec=getRec(obj);
+
+     switch( rec->state )
+       {
+        case StateInitial :
+         {
+          rec->state=StateLocked;
+
+          applyToSrc(obj, [&] (TypeDef::Target *src)
+                              {
+                               switch( getRec(src)->state )
+                                 {
+                                  case StateInitial :
+                                   {
+                                    stack.push(src);
+                                   }
+                                  break;
+
+                                  case StateLocked :
+                                   {
+                                    Printf(Exception,"vmake file #.q; : dependency loop detected #.q; #.q;",file_name,GetDesc(obj),GetDesc(src));
+                                   }
+                                  break;
+                                 }
+
+                               return true;
+
+                              } );
+         }
+        break;
+
+        case StateLocked :
+         {
+          finish(obj);
+
+          stack.pop();
+         }
+        break;
+
+        case StateOk :
+         {
+          stack.pop();
+         }
+        break;
+
+        case StateRebuild :
+         {
+          stack.pop();
+         }
+        break;
+
+        default:
+         {
+          Printf(Exception,"vmake internal : broken state");
+         }
+       }
+    }
+ }
+
+auto DataProc::getRec(TypeDef::Rule *obj) -> RRec *
+ {
+  return getRec(obj,rrecs);
+ }
+
+StrLen DataProc::getWDir(TypeDef::Rule *rule)
+ {
+  if( SubFile *sub=getRec(rule)->sub ) return sub->wdir;
+
+  return wdir;
+ }
+
+void DataProc::addWork(TypeDef::Target *obj)
+ {
+  Printf(Con,"rebuild #.q;\n",GetDesc(obj));
+
+  works.append_copy(obj);
+ }
+
+bool DataProc::dstReady(TypeDef::Target *obj)
+ {
+  return applyToSrc(obj, [&] (TypeDef::Target *src) { return getRec(src)->state==StateOk; } );
+ }
+
+bool DataProc::checkSelf(StrLen file)
+ {
+  if( checkExist(file) ) return true;
+
+  Printf(Con,"--> no file #.q;\n",file);
+
+  return false;
+ }
+
+bool DataProc::checkRebuild(TypeDef::Target *obj)
+ {
+  StrLen dst_file=obj->file;
+
+  if( !dst_file ) return dstReady(obj);
+
+  return checkSelf(dst_file) && checkOlderSrc(obj,false) ;
+ }
+
+int DataProc::exeRule(TypeDef::Rule *rule)
+ {
+  return file_proc.exeRule(getWDir(rule),rule);
+ }
+
+void DataProc::setOk(TypeDef::Target *obj)
+ {
+  TRec *rec=getRec(obj);
+
+  if( rec->state==StateOk ) return;
+
+  rec->state=StateOk;
+
+  ok_stack.push(obj);
+ }
+
+void DataProc::completeRule(TypeDef::Target *obj)
+ {
+  StrLen dst_file=obj->file;
+
+  if( !dst_file || ( checkSelf(dst_file) && checkOlderSrc(obj,false) ) )
+    {
+     updateState(obj);
+
+     setOk(obj);
+    }
+  else
+    {
+     exe_ok=false;
+
+     Printf(Con,"vmake : target #.q; is still not built\n",GetDesc(obj));
+    }
+ }
+
+void DataProc::completeRule(TypeDef::Rule *rule)
+ {
+  for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) completeRule(ptr);
+
+  readDeps(rule);
+ }
+
+void DataProc::watch(TypeDef::Target *obj)
+ {
+  TRec *rec=getRec(obj);
+
+  if( rec->watch ) return;
+
+  rec->watch=true;
+
+  applyToSrc(obj, [&] (TypeDef::Target *src)
+                      {
+                       TRec *src_rec=getRec(src);
+
+                       if( src_rec->state!=StateOk )
+                         {
+                          rec->wait++;
+
+                          src_rec->users.add(pool,obj);
+                         }
+
+                       return true;
+
+                      } );
+ }
+
+void DataProc::watch(TypeDef::Rule *rule)
+ {
+  RRec *rule_rec=getRec(rule);
+
+  if( rule_rec->init ) return;
+
+  rule_rec->init=true;
+
+  for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) watch(ptr);
+
+  for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr && getRec(ptr)->wait ) rule_rec->wait++;
+ }
+
+StrLen DataProc::getKey(TypeDef::Rule *rule)
+ {
+  RRec *rule_rec=getRec(rule);
+
+  if( +rule_rec->key ) return rule_rec->key;
+
+  PrintString out;
+
+  bool first=true;
+
+  for(TypeDef::Target *ptr : rule->dst.getRange() )
+    if( ptr )
+      {
+       StrLen name=ptr->file;
+
+       if( !name ) name=GetDesc(ptr);
+
+       if( first )
+         {
+          first=false;
+
+          Putobj(out,name);
+         }
+       else
+         {
+          Printf(out,"|#;",name);
+         }
+      }
+
+  String key=out.close();
+
+  rule_rec->key=pool.dup(Range(key));
+
+  return rule_rec->key;
+ }
+
+unsigned DataProc::getPath(TypeDef::Rule *rule) // tails of dst are built
+ {
+  RRec *rule_rec=getRec(rule);
+
+  if( rule_rec->path ) return rule_rec->path;
+
+  unsigned est=history->get(getKey(rule));
+
+  if( !est ) est=history->getAverage();
+
+  unsigned tail=0;
+
+  for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) Replace_max(tail,getRec(ptr)->tail);
+
+  rule_rec->est=est;
+  rule_rec->path=est+tail;
+
+  return rule_rec->path;
+ }
+
+template <class Func>
+void DataProc::applyToNext(TypeDef::Target *obj,Func func)
+ {
+  getRec(obj)->users.apply( [&] (TypeDef::Target *user)
+                                {
+                                 if( TypeDef::Rule *rule=getRec(user)->rule )
                                    {
-                                    stack.push(src);
+                                    for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) func(ptr);
                                    }
-                                  break;
-
-                                  case StateLocked :
+                                 else
                                    {
-                                    Printf(Exception,"vmake file #.q; : dependency loop detected #.q; #.q;",file_name,GetDesc(obj),GetDesc(src));
+                                    func(user);
                                    }
-                                  break;
-                                 }
 
-                               return true;
+                                } );
+ }
 
-                              } );
-         }
-        break;
+void DataProc::buildPath(TypeDef::Target *root_obj)
+ {
+  Stack<TypeDef::Target *> stack;
 
-        case StateLocked :
-         {
-          finish(obj);
+  stack.push(root_obj);
 
-          stack.pop();
-         }
-        break;
+  while( stack.notEmpty() )
+    {
+     TypeDef::Target *obj=stack.top();
+     TRec *rec=getRec(obj);
 
-        case StateOk :
+     switch( rec->path_state )
+       {
+        case PathInitial :
          {
-          stack.pop();
+          rec->path_state=PathLocked;
+
+          applyToNext(obj, [&] (TypeDef::Target *next)
+                               {
+                                if( getRec(next)->path_state==PathInitial ) stack.push(next);
+
+                               } );
          }
         break;
 
-        case StateRebuild :
+        case PathLocked :
          {
+          unsigned tail=0;
+
+          rec->users.apply( [&] (TypeDef::Target *user)
+                                {
+                                 TRec *user_rec=getRec(user);
+
+                                 if( TypeDef::Rule *rule=user_rec->rule )
+                                   Replace_max(tail,getPath(rule));
+                                 else
+                                   Replace_max(tail,user_rec->tail);
+
+                                } );
+
+          rec->tail=tail;
+          rec->path_state=PathDone;
+
           stack.pop();
          }
         break;
 
         default:
          {
-          Printf(Exception,"vmake internal : broken state");
+          stack.pop();
          }
        }
     }
  }
 
-auto DataProc::getRec(TypeDef::Rule *obj) -> RRec *
+void DataProc::report()
  {
-  return getRec(obj,rrecs);
- }
+  if( !last_rule ) return;
 
-void DataProc::addWork(TypeDef::Target *obj)
- {
-  Printf(Con,"rebuild #.q;\n",GetDesc(obj));
+  MSecTimer::ValueType actual=0;
+  ulen count=0;
 
-  works.append_copy(obj);
+  for(TypeDef::Rule *rule=last_rule; rule ;rule=getRec(rule)->trigger)
+    {
+     actual+=getRec(rule)->time;
+     count++;
+    }
+
+  if( predicted )
+    Printf(Con,"vmake : critical path predicted #; msec, actual #; msec ( #; rules ), wall #; msec\n",predicted_path,actual,count,commit_timer.get());
+  else
+    Printf(Con,"vmake : critical path no history, actual #; msec ( #; rules ), wall #; msec\n",actual,count,commit_timer.get());
+
+  history->save();
  }
 
-bool DataProc::dstReady(TypeDef::Target *obj)
+uint64 DataProc::getCacheKey(TypeDef::Rule *rule)
  {
-  return applyToSrc(obj, [&] (TypeDef::Target *src) { return getRec(src)->state==StateOk; } );
+  for(auto &cmd : rule->cmd.getRange() ) if( cmd.getPtr().castPtr<TypeDef::VMake>() ) return 0;
+
+  if( !rule->src.getRange() ) return 0; // the key is the command text only, it is not unique
+
+  ContentHash hash;
+
+  hash.add(getSig(rule));
+
+  for(TypeDef::Target *ptr : rule->dst.getRange() )
+    {
+     if( !ptr ) continue;
+
+     StrLen file=ptr->file;
+
+     if( !file ) return 0;
+
+     uint64 src_hash=getSrcHash(ptr);
+
+     if( !src_hash ) return 0;
+
+     hash.add(file);
+     hash.add(src_hash);
+    }
+
+  uint64 ret=hash.finish();
+
+  if( !ret ) ret=1;
+
+  return ret;
  }
 
-bool DataProc::canRun(TypeDef::Rule *obj)
+void DataProc::getCacheFiles(TypeDef::Rule *rule,DynArray<String> &files)
  {
-  for(TypeDef::Target *ptr : obj->dst.getRange() ) if( ptr && !dstReady(ptr) ) return false;
+  for(TypeDef::Target *ptr : rule->dst.getRange() )
+    if( ptr )
+      {
+       WDirFileName file(Range(wdir),ptr->file);
 
-  return true;
+       files.append_fill(file.get());
+      }
  }
 
-bool DataProc::checkSelf(StrLen file)
+bool DataProc::restoreRule(TypeDef::Rule *rule)
  {
-  if( checkExist(file) ) return true;
+  ArtifactCache *cache=file_proc.getCache();
 
-  Printf(Con,"--> no file #.q;\n",file);
+  if( !cache ) return false;
 
-  return false;
- }
+  RRec *rule_rec=getRec(rule);
 
-bool DataProc::checkRebuild(TypeDef::Target *obj)
- {
-  StrLen dst_file=obj->file;
+  rule_rec->cache_key=getCacheKey(rule);
 
-  if( !dst_file ) return dstReady(obj);
+  if( !rule_rec->cache_key ) return false;
 
-  return checkSelf(dst_file) && checkOlderSrc(obj,false) ;
- }
+  DynArray<String> files;
 
-bool DataProc::checkRebuild(TypeDef::Target *obj,TRec *rec)
- {
-  if( checkRebuild(obj) )
-    {
-     rec->state=StateOk;
+  getCacheFiles(rule,files);
 
-     return true;
-    }
+  if( !cache->restore(rule_rec->cache_key,Range_const(files)) ) return false;
 
-  StrLen file=obj->file;
+  for(TypeDef::Target *ptr : rule->dst.getRange() )
+    if( ptr )
+      {
+       Printf(Con,"restore #.q;\n",GetDesc(ptr));
 
-  if( +file )
-    Printf(Con,"vmake : target #.q; is still not built, no rule is found\n",GetDesc(obj));
+       break;
+      }
 
-  return false;
+  return true;
  }
 
-int DataProc::exeRule(TypeDef::Rule *rule)
+void DataProc::storeRule(TypeDef::Rule *rule)
  {
-  return file_proc.exeRule(Range(wdir),rule);
+  ArtifactCache *cache=file_proc.getCache();
+
+  if( !cache ) return;
+
+  RRec *rule_rec=getRec(rule);
+
+  if( !rule_rec->cache_key ) return;
+
+  for(TypeDef::Target *ptr : rule->dst.getRange() )
+    if( ptr && getRec(ptr)->state!=StateOk ) return;
+
+  DynArray<String> files;
+
+  getCacheFiles(rule,files);
+
+  cache->store(rule_rec->cache_key,Range_const(files));
  }
 
-void DataProc::completeRule(TypeDef::Target *obj)
+void DataProc::pushRule(TypeDef::Rule *rule)
  {
-  StrLen dst_file=obj->file;
+  RRec *rule_rec=getRec(rule);
 
-  if( !dst_file || ( checkSelf(dst_file) && checkOlderSrc(obj,false) ) )
-    {
-     getRec(obj)->state=StateOk;
-    }
-  else
+  if( rule_rec->done ) return;
+
+  rule_rec->done=true;
+  rule_rec->trigger=current_rule;
+
+  if( restoreRule(rule) )
     {
-     exe_ok=false;
+     completeRule(rule); // ok_stack is drained by the caller
 
-     Printf(Con,"vmake : target #.q; is still not built\n",GetDesc(obj));
+     return;
     }
- }
 
-void DataProc::completeRule(TypeDef::Rule *rule)
- {
-  for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) completeRule(ptr);
+  if( exelist )
+    exelist->add(rule,getPath(rule),getWDir(rule));
+  else
+    ready_list.append_copy(rule);
  }
 
-auto DataProc::tryCommit(TypeDef::Target *obj) -> GetRuleResult
+void DataProc::srcReady(TypeDef::Target *obj)
  {
-  file_proc.guard();
-
   TRec *rec=getRec(obj);
 
-  if( rec->state==StateOk ) return {true,0};
-
   if( TypeDef::Rule *rule=rec->rule )
     {
      RRec *rule_rec=getRec(rule);
 
-     if( rule_rec->done )
+     for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr==obj ) rule_rec->wait--;
+
+     if( !rule_rec->wait ) pushRule(rule);
+    }
+  else if( rec->state!=StateOk )
+    {
+     if( checkRebuild(obj) )
        {
-        return {false,0};
+        setOk(obj);
        }
      else
        {
-        if( canRun(rule) )
-          {
-           rule_rec->done=true;
+        StrLen file=obj->file;
 
-           return {false,rule};
-          }
-        else
-          {
-           return {false,0};
-          }
+        if( +file )
+          Printf(Con,"vmake : target #.q; is still not built, no rule is found\n",GetDesc(obj));
        }
     }
-  else
+ }
+
+void DataProc::propagate()
+ {
+  while( ok_stack.notEmpty() )
     {
-     return {checkRebuild(obj,rec),0};
+     TypeDef::Target *obj=ok_stack.top();
+
+     ok_stack.pop();
+
+     getRec(obj)->users.apply( [&] (TypeDef::Target *user)
+                                   {
+                                    if( --getRec(user)->wait==0 ) srcReady(user);
+
+                                   } );
     }
  }
 
-bool DataProc::commit(TypeDef::Target *obj)
+void DataProc::startCommit()
  {
-  file_proc.guard();
+  rrecs.reserve(1000);
+
+  for(TypeDef::Target *obj : works ) markDirty(obj);
+
+  for(TypeDef::Target *obj : works )
+    {
+     TRec *rec=getRec(obj);
+
+     if( TypeDef::Rule *rule=rec->rule )
+       watch(rule);
+     else
+       watch(obj);
+    }
 
-  auto result=tryCommit(obj);
+  history.create(StrLen(Range(StringCat(file_name,".history"_c))));
 
-  if( result.rule )
+  predicted=!history->isEmpty();
+
+  for(TypeDef::Target *obj : works )
     {
-     int status=exeRule(result.rule);
+     TRec *rec=getRec(obj);
 
-     if( status==0 )
+     if( TypeDef::Rule *rule=rec->rule )
        {
-        completeRule(result.rule);
+        for(TypeDef::Target *ptr : rule->dst.getRange() ) if( ptr ) buildPath(ptr);
 
-        return getRec(obj)->state==StateOk;
+        Replace_max(predicted_path,getPath(rule));
        }
-     else
-       {
-        exe_ok=false;
+    }
 
-        Printf(Con,"vmake : rule failed #;\n",status);
+  commit_timer.reset();
 
-        return false;
+  for(TypeDef::Target *obj : works )
+    {
+     TRec *rec=getRec(obj);
+
+     if( TypeDef::Rule *rule=rec->rule )
+       {
+        if( !getRec(rule)->wait ) pushRule(rule);
+       }
+     else
+       {
+        if( !rec->wait ) srcReady(obj);
        }
     }
-  else
+
+  propagate();
+ }
+
+int DataProc::finishCommit()
+ {
+  report();
+
+  for(TypeDef::Target *obj : works )
+    if( getRec(obj)->state!=StateOk )
+      {
+       if( exe_ok )
+         {
+          Printf(Con,"\nRebuild stalled #.q;\n\n",GetDesc(obj));
+         }
+
+       return 1000;
+      }
+
+  if( exe_ok )
     {
-     return result.commit;
+     Putobj(Con,"\nSuccess!\n\n");
+
+     return 0;
     }
+
+  return 1000;
  }
 
 int DataProc::commit()
  {
-  rrecs.reserve(1000);
-
-  auto list=Range(works);
-
-  if( !list )
+  if( works.isEmpty() )
     {
      Putobj(Con,"\nAll done.\n\n");
 
@@ -512,42 +1872,51 @@ int DataProc::commit()
 
   Printf(Con,"\nCommit ...\n\n");
 
-  while( +list )
+  Tracer *tracer=file_proc.getTracer();
+
+  startCommit();
+
+  for(ulen ind=0; ind<ready_list.getLen() ;ind++)
     {
-     auto save=list.ptr;
+     file_proc.guard();
 
-     for(TypeDef::Target *obj : list )
-       if( !commit(obj) )
-         {
-          *(save++)=obj;
-         }
+     TypeDef::Rule *rule=ready_list[ind];
 
-     if( !Change(list.len,Dist(list.ptr,save)) )
-       {
-        if( exe_ok )
-          {
-           Printf(Con,"\nRebuild stalled #.q;\n\n",GetDesc(*list));
-          }
+     MSecTimer timer;
 
-        return 1000;
-       }
-    }
+     uint64 start=( tracer ? tracer->now() : 0 );
 
-  if( exe_ok )
-    {
-     Putobj(Con,"\nSuccess!\n\n");
+     int status=exeRule(rule);
 
-     return 0;
+     if( tracer ) tracer->complete("rule"_c,TraceName(rule),start,1,"status"_c,uint64(status)); // slot 0
+
+     finishRule(rule,status,timer.get());
     }
 
-  return 1000;
+  return finishCommit();
  }
 
-void DataProc::finishRule(TypeDef::Rule *rule,int status)
+void DataProc::finishRule(TypeDef::Rule *rule,int status,MSecTimer::ValueType time)
  {
+  RRec *rule_rec=getRec(rule);
+
+  rule_rec->time=time;
+
+  last_rule=rule;
+
   if( status==0 )
     {
+     history->set(getKey(rule),unsigned(time));
+
+     current_rule=rule;
+
      completeRule(rule);
+
+     storeRule(rule);
+
+     propagate();
+
+     current_rule=0;
     }
   else
     {
@@ -557,18 +1926,9 @@ void DataProc::finishRule(TypeDef::Rule *rule,int status)
     }
  }
 
-void DataProc::exeRuleList(PtrLen<ExeRule> rules,ExeRule * buf[])
- {
-  file_proc.exeRuleList(Range(wdir),rules,buf,function_finishRule());
- }
-
 int DataProc::commitPExe()
  {
-  rrecs.reserve(1000);
-
-  auto list=Range(works);
-
-  if( !list )
+  if( works.isEmpty() )
     {
      Putobj(Con,"\nAll done.\n\n");
 
@@ -577,62 +1937,23 @@ int DataProc::commitPExe()
 
   Printf(Con,"\nCommit ...\n\n");
 
-  SimpleArray<ExeRule> rule_buf(list.len);
-  SimpleArray<ExeRule *> ptr_buf(list.len);
-
-  auto passFunc = [&] ()
-                      {
-                       auto save=list.ptr;
-
-                       auto out=rule_buf.getPtr();
-
-                       for(TypeDef::Target *obj : list )
-                         {
-                          auto result=tryCommit(obj);
-
-                          if( result.rule )
-                            {
-                             out->set(result.rule);
-
-                             out++;
-
-                             *(save++)=obj;
-                            }
-                          else if( !result.commit )
-                            {
-                             *(save++)=obj;
-                            }
-                         }
-
-                       bool ret=Change(list.len,Dist(list.ptr,save));
-
-                       exeRuleList(Range(rule_buf.getPtr(),out),ptr_buf.getPtr());
+  ulen len=works.getLen();
 
-                       return ret;
+  SimpleArray<ExeRule> rule_buf(len);
+  SimpleArray<ExeRule *> ptr_buf(len);
+  SimpleArray<ExeRule *> heap_buf(len);
 
-                      } ;
+  ExeList list(Range(rule_buf.getPtr(),len),ptr_buf.getPtr(),heap_buf.getPtr(),function_finishRule(),file_proc.useMerge(),file_proc.getTracer(),file_proc.getUsageLog());
 
-  while( +list )
-    {
-     if( !passFunc() && !passFunc() )
-       {
-        if( exe_ok )
-          {
-           Printf(Con,"\nRebuild stalled #.q;\n\n",GetDesc(*list));
-          }
+  exelist=&list;
 
-        return 1000;
-       }
-    }
+  startCommit();
 
-  if( exe_ok )
-    {
-     Putobj(Con,"\nSuccess!\n\n");
+  file_proc.exeRuleList(list);
 
-     return 0;
-    }
+  exelist=0;
 
-  return 1000;
+  return finishCommit();
  }
 
 DataProc::DataProc(FileProc &file_proc,StrLen file_name,StrLen target)
@@ -642,8 +1963,22 @@ DataProc::DataProc(FileProc &file_proc,StrLen file_name,StrLen target)
 
 DataProc::DataProc(FileProc &file_proc_,StrLen file_name_,StrLen target,StrLen wdir_)
  : file_proc(file_proc_),
-   data(file_name_,target)
+   data(Load(own_data,file_name_,target,file_proc_.useMerge(),file_proc_.useImage(),file_proc_.getTracer())),
+   root_target(data.getTarget())
+ {
+  file_name=pool.dup(file_name_);
+  wdir=pool.dup(wdir_);
+
+  prepare();
+ }
+
+DataProc::DataProc(FileProc &file_proc_,const DataFile &data_,TypeDef::Target *target,StrLen file_name_,StrLen wdir_)
+ : file_proc(file_proc_),
+   data(data_),
+   root_target(target)
  {
+  data.clearExt(target);
+
   file_name=pool.dup(file_name_);
   wdir=pool.dup(wdir_);
 
@@ -656,16 +1991,67 @@ DataProc::~DataProc()
 
 int DataProc::make()
  {
-  buildWorkTree();
+  Tracer *tracer=file_proc.getTracer();
 
-  if( file_proc.usePExe() )
-    {
-     return commitPExe();
-    }
-  else
-    {
-     return commit();
-    }
+  state.create(StrLen(Range(StringCat(file_name,".state"_c))));
+
+  {
+   StatCacheScope scope(file_proc,Range(wdir)); // no commands run in the scope
+
+   {
+    TraceScope scope(tracer,"vmake"_c,"scanIncludes"_c);
+
+    scanIncludes();
+   }
+
+   {
+    TraceScope scope(tracer,"vmake"_c,"prefetch"_c);
+
+    prefetch();
+   }
+
+   if( useContent() )
+     {
+      TraceScope scope(tracer,"vmake"_c,"scanHash"_c);
+
+      scanHash();
+     }
+
+   {
+    TraceScope scope(tracer,"vmake"_c,"buildWorkTree"_c);
+
+    buildWorkTree();
+   }
+  }
+
+  int ret;
+
+  {
+   TraceScope scope(tracer,"vmake"_c,"commit"_c);
+
+   if( file_proc.usePExe() )
+     {
+      ret=commitPExe();
+     }
+   else
+     {
+      ret=commit();
+     }
+  }
+
+  {
+   StatCacheScope scope(file_proc,Range(wdir));
+
+   TraceScope trace_scope(tracer,"vmake"_c,"saveState"_c);
+
+   saveState();
+  }
+
+  if( +deplog ) deplog->save();
+
+  if( ArtifactCache *cache=file_proc.getCache(); cache && file_proc.isTopLevel() ) cache->finish();
+
+  return ret;
  }
 
 } // namespace VMake
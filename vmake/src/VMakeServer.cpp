@@ -0,0 +1,177 @@
+/* VMakeServer.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeServer.h>
+
+#include <CCore/inc/Print.h>
+#include <CCore/inc/Exception.h>
+#include <CCore/inc/Timer.h>
+#include <CCore/inc/PrintTime.h>
+
+namespace App {
+namespace VMake {
+
+/* functions */
+
+int RunClient(StrLen socket,StrLen target)
+ {
+  LocalClient client(socket);
+
+  client.send(target);
+
+  return client.wait();
+ }
+
+/* class Server */
+
+bool Server::changed()
+ {
+  if( !data ) return true;
+
+  StatCacheScope scope(file_proc,""_c);
+
+  PtrLen<const String> files=data->getFiles();
+
+  for(ulen i=0; i<files.len ;i++)
+    {
+     FileStatus status=file_proc.getFileStatus(""_c,Range(files[i]));
+
+     if( status.type!=data_status[i].type || status.time!=data_status[i].time ) return true;
+    }
+
+  return false;
+ }
+
+void Server::load()
+ {
+  data.destroy();
+
+  data_status.erase();
+
+  data.create(file_name,target,true,file_proc.useImage(),file_proc.getTracer());
+
+  StatCacheScope scope(file_proc,""_c);
+
+  for(const String &file : data->getFiles() ) data_status.append_fill(file_proc.getFileStatus(""_c,Range(file)));
+ }
+
+int Server::build(StrLen target_name)
+ {
+  SecTimer timer;
+
+  if( changed() )
+    {
+     Printf(Con,"load #.q;\n",file_name);
+
+     load();
+    }
+
+  if( !target_name ) target_name=target;
+
+  TypeDef::Target *obj=data->findTarget(target_name);
+
+  if( !obj )
+    {
+     Printf(Exception,"vmake file #.q; : no target variable #.q;",file_name,target_name);
+    }
+
+  Printf(Con,"#; @ #;\n\n",file_name,target_name);
+
+  DataProc proc(file_proc,*data,obj,file_name,PrefixPath(file_name));
+
+  int ret=proc.make();
+
+  file_proc.saveTrace();
+
+  file_proc.saveUsage();
+
+  Printf(Con,"time = #;\n\n",PrintTime(timer.get()));
+
+  return ret;
+ }
+
+int Server::request(StrLen target_name) noexcept
+ {
+  try
+    {
+     ReportException report;
+
+     int ret=build(target_name);
+
+     report.guard();
+
+     return ret;
+    }
+  catch(CatchType)
+    {
+     return 1;
+    }
+ }
+
+Server::Server(FileProc &file_proc_,StrLen file_name_,StrLen target_)
+ : file_proc(file_proc_),
+   file_name(file_name_),
+   target(target_)
+ {
+ }
+
+Server::~Server()
+ {
+ }
+
+void Server::run(StrLen socket)
+ {
+  try
+    {
+     SilentReportException report;
+
+     file_proc.openWatch();
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : file watch is not available\n\n");
+    }
+
+  LocalServer server(socket);
+
+  Printf(Con,"vmake : server #.q; is ready\n\n",socket);
+
+  for(;;)
+    {
+     try
+       {
+        ReportException report;
+
+        LocalServer::Request req(server);
+
+        String text(req.getText());
+
+        req.redirect();
+
+        int status=request(Range(text));
+
+        req.restore();
+
+        req.reply(status);
+
+        report.guard();
+       }
+     catch(CatchType)
+       {
+       }
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
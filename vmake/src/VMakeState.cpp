@@ -0,0 +1,265 @@
+/* VMakeState.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeState.h>
+
+#include <CCore/inc/FileSystem.h>
+
+#include <CCore/inc/Print.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* class BuildState */
+
+auto BuildState::GetData(const FileRec &rec) -> FileData
+ {
+  FileData ret;
+
+  ret.status.type=FileType(rec.type);
+  ret.status.time=rec.time;
+  ret.status.len=rec.len;
+  ret.status.id=rec.id;
+
+  ret.sig=rec.sig;
+  ret.content=rec.content;
+  ret.src_hash=rec.src_hash;
+
+  return ret;
+ }
+
+template <class Rec>
+const Rec * BuildState::find(const uint32 *slot,const Rec *list,uint32 count,StrLen name) const
+ {
+  if( !header ) return 0;
+
+  StrKey key(name);
+
+  uint32 mask=header->slot_count-1;
+
+  for(uint32 ind=key.hash&mask,cnt=header->slot_count; cnt ;cnt--,ind=(ind+1)&mask)
+    {
+     uint32 s=slot[ind];
+
+     if( !s ) return 0;
+
+     if( s<=count )
+       {
+        const Rec &rec=list[s-1];
+
+        if( rec.hash==key.hash && checkName(rec.name_off,rec.name_len) && name.equal(getName(rec)) ) return &rec;
+       }
+    }
+
+  return 0;
+ }
+
+void BuildState::load()
+ {
+  FileSystem fs;
+
+  if( fs.getFileType(Range(file_name))!=FileType_file ) return;
+
+  image=FileToMem(Range(file_name));
+
+  const uint8 *base=image.getPtr();
+  ulen len=image.getLen();
+
+  if( len<sizeof (Header) ) return;
+
+  const Header *h=reinterpret_cast<const Header *>(base);
+
+  if( h->magic!=Magic || h->version!=Version ) return;
+
+  uint32 slot_count=h->slot_count;
+
+  if( slot_count<2 || (slot_count&(slot_count-1)) ) return;
+
+  uint64 total=sizeof (Header)+uint64(slot_count)*2*sizeof (uint32)+uint64(h->file_count)*sizeof (FileRec)+uint64(h->dir_count)*sizeof (DirRec)+h->text_len;
+
+  if( total!=len ) return;
+
+  const uint8 *ptr=base+sizeof (Header);
+
+  file_slot=reinterpret_cast<const uint32 *>(ptr);
+
+  ptr+=slot_count*sizeof (uint32);
+
+  dir_slot=reinterpret_cast<const uint32 *>(ptr);
+
+  ptr+=slot_count*sizeof (uint32);
+
+  file_list=reinterpret_cast<const FileRec *>(ptr);
+
+  ptr+=h->file_count*sizeof (FileRec);
+
+  dir_list=reinterpret_cast<const DirRec *>(ptr);
+
+  ptr+=h->dir_count*sizeof (DirRec);
+
+  text=reinterpret_cast<const char *>(ptr);
+
+  header=h;
+ }
+
+BuildState::BuildState(StrLen file_name_)
+ : file_name(file_name_)
+ {
+  try
+    {
+     load();
+    }
+  catch(CatchType)
+    {
+     header=0;
+    }
+ }
+
+BuildState::~BuildState()
+ {
+ }
+
+ // old state
+
+auto BuildState::findFile(StrLen file) const -> const FileRec *
+ {
+  if( !header ) return 0;
+
+  const FileRec *rec=find(file_slot,file_list,header->file_count,file);
+
+  if( rec && rec->dir<header->dir_count ) return rec;
+
+  return 0;
+ }
+
+auto BuildState::findDir(StrLen dir) const -> const DirRec *
+ {
+  if( !header ) return 0;
+
+  return find(dir_slot,dir_list,header->dir_count,dir);
+ }
+
+auto BuildState::getFileList() const -> PtrLen<const FileRec>
+ {
+  if( !header ) return Empty;
+
+  return Range(file_list,header->file_count);
+ }
+
+bool BuildState::checkFile(const FileRec &rec) const
+ {
+  return rec.dir<header->dir_count && checkName(rec.name_off,rec.name_len) && checkName(dir_list[rec.dir].name_off,dir_list[rec.dir].name_len) ;
+ }
+
+ // new state
+
+uint32 BuildState::addDir(StrLen dir,CmpFileTimeType time)
+ {
+  uint32 ret=uint32( new_dirs.getLen() );
+
+  new_dirs.append_fill(DirEntry{StrKey(dir),time});
+
+  return ret;
+ }
+
+void BuildState::addFile(StrLen file,uint32 dir,const FileData &data)
+ {
+  new_files.append_fill(FileEntry{StrKey(file),dir,data});
+ }
+
+void BuildState::save()
+ {
+  ulen file_count=new_files.getLen();
+  ulen dir_count=new_dirs.getLen();
+
+  ulen slot_count=2;
+
+  while( slot_count<2*Max(file_count,dir_count) ) slot_count*=2;
+
+  SimpleArray<uint32> slot(2*slot_count);
+
+  Range(slot).set_null();
+
+  auto fill = [&] (uint32 *slot,auto list)
+                  {
+                   uint32 mask=uint32(slot_count-1);
+
+                   for(ulen i=0; i<list.len ;i++)
+                     {
+                      uint32 ind=list[i].key.hash&mask;
+
+                      while( slot[ind] ) ind=(ind+1)&mask;
+
+                      slot[ind]=uint32(i+1);
+                     }
+                  } ;
+
+  fill(slot.getPtr(),Range(new_files));
+  fill(slot.getPtr()+slot_count,Range(new_dirs));
+
+  ulen text_len=0;
+
+  for(auto &entry : new_files ) text_len+=entry.key.str.len;
+
+  for(auto &entry : new_dirs ) text_len+=entry.key.str.len;
+
+  try
+    {
+     PrintFile out(Range(file_name),Open_ToWrite|Open_AutoDelete);
+
+     auto put = [&] (const auto &obj) { out.put(reinterpret_cast<const char *>(&obj),sizeof obj); } ;
+
+     Header h{Magic,Version,uint32(slot_count),uint32(file_count),uint32(dir_count),uint32(text_len)};
+
+     put(h);
+
+     out.put(reinterpret_cast<const char *>(slot.getPtr()),2*slot_count*sizeof (uint32));
+
+     uint32 off=0;
+
+     for(auto &entry : new_files )
+       {
+        const FileData &data=entry.data;
+
+        FileRec rec{data.status.time,data.status.len,data.status.id,data.sig,data.content,data.src_hash,data.status.type,entry.dir,entry.key.hash,off,uint32(entry.key.str.len),0};
+
+        put(rec);
+
+        off+=rec.name_len;
+       }
+
+     for(auto &entry : new_dirs )
+       {
+        DirRec rec{entry.time,entry.key.hash,off,uint32(entry.key.str.len),0};
+
+        put(rec);
+
+        off+=rec.name_len;
+       }
+
+     for(auto &entry : new_files ) Putobj(out,entry.key.str);
+
+     for(auto &entry : new_dirs ) Putobj(out,entry.key.str);
+
+     out.preserveFile();
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save build state #.q;\n",file_name);
+    }
+ }
+
+} // namespace VMake
+} // namespace App
+
@@ -0,0 +1,148 @@
+/* VMakeTrace.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeTrace.h>
+
+#include <CCore/inc/Print.h>
+#include <CCore/inc/print/PrintFile.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* struct PrintJson */
+
+struct PrintJson
+ {
+  StrLen str;
+
+  explicit PrintJson(StrLen str_) : str(str_) {}
+
+  void print(PrinterType auto &out) const
+   {
+    out.put('"');
+
+    for(char ch : str )
+      {
+       switch( ch )
+         {
+          case '"' : out.put('\\'); out.put('"'); break;
+          case '\\' : out.put('\\'); out.put('\\'); break;
+          case '\n' : out.put('\\'); out.put('n'); break;
+          case '\r' : out.put('\\'); out.put('r'); break;
+          case '\t' : out.put('\\'); out.put('t'); break;
+
+          default:
+           {
+            if( uint8(ch)<32 )
+              Printf(out,"\\u#4.16i;",uint8(ch));
+            else
+              out.put(ch);
+           }
+         }
+      }
+
+    out.put('"');
+   }
+ };
+
+/* class Tracer */
+
+void Tracer::add(char ph,StrLen cat,StrLen name,uint64 ts,uint64 dur,ulen tid,uint64 id,StrLen arg_name,uint64 arg)
+ {
+  events.append_copy({cat,pool.dup(name),ts,dur,id,arg_name,arg,tid,ph});
+ }
+
+Tracer::Tracer()
+ {
+  events.reserve(1000);
+ }
+
+Tracer::~Tracer()
+ {
+ }
+
+void Tracer::complete(StrLen cat,StrLen name,uint64 start,ulen tid,StrLen arg_name,uint64 arg)
+ {
+  uint64 t=now();
+
+  add('X',cat,name,start,t-start,tid,0,arg_name,arg);
+ }
+
+void Tracer::begin(StrLen cat,StrLen name,uint64 id)
+ {
+  add('b',cat,name,now(),0,0,id,Empty,0);
+ }
+
+void Tracer::end(StrLen cat,StrLen name,uint64 id)
+ {
+  add('e',cat,name,now(),0,0,id,Empty,0);
+ }
+
+void Tracer::save(StrLen file_name)
+ {
+  try
+    {
+     PrintFile out(file_name,Open_ToWrite|Open_AutoDelete);
+
+     Putobj(out,"{\"traceEvents\":[\n");
+
+     Printf(out,"{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"vmake\"}}");
+
+     for(ulen i=0; i<slot_count ;i++)
+       {
+        Printf(out,",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":#;,\"args\":{\"name\":\"slot #;\"}}",i+1,i);
+       }
+
+     for(const Event &e : events )
+       {
+        Printf(out,",\n{\"ph\":\"#;\",\"cat\":#;,\"name\":#;,\"pid\":1,\"tid\":#;,\"ts\":#;",StrLen(&e.ph,1),PrintJson(e.cat),PrintJson(e.name),e.tid,e.ts);
+
+        switch( e.ph )
+          {
+           case 'X' :
+            {
+             Printf(out,",\"dur\":#;",e.dur);
+
+             if( +e.arg_name ) Printf(out,",\"args\":{#;:#;}",PrintJson(e.arg_name),e.arg);
+            }
+           break;
+
+           case 'b' : case 'e' :
+            {
+             Printf(out,",\"id\":\"#.16i;\"",e.id);
+            }
+           break;
+          }
+
+        Putobj(out,"}");
+       }
+
+     Putobj(out,"\n],\"displayTimeUnit\":\"ms\"}\n");
+
+     out.preserveFile();
+
+     Printf(Con,"vmake : trace #; events -> #.q;\n",events.getLen(),file_name);
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save trace #.q;\n",file_name);
+    }
+
+  events.erase();
+  pool.erase();
+ }
+
+} // namespace VMake
+} // namespace App
+
@@ -0,0 +1,134 @@
+/* VMakeUsage.cpp */
+//----------------------------------------------------------------------------------------
+//
+//  Project: vmake 1.00
+//
+//  License: Boost Software License - Version 1.0 - August 17th, 2003
+//
+//            see http://www.boost.org/LICENSE_1_0.txt or the local copy
+//
+//  Copyright (c) 2019 Sergey Strukov. All rights reserved.
+//
+//----------------------------------------------------------------------------------------
+
+#include <inc/VMakeUsage.h>
+
+#include <CCore/inc/Print.h>
+#include <CCore/inc/print/PrintFile.h>
+#include <CCore/inc/Sort.h>
+#include <CCore/inc/Exception.h>
+
+namespace App {
+namespace VMake {
+
+/* struct PrintCSV */
+
+struct PrintCSV
+ {
+  StrLen str;
+
+  explicit PrintCSV(StrLen str_) : str(str_) {}
+
+  void print(PrinterType auto &out) const
+   {
+    out.put('"');
+
+    for(char ch : str )
+      {
+       if( ch=='"' ) out.put('"');
+
+       out.put(ch);
+      }
+
+    out.put('"');
+   }
+ };
+
+/* class UsageLog */
+
+UsageLog::UsageLog()
+ {
+  list.reserve(1000);
+ }
+
+UsageLog::~UsageLog()
+ {
+ }
+
+void UsageLog::add(StrLen name,StrLen wdir,const RuleUsage &usage)
+ {
+  if( !usage.procs ) return;
+
+  list.append_copy({pool.dup(name),pool.dup(wdir),usage});
+ }
+
+void UsageLog::report()
+ {
+  if( list.isEmpty() ) return;
+
+  DynArray<const Rec *> temp(DoReserve,list.getLen());
+
+  RuleUsage total;
+
+  for(const Rec &rec : list )
+    {
+     temp.append_copy(&rec);
+
+     total.wall+=rec.usage.wall;
+     total.user_time+=rec.usage.user_time;
+     total.sys_time+=rec.usage.sys_time;
+     total.max_rss=Max(total.max_rss,rec.usage.max_rss);
+     total.read_bytes+=rec.usage.read_bytes;
+     total.write_bytes+=rec.usage.write_bytes;
+     total.procs+=rec.usage.procs;
+    }
+
+  IncrSort(Range(temp), [] (const Rec *a,const Rec *b) { return a->usage.getCPU()>b->usage.getCPU(); } );
+
+  auto line = [] (StrLen name,const RuleUsage &usage)
+                  {
+                   Printf(Con,"#10; #10; #10; #10; #8; #10; #10; #;\n",usage.getCPU()/1000,usage.user_time/1000,usage.sys_time/1000,usage.wall/1000,
+                                                                     usage.max_rss/1024,usage.read_bytes>>10,usage.write_bytes>>10,name);
+                  } ;
+
+  Printf(Con,"\nvmake : resource usage of #; rules , top by CPU time\n\n",list.getLen());
+
+  Printf(Con,"#10; #10; #10; #10; #8; #10; #10; #;\n","cpu ms"_c,"user ms"_c,"sys ms"_c,"wall ms"_c,"rss MB"_c,"read KB"_c,"write KB"_c,"rule"_c);
+
+  for(const Rec *rec : Range(temp.getPtr(),Min(temp.getLen(),TopCount)) ) line(rec->name,rec->usage);
+
+  line("total"_c,total);
+
+  Putobj(Con,"\n");
+ }
+
+void UsageLog::save(StrLen file_name)
+ {
+  try
+    {
+     PrintFile out(file_name,Open_ToWrite|Open_AutoDelete);
+
+     Putobj(out,"rule,wdir,procs,wall_us,user_us,sys_us,max_rss_kb,read_bytes,write_bytes\n");
+
+     for(const Rec &rec : list )
+       {
+        const RuleUsage &usage=rec.usage;
+
+        Printf(out,"#;,#;,#;,#;,#;,#;,#;,#;,#;\n",PrintCSV(rec.name),PrintCSV(rec.wdir),usage.procs,usage.wall,usage.user_time,usage.sys_time,
+                                                  usage.max_rss,usage.read_bytes,usage.write_bytes);
+       }
+
+     out.preserveFile();
+    }
+  catch(CatchType)
+    {
+     Printf(Con,"vmake : cannot save resource usage #.q;\n",file_name);
+    }
+
+  list.erase();
+  pool.erase();
+ }
+
+} // namespace VMake
+} // namespace App
+
@@ -12,6 +12,7 @@
 //----------------------------------------------------------------------------------------
 
 #include <inc/VMakeProc.h>
+#include <inc/VMakeServer.h>
 
 #include <CCore/inc/Print.h>
 #include <CCore/inc/Exception.h>
@@ -28,9 +29,13 @@ class Main : NoCopy
  {
    SecTimer timer;
 
-   unsigned pcap = 0 ;
+   VMake::Options opt;
    StrLen file_name = "default.vm.ddl"_c ;
    StrLen target = "main"_c ;
+   bool has_target = false ;
+
+   StrLen server; // resident server socket
+   StrLen connect; // client : the server socket
 
    bool ok = false ;
 
@@ -40,9 +45,23 @@ class Main : NoCopy
 
    static int Usage()
     {
-     Putobj(Con,"Usage: vmake [-pNNN]\n");
-     Putobj(Con,"OR     vmake [-pNNN] <target>\n");
-     Putobj(Con,"OR     vmake [-pNNN] <target> <vmake-file>\n\n");
+     Putobj(Con,"Usage: vmake [options]\n");
+     Putobj(Con,"OR     vmake [options] <target>\n");
+     Putobj(Con,"OR     vmake [options] <target> <vmake-file>\n\n");
+     Putobj(Con,"  -pNNN             : run up to NNN processes in parallel\n");
+     Putobj(Con,"  -trust            : trust the saved build state for unchanged directories\n");
+     Putobj(Con,"  -hash             : rebuild only if the content of sources is changed\n");
+     Putobj(Con,"  -cache=<dir>      : restore rule outputs from the artifact cache <dir>\n");
+     Putobj(Con,"  -cache-size=NNN   : limit the artifact cache size to NNN MByte\n");
+     Putobj(Con,"  -merge            : merge nested vmake files into one build graph\n");
+     Putobj(Con,"  -image            : load the vmake file from the precompiled graph image, if it is up to date\n");
+     Putobj(Con,"  -trace=<file>     : write the build timeline in the Chrome trace format\n");
+     Putobj(Con,"  -usage=<file>     : report the resource usage of rules, write all rules to <file> in CSV\n");
+     Putobj(Con,"  -max-load=NNN     : delay new processes while the load average is above NNN\n");
+     Putobj(Con,"  -min-mem=NNN      : delay new processes while the available memory is below NNN MByte\n");
+     Putobj(Con,"  -no-capture       : parallel processes write to the console directly, the output is not collected per command\n");
+     Putobj(Con,"  -server=<socket>  : run as a resident server, listen on <socket>\n");
+     Putobj(Con,"  -connect=<socket> : send the build request to the server <socket>\n\n");
 
      return 1;
     }
@@ -53,11 +72,113 @@ class Main : NoCopy
     {
      ScanString inp(arg);
 
-     Scanf(inp,"-p#;#;",pcap,EndOfScan);
+     Scanf(inp,"-p#;#;",opt.pcap,EndOfScan);
 
      return inp.isOk();
     }
 
+   bool getOpt(StrLen arg)
+    {
+     if( arg.equal("-trust"_c) )
+       {
+        opt.trust=true;
+
+        return true;
+       }
+
+     if( arg.equal("-hash"_c) )
+       {
+        opt.hash=true;
+
+        return true;
+       }
+
+     if( arg.equal("-merge"_c) )
+       {
+        opt.merge=true;
+
+        return true;
+       }
+
+     if( arg.equal("-image"_c) )
+       {
+        opt.image=true;
+
+        return true;
+       }
+
+     if( arg.hasPrefix("-cache="_c) )
+       {
+        opt.cache_dir=arg.part(7);
+
+        return +opt.cache_dir;
+       }
+
+     if( arg.hasPrefix("-cache-size="_c) )
+       {
+        ScanString inp(arg.part(12));
+
+        Scanf(inp,"#;#;",opt.cache_size,EndOfScan);
+
+        return inp.isOk() && opt.cache_size>0 ;
+       }
+
+     if( arg.hasPrefix("-trace="_c) )
+       {
+        opt.trace=arg.part(7);
+
+        return +opt.trace;
+       }
+
+     if( arg.hasPrefix("-usage="_c) )
+       {
+        opt.usage=arg.part(7);
+
+        return +opt.usage;
+       }
+
+     if( arg.hasPrefix("-max-load="_c) )
+       {
+        ScanString inp(arg.part(10));
+
+        Scanf(inp,"#;#;",opt.max_load,EndOfScan);
+
+        return inp.isOk() && opt.max_load>0 ;
+       }
+
+     if( arg.hasPrefix("-min-mem="_c) )
+       {
+        ScanString inp(arg.part(9));
+
+        Scanf(inp,"#;#;",opt.min_mem,EndOfScan);
+
+        return inp.isOk() && opt.min_mem>0 ;
+       }
+
+     if( arg.equal("-no-capture"_c) )
+       {
+        opt.capture=false;
+
+        return true;
+       }
+
+     if( arg.hasPrefix("-server="_c) )
+       {
+        server=arg.part(8);
+
+        return +server;
+       }
+
+     if( arg.hasPrefix("-connect="_c) )
+       {
+        connect=arg.part(9);
+
+        return +connect;
+       }
+
+     return getP(arg);
+    }
+
   public:
 
    Main(int argc,const char **argv)
@@ -66,16 +187,15 @@ class Main : NoCopy
 
      auto list=Range(argv+1,argc-1);
 
-     if( +list && IsOpt(*list) )
+     for(; +list && IsOpt(*list) ;++list)
        {
-        if( !getP(*list) ) return;
-
-        ++list;
+        if( !getOpt(*list) ) return;
        }
 
      if( +list )
        {
         target=*list;
+        has_target=true;
 
         ++list;
        }
@@ -89,6 +209,15 @@ class Main : NoCopy
 
      if( +list ) return;
 
+     if( +connect )
+       {
+        ok=!server;
+
+        return;
+       }
+
+     if( +server && opt.merge ) return;
+
      if( !file_proc.checkExist(""_c,file_name) )
        {
         Printf(Con,"#.q; does not exist\n\n",file_name);
@@ -103,17 +232,32 @@ class Main : NoCopy
     {
      if( !ok ) return Usage();
 
-     if( pcap )
-       Printf(Con,"#; @ #; -p #;\n\n",file_name,target,pcap);
+     if( +connect ) return VMake::RunClient(connect,has_target?target:StrLen());
+
+     if( opt.pcap )
+       Printf(Con,"#; @ #; -p #;\n\n",file_name,target,opt.pcap);
      else
        Printf(Con,"#; @ #;\n\n",file_name,target);
 
-     file_proc.prepare(pcap);
+     file_proc.prepare(opt);
+
+     if( +server )
+       {
+        VMake::Server obj(file_proc,file_name,target);
+
+        obj.run(server);
+
+        return 0;
+       }
 
      VMake::DataProc proc(file_proc,file_name,target);
 
      int ret=proc.make();
 
+     file_proc.saveTrace();
+
+     file_proc.saveUsage();
+
      Printf(Con,"time = #;\n\n",PrintTime(timer.get()));
 
      return ret;
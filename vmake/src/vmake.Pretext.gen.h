@@ -70,18 +70,56 @@
 "  text[] paths;\n"
 " };   \n"
 " \n"
+"struct Copy\n"
+" {\n"
+"  text[] files;\n"
+"  text dst; \n"
+" };\n"
+" \n"
+"struct Touch\n"
+" {\n"
+"  text[] files;\n"
+" };\n"
+" \n"
+"struct Link\n"
+" {\n"
+"  text[] files;\n"
+"  text dst; \n"
+"  uint sym = 0 ; \n"
+" };\n"
+" \n"
+"struct Stamp\n"
+" {\n"
+"  text file; \n"
+" };\n"
+" \n"
 "struct IntCmd\n"
 " {\n"
 "  text echo;\n"
-"  {Echo,Cat,Rm,Mkdir} *cmd; \n"
+"  {Echo,Cat,Rm,Mkdir,Copy,Touch,Link,Stamp} *cmd; \n"
 "  text wdir;\n"
 " }; \n"
 " \n"
+"struct Includes\n"
+" {\n"
+"  text[] path; \n"
+" };\n"
+"\n"
+"struct Pool\n"
+" {\n"
+"  text name;\n"
+"  uint capacity; \n"
+" };\n"
+"\n"
 "struct Rule\n"
 " {\n"
 "  Target * [] src; \n"
 "  Target * [] dst;\n"
 "  {Exe,Cmd,VMake,IntCmd} * [] cmd;\n"
+"  text depfile = null ; \n"
+"  Includes *inc = null ; \n"
+"  Pool *pool = null ; \n"
+"  uint weight = 1 ; \n"
 " };\n"
 " \n"
 "struct Dep\n"
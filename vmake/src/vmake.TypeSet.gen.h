@@ -2,7 +2,7 @@
 
 struct TypeSet : TypeDefCore
  {
-  ulen indexes[14];
+  ulen indexes[20];
   DynArray<ulen> ind_map;
 
   DDL::FindNodeMap map;
@@ -26,6 +26,12 @@ struct TypeSet : TypeDefCore
     map.add(13,"Exe");
     map.add(11,"Env");
     map.add(14,"Target");
+    map.add(15,"Includes");
+    map.add(16,"Pool");
+    map.add(17,"Copy");
+    map.add(18,"Touch");
+    map.add(19,"Link");
+    map.add(20,"Stamp");
 
     map.complete();
    }
@@ -88,7 +94,11 @@ struct TypeSet : TypeDefCore
          DDL::SetFieldOffsets(struct_node,
                                "src",offsetof(S4,src),
                                "dst",offsetof(S4,dst),
-                               "cmd",offsetof(S4,cmd)
+                               "cmd",offsetof(S4,cmd),
+                               "depfile",offsetof(S4,depfile),
+                               "inc",offsetof(S4,inc),
+                               "pool",offsetof(S4,pool),
+                               "weight",offsetof(S4,weight)
                               );
         }
        return ret;
@@ -239,6 +249,88 @@ struct TypeSet : TypeDefCore
         }
        return ret;
 
+       case 15 :
+        {
+         indexes[14]=struct_node->index;
+         ind_map[struct_node->index]=15;
+
+         ret.set<S15>();
+
+         DDL::SetFieldOffsets(struct_node,
+                               "path",offsetof(S15,path)
+                              );
+        }
+       return ret;
+
+       case 16 :
+        {
+         indexes[15]=struct_node->index;
+         ind_map[struct_node->index]=16;
+
+         ret.set<S16>();
+
+         DDL::SetFieldOffsets(struct_node,
+                               "name",offsetof(S16,name),
+                               "capacity",offsetof(S16,capacity)
+                              );
+        }
+       return ret;
+
+       case 17 :
+        {
+         indexes[16]=struct_node->index;
+         ind_map[struct_node->index]=17;
+
+         ret.set<S17>();
+
+         DDL::SetFieldOffsets(struct_node,
+                               "files",offsetof(S17,files),
+                               "dst",offsetof(S17,dst)
+                              );
+        }
+       return ret;
+
+       case 18 :
+        {
+         indexes[17]=struct_node->index;
+         ind_map[struct_node->index]=18;
+
+         ret.set<S18>();
+
+         DDL::SetFieldOffsets(struct_node,
+                               "files",offsetof(S18,files)
+                              );
+        }
+       return ret;
+
+       case 19 :
+        {
+         indexes[18]=struct_node->index;
+         ind_map[struct_node->index]=19;
+
+         ret.set<S19>();
+
+         DDL::SetFieldOffsets(struct_node,
+                               "files",offsetof(S19,files),
+                               "dst",offsetof(S19,dst),
+                               "sym",offsetof(S19,sym)
+                              );
+        }
+       return ret;
+
+       case 20 :
+        {
+         indexes[19]=struct_node->index;
+         ind_map[struct_node->index]=20;
+
+         ret.set<S20>();
+
+         DDL::SetFieldOffsets(struct_node,
+                               "file",offsetof(S20,file)
+                              );
+        }
+       return ret;
+
        default: Printf(Exception,"Unknown structure"); return ret;
       }
    }
@@ -284,7 +376,11 @@ struct TypeSet : TypeDefCore
          DDL::GuardFieldTypes<
                                DDL::MapRange< DDL::MapPtr< S14 > >,
                                DDL::MapRange< DDL::MapPtr< S14 > >,
-                               DDL::MapRange< DDL::MapPolyPtr< S13 , S12 , S10 , S5 > >
+                               DDL::MapRange< DDL::MapPolyPtr< S13 , S12 , S10 , S5 > >,
+                               DDL::MapText,
+                               DDL::MapPtr< S15 >,
+                               DDL::MapPtr< S16 >,
+                               DDL::uint_type
                               >(*this,struct_node);
         }
        break;
@@ -293,7 +389,7 @@ struct TypeSet : TypeDefCore
         {
          DDL::GuardFieldTypes<
                                DDL::MapText,
-                               DDL::MapPolyPtr< S9 , S8 , S7 , S6 >,
+                               DDL::MapPolyPtr< S9 , S8 , S7 , S6 , S17 , S18 , S19 , S20 >,
                                DDL::MapText
                               >(*this,struct_node);
         }
@@ -385,6 +481,58 @@ struct TypeSet : TypeDefCore
         }
        break;
 
+       case 15 :
+        {
+         DDL::GuardFieldTypes<
+                               DDL::MapRange< DDL::MapText >
+                              >(*this,struct_node);
+        }
+       break;
+
+       case 16 :
+        {
+         DDL::GuardFieldTypes<
+                               DDL::MapText,
+                               DDL::uint_type
+                              >(*this,struct_node);
+        }
+       break;
+
+       case 17 :
+        {
+         DDL::GuardFieldTypes<
+                               DDL::MapRange< DDL::MapText >,
+                               DDL::MapText
+                              >(*this,struct_node);
+        }
+       break;
+
+       case 18 :
+        {
+         DDL::GuardFieldTypes<
+                               DDL::MapRange< DDL::MapText >
+                              >(*this,struct_node);
+        }
+       break;
+
+       case 19 :
+        {
+         DDL::GuardFieldTypes<
+                               DDL::MapRange< DDL::MapText >,
+                               DDL::MapText,
+                               DDL::uint_type
+                              >(*this,struct_node);
+        }
+       break;
+
+       case 20 :
+        {
+         DDL::GuardFieldTypes<
+                               DDL::MapText
+                              >(*this,struct_node);
+        }
+       break;
+
        default: Printf(Exception,"Unknown structure");
       }
    }
@@ -508,3 +656,39 @@ struct TypeSet::IsStruct<TypeDefCore::S14>
   static bool Do(const ulen *indexes,ulen index) { return index==indexes[13]; }
  };
 
+template <>
+struct TypeSet::IsStruct<TypeDefCore::S15>
+ {
+  static bool Do(const ulen *indexes,ulen index) { return index==indexes[14]; }
+ };
+
+template <>
+struct TypeSet::IsStruct<TypeDefCore::S16>
+ {
+  static bool Do(const ulen *indexes,ulen index) { return index==indexes[15]; }
+ };
+
+template <>
+struct TypeSet::IsStruct<TypeDefCore::S17>
+ {
+  static bool Do(const ulen *indexes,ulen index) { return index==indexes[16]; }
+ };
+
+template <>
+struct TypeSet::IsStruct<TypeDefCore::S18>
+ {
+  static bool Do(const ulen *indexes,ulen index) { return index==indexes[17]; }
+ };
+
+template <>
+struct TypeSet::IsStruct<TypeDefCore::S19>
+ {
+  static bool Do(const ulen *indexes,ulen index) { return index==indexes[18]; }
+ };
+
+template <>
+struct TypeSet::IsStruct<TypeDefCore::S20>
+ {
+  static bool Do(const ulen *indexes,ulen index) { return index==indexes[19]; }
+ };
+